@@ -27,6 +27,17 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Multi-chunk format: a header, ChunkCount + 1 UINT32 chunk offsets relative to
+// the start of the header, then the chunks. Each chunk is a complete LZMA
+// stream of ChunkSize bytes of input (the last one holds the rest), so the
+// chunks can be decoded independently and in parallel.
+// This matches LZMA_MULTI_CHUNK_HEADER in MdeModulePkg/Include/Guid/LzmaDecompress.h.
+//
+#define MULTI_CHUNK_SIGNATURE     0x434D5A4C  // "LZMC"
+#define MULTI_CHUNK_HEADER_SIZE   24
+#define DEFAULT_CHUNK_SIZE        (1 << 20)
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -44,10 +55,11 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mChunkSize = 0;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
-#define UTILITY_MINOR_VERSION 2
+#define UTILITY_MINOR_VERSION 3
 #define INTEL_COPYRIGHT \
   "Copyright (c) 2009-2018, Intel Corporation. All rights reserved."
 void PrintHelp(char *buffer)
@@ -60,6 +72,10 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --multi-chunk: use the multi-chunk format, whose chunks can be\n"
+             "                 decoded in parallel\n"
+             "  --chunk-size Size: set the input size of each chunk of the\n"
+             "                     multi-chunk format, default: 1MB\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -238,6 +254,182 @@ Done:
   return res;
 }
 
+static void WriteUInt32(Byte *p, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    p[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 ReadUInt32(const Byte *p)
+{
+  return (UInt32)p[0] | ((UInt32)p[1] << 8) | ((UInt32)p[2] << 16) | ((UInt32)p[3] << 24);
+}
+
+static SRes EncodeMultiChunk(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  size_t chunkSize = (size_t)mChunkSize;
+  size_t chunkCount;
+  size_t offset;
+  size_t index;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_UNSUPPORTED;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  // every chunk gets 105% of its size + 64KB, as a single stream does
+  chunkCount = (inSize + chunkSize - 1) / chunkSize;
+  offset = MULTI_CHUNK_HEADER_SIZE + (chunkCount + 1) * 4;
+  outSize = offset + chunkCount * (LZMA_HEADER_SIZE + chunkSize / 20 * 21 + (1 << 16));
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  for (index = 0; index < chunkCount; index++) {
+    size_t chunkInSize = inSize - index * chunkSize;
+    size_t outSizeProcessed = outSize - offset - LZMA_HEADER_SIZE;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int i;
+
+    if (chunkInSize > chunkSize)
+      chunkInSize = chunkSize;
+
+    WriteUInt32(outBuffer + MULTI_CHUNK_HEADER_SIZE + index * 4, (UInt32)offset);
+    for (i = 0; i < 8; i++)
+      outBuffer[offset + LZMA_PROPS_SIZE + i] = (Byte)((UInt64)chunkInSize >> (8 * i));
+
+    res = LzmaEncode(outBuffer + offset + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + index * chunkSize, chunkInSize,
+        props, outBuffer + offset, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+
+    if (res != SZ_OK)
+      goto Done;
+
+    offset += LZMA_HEADER_SIZE + outSizeProcessed;
+    if (offset > 0xFFFFFFFF) {
+      res = SZ_ERROR_UNSUPPORTED;
+      goto Done;
+    }
+  }
+
+  WriteUInt32(outBuffer + MULTI_CHUNK_HEADER_SIZE + chunkCount * 4, (UInt32)offset);
+  WriteUInt32(outBuffer, MULTI_CHUNK_SIGNATURE);
+  WriteUInt32(outBuffer + 4, (UInt32)chunkCount);
+  WriteUInt32(outBuffer + 8, (UInt32)chunkSize);
+  WriteUInt32(outBuffer + 12, 0);
+  WriteUInt32(outBuffer + 16, (UInt32)inSize);
+  WriteUInt32(outBuffer + 20, 0);
+
+  if (outStream->Write(outStream, outBuffer, offset) != offset)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeMultiChunk(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t chunkCount;
+  size_t chunkSize;
+  size_t index;
+
+  if (inSize < MULTI_CHUNK_HEADER_SIZE + 4)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = ReadUInt32(inBuffer + 4);
+  chunkSize = ReadUInt32(inBuffer + 8);
+  outSize = ReadUInt32(inBuffer + 16);
+  if (ReadUInt32(inBuffer) != MULTI_CHUNK_SIGNATURE || ReadUInt32(inBuffer + 20) != 0 ||
+      chunkSize == 0 || outSize == 0 || chunkCount != (outSize + chunkSize - 1) / chunkSize ||
+      chunkCount > (inSize - MULTI_CHUNK_HEADER_SIZE) / 4 - 1) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  for (index = 0; index < chunkCount; index++) {
+    size_t start = ReadUInt32(inBuffer + MULTI_CHUNK_HEADER_SIZE + index * 4);
+    size_t end = ReadUInt32(inBuffer + MULTI_CHUNK_HEADER_SIZE + (index + 1) * 4);
+    size_t expectedSize = outSize - index * chunkSize;
+    size_t chunkOutSize;
+    size_t inSizePure;
+    ELzmaStatus status;
+    int i;
+
+    if (expectedSize > chunkSize)
+      expectedSize = chunkSize;
+
+    if (end > inSize || start > end || end - start < LZMA_HEADER_SIZE) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    chunkOutSize = 0;
+    for (i = 0; i < 8; i++)
+      chunkOutSize += ((size_t)inBuffer[start + LZMA_PROPS_SIZE + i]) << (i * 8);
+    if (chunkOutSize != expectedSize) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    inSizePure = end - start - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + index * chunkSize, &chunkOutSize, inBuffer + start + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + start, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+
+    if (res != SZ_OK)
+      goto Done;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 int main2(int numArgs, const char *args[], char *rs)
 {
   CFileSeqInStream inStream;
@@ -272,6 +464,19 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--multi-chunk") == 0) {
+      if (mChunkSize == 0) {
+        mChunkSize = DEFAULT_CHUNK_SIZE;
+      }
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      if (AsciiStringToUint64(args[param + 1], FALSE, &mChunkSize) != EFI_SUCCESS ||
+          mChunkSize == 0 || mChunkSize > 0xFFFFFFFF) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      param++;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +547,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if ((mChunkSize != 0) && (mConType != NoConverter)) {
+    return PrintError(rs, "The multi-chunk format does not support a converter");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +573,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mChunkSize != 0) {
+      res = EncodeMultiChunk(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mChunkSize != 0) {
+      res = DecodeMultiChunk(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
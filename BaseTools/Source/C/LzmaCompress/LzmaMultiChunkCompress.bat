@@ -0,0 +1,26 @@
+@REM @file
+@REM This script will exec LzmaCompress tool with --multi-chunk option that
+@REM splits the input into chunks which can be decompressed in parallel.
+@REM
+@REM Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+@REM SPDX-License-Identifier: BSD-2-Clause-Patent
+@REM
+
+@echo off
+@setlocal
+
+:Begin
+if "%1"=="" goto End
+if "%1"=="-e" (
+  set FLAG=--multi-chunk
+)
+if "%1"=="-d" (
+  set FLAG=--multi-chunk
+)
+set ARGS=%ARGS% %1
+shift
+goto Begin
+
+:End
+LzmaCompress %ARGS% %FLAG%
+@echo on
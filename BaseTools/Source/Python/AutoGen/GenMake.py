@@ -1610,6 +1610,8 @@ class TopLevelMakefile(BuildFile):
             ExtraOption += " -c"
         if not GlobalData.gEnableGenfdsMultiThread:
             ExtraOption += " --no-genfds-multi-thread"
+        if GlobalData.gGenfdsThreadNumber > 1:
+            ExtraOption += " -n %d" % GlobalData.gGenfdsThreadNumber
         if GlobalData.gIgnoreSource:
             ExtraOption += " --ignore-sources"
 
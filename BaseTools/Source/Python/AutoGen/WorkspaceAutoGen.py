@@ -899,6 +899,7 @@ class WorkspaceAutoGen(AutoGen):
             FdsCommandDict["quiet"] = True
 
         FdsCommandDict["GenfdsMultiThread"] = GlobalData.gEnableGenfdsMultiThread
+        FdsCommandDict["ThreadNumber"] = GlobalData.gGenfdsThreadNumber
         if GlobalData.gIgnoreSource:
             FdsCommandDict["IgnoreSources"] = True
 
@@ -12,6 +12,7 @@
 from __future__ import absolute_import
 import Common.LongFilePathOs as os
 import subprocess
+import time
 from io import BytesIO
 from struct import *
 from . import FfsFileStatement
@@ -58,6 +59,8 @@ class FV (object):
         self.FvExtEntryTypeValue = []
         self.FvExtEntryType = []
         self.FvExtEntryData = []
+        self.PrebuiltArgs = None
+        self.PrebuiltAlignment = None
     ## AddToBuffer()
     #
     #   Generate Fv and add it to the Buffer
@@ -74,6 +77,19 @@ class FV (object):
     def AddToBuffer (self, Buffer, BaseAddress=None, BlockSize= None, BlockNum=None, ErasePloarity='1',  MacroDict = None, Flag=False):
         if BaseAddress is None and self.UiFvName.upper() + 'fv' in GenFdsGlobalVariable.ImageBinDict:
             return GenFdsGlobalVariable.ImageBinDict[self.UiFvName.upper() + 'fv']
+        #
+        # Reuse the image generated ahead of time with the same parameters.
+        # It is only reused once, any later request for the FV takes the
+        # generated image from ImageBinDict as for any other FV.
+        #
+        if not Flag and not MacroDict and self.PrebuiltArgs == (BaseAddress, BlockSize, BlockNum, ErasePloarity):
+            FvOutputFile = GenFdsGlobalVariable.ImageBinDict[self.UiFvName.upper() + 'fv']
+            with open(FvOutputFile, 'rb') as FvFileObj:
+                Buffer.write(FvFileObj.read())
+            self.FvAlignment = self.PrebuiltAlignment
+            self.PrebuiltArgs = None
+            self.PrebuiltAlignment = None
+            return FvOutputFile
         if MacroDict is None:
             MacroDict = {}
 
@@ -94,8 +110,9 @@ class FV (object):
                                 GenFdsGlobalVariable.ErrorLogger("Capsule %s in FD region can't contain a FV %s in FD region." % (self.CapsuleName, self.UiFvName.upper()))
         if not Flag:
             GenFdsGlobalVariable.InfLogger( "\nGenerating %s FV" %self.UiFvName)
-        GenFdsGlobalVariable.LargeFileInFvFlags.append(False)
+        GenFdsGlobalVariable.GetLargeFileInFvFlags().append(False)
         FFSGuid = None
+        StartTime = time.time()
 
         if self.FvBaseAddress is not None:
             BaseAddress = self.FvBaseAddress
@@ -152,7 +169,7 @@ class FV (object):
             OrigFvInfo = None
             if os.path.exists (FvInfoFileName):
                 OrigFvInfo = open(FvInfoFileName, 'r').read()
-            if GenFdsGlobalVariable.LargeFileInFvFlags[-1]:
+            if GenFdsGlobalVariable.GetLargeFileInFvFlags()[-1]:
                 FFSGuid = GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID
             GenFdsGlobalVariable.GenerateFirmwareVolume(
                                     FvOutputFile,
@@ -184,7 +201,7 @@ class FV (object):
                     for FfsFile in self.FfsList:
                         FileName = FfsFile.GenFfs(MacroDict, FvChildAddr, BaseAddress, IsMakefile=Flag, FvName=self.UiFvName)
 
-                    if GenFdsGlobalVariable.LargeFileInFvFlags[-1]:
+                    if GenFdsGlobalVariable.GetLargeFileInFvFlags()[-1]:
                         FFSGuid = GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID;
                     #Update GenFv again
                     GenFdsGlobalVariable.GenerateFirmwareVolume(
@@ -226,7 +243,9 @@ class FV (object):
                         self.FvAlignment = str (FvAlignmentValue)
                     FvFileObj.close()
                     GenFdsGlobalVariable.ImageBinDict[self.UiFvName.upper() + 'fv'] = FvOutputFile
-                    GenFdsGlobalVariable.LargeFileInFvFlags.pop()
+                    GenFdsGlobalVariable.GetLargeFileInFvFlags().pop()
+                    GenFdsGlobalVariable.FvTimeDict[self.UiFvName.upper()] = \
+                        GenFdsGlobalVariable.FvTimeDict.get(self.UiFvName.upper(), 0) + time.time() - StartTime
                 else:
                     GenFdsGlobalVariable.ErrorLogger("Invalid FV file %s." % self.UiFvName)
             else:
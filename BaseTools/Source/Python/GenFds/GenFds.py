@@ -18,6 +18,7 @@ from glob import glob
 from struct import unpack
 from linecache import getlines
 from io import BytesIO
+import threading
 
 import Common.LongFilePathOs as os
 from Common.TargetTxtClassObject import TargetTxtDict
@@ -94,8 +95,9 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.ThreadNumber = 1
 
-    GenFdsGlobalVariable.LargeFileInFvFlags = []
+    GenFdsGlobalVariable.ThreadData = threading.local()
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     GenFdsGlobalVariable.LARGE_FILE_SIZE = 0x1000000
 
@@ -104,6 +106,9 @@ def resetFdsGlobalVariable():
     # FvName, FdName, CapName in FDF, Image file name
     GenFdsGlobalVariable.ImageBinDict = {}
 
+    # FvName in FDF, seconds spent to generate the FV image
+    GenFdsGlobalVariable.FvTimeDict = {}
+
 def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
     global Workspace
     Workspace = ""
@@ -142,6 +147,8 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = True
             else:
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = False
+            if FdsCommandDict.get("ThreadNumber"):
+                GenFdsGlobalVariable.ThreadNumber = FdsCommandDict.get("ThreadNumber")
         os.chdir(GenFdsGlobalVariable.WorkSpaceDir)
 
         # set multiple workspace
@@ -376,6 +383,9 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
         """Display FV space info."""
         GenFds.DisplayFvSpaceInfo(FdfParserObj)
 
+        """Display FV generation time."""
+        GenFds.DisplayFvTimeInfo(FdfParserObj)
+
     except Warning as X:
         EdkLogger.error(X.ToolName, FORMAT_INVALID, File=X.FileName, Line=X.LineNumber, ExtraData=X.Message, RaiseError=False)
         ReturnCode = FORMAT_INVALID
@@ -407,6 +417,7 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["debug"] = Options.debug
     FdsCommandDict["Workspace"] = Options.Workspace
     FdsCommandDict["GenfdsMultiThread"] = not Options.NoGenfdsMultiThread
+    FdsCommandDict["ThreadNumber"] = Options.ThreadNumber
     FdsCommandDict["fdf_file"] = [PathClass(Options.filename)] if Options.filename else []
     FdsCommandDict["build_target"] = Options.BuildTarget
     FdsCommandDict["toolchain_tag"] = Options.ToolChain
@@ -465,6 +476,7 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("-n", action="store", type="int", dest="ThreadNumber", default=1, help="Build the FV images that do not depend on each other with the specified number of threads. FVs that contain or are contained in another FV are still built serially. Only takes effect with GenFds multi thread.")
 
     Options, _ = Parser.parse_args()
     return Options
@@ -493,6 +505,10 @@ class GenFds(object):
     def GenFd (OutputDir, FdfParserObject, WorkSpace, ArchList):
         GenFdsGlobalVariable.SetDir ('', FdfParserObject, WorkSpace, ArchList)
 
+        if GenFdsGlobalVariable.ThreadNumber > 1 and GenFdsGlobalVariable.EnableGenfdsMultiThread and \
+           GenFds.OnlyGenerateThisCap is None and GenFds.OnlyGenerateThisFd is None and GenFds.OnlyGenerateThisFv is None:
+            GenFds.PreGenerateFv(GenFdsGlobalVariable.ThreadNumber)
+
         GenFdsGlobalVariable.VerboseLogger(" Generate all Fd images and their required FV and Capsule images!")
         if GenFds.OnlyGenerateThisCap is not None and GenFds.OnlyGenerateThisCap.upper() in GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict:
             CapsuleObj = GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict[GenFds.OnlyGenerateThisCap.upper()]
@@ -534,6 +550,121 @@ class GenFds(object):
                 for OptRomObj in GenFdsGlobalVariable.FdfParser.Profile.OptRomDict.values():
                     OptRomObj.AddToBuffer(None)
 
+    ## GetFvReferences()
+    #
+    #   Collect the names of the FVs nested in an FFS file statement or section
+    #
+    #   @param  Obj             The FFS file statement or section
+    #   @param  References      The set the upper case FV names are added to
+    #
+    @staticmethod
+    def GetFvReferences(Obj, References):
+        FvName = getattr(Obj, 'FvName', None)
+        if FvName:
+            References.add(FvName.upper())
+        for Section in getattr(Obj, 'SectionList', None) or []:
+            GenFds.GetFvReferences(Section, References)
+
+    ## PreGenerateFv()
+    #
+    #   Generate the FV images that do not depend on each other with a pool of
+    #   worker threads. No dependency graph is built, so only flat FVs are
+    #   covered: an FV takes part only if it neither contains nor is contained
+    #   in another FV, is not in a capsule, is placed alone in at most one FD
+    #   region, and shares no FFS file with other FVs. Nested FVs are always
+    #   generated serially. The images are generated with the same parameters
+    #   the FD regions use later. The FD regions still check the alignment of
+    #   the FVs and take the images from FV.AddToBuffer(), so the output stays
+    #   the same as the fully serial one.
+    #
+    #   @param  ThreadNumber    The number of worker threads
+    #
+    @staticmethod
+    def PreGenerateFv(ThreadNumber):
+        Profile = GenFdsGlobalVariable.FdfParser.Profile
+        Excluded = set()
+
+        FvPlacement = {}
+        for FdObj in Profile.FdDict.values():
+            for RegionObj in FdObj.RegionList:
+                if RegionObj.RegionType != BINARY_FILE_TYPE_FV:
+                    continue
+                for RegionData in RegionObj.RegionDataList:
+                    FvName = RegionData.upper()
+                    if FvName in FvPlacement or len(RegionObj.RegionDataList) != 1:
+                        Excluded.add(FvName)
+                    FvPlacement[FvName] = (FdObj, RegionObj)
+
+        FfsUsers = {}
+        for FvObj in Profile.FvDict.values():
+            FvName = FvObj.UiFvName.upper()
+            if FvObj.CapsuleName is not None:
+                Excluded.add(FvName)
+            References = set()
+            for FfsFile in FvObj.FfsList:
+                if isinstance(FfsFile, FileStatement):
+                    GenFds.GetFvReferences(FfsFile, References)
+                    Key = str(FfsFile.NameGuid).upper()
+                else:
+                    Key = os.path.normpath(FfsFile.InfFileName).upper()
+                FfsUsers.setdefault(Key, set()).add(FvName)
+            if References:
+                Excluded.add(FvName)
+                Excluded.update(References)
+        for Users in FfsUsers.values():
+            if len(Users) > 1:
+                Excluded.update(Users)
+
+        JobList = []
+        for FvObj in Profile.FvDict.values():
+            FvName = FvObj.UiFvName.upper()
+            if FvName in Excluded:
+                GenFdsGlobalVariable.VerboseLogger(" FV %s is generated serially" % FvObj.UiFvName)
+                continue
+            if FvName in FvPlacement:
+                FdObj, RegionObj = FvPlacement[FvName]
+                RegionObj.BlockInfoOfRegion(FdObj.BlockSizeList, FvObj)
+                Args = ('0x%X' % (int(FdObj.BaseAddress, 16) + RegionObj.Offset), None, None, FdObj.ErasePolarity)
+            else:
+                Args = (None, None, None, '1')
+            JobList.append((FvObj, Args))
+        if len(JobList) < 2:
+            return
+
+        GenFdsGlobalVariable.VerboseLogger("\n Generate %d independent FV images with %d threads!" % (len(JobList), ThreadNumber))
+        Lock = threading.Lock()
+        ErrorList = []
+
+        def Worker():
+            while True:
+                with Lock:
+                    if not JobList or ErrorList:
+                        return
+                    FvObj, Args = JobList.pop(0)
+                try:
+                    #
+                    # The FD region checks the FV alignment given in the FDF
+                    # file before it adds the FV, so keep it until then.
+                    #
+                    FdfAlignment = FvObj.FvAlignment
+                    Buffer = BytesIO()
+                    FvObj.AddToBuffer(Buffer, *Args)
+                    Buffer.close()
+                    FvObj.PrebuiltAlignment = FvObj.FvAlignment
+                    FvObj.FvAlignment = FdfAlignment
+                    FvObj.PrebuiltArgs = Args
+                except BaseException as X:
+                    with Lock:
+                        ErrorList.append(X)
+
+        ThreadList = [threading.Thread(target=Worker) for _ in range(min(ThreadNumber, len(JobList)))]
+        for Thread in ThreadList:
+            Thread.start()
+        for Thread in ThreadList:
+            Thread.join()
+        if ErrorList:
+            raise ErrorList[0]
+
     @staticmethod
     def GenFfsMakefile(OutputDir, FdfParserObject, WorkSpace, ArchList, GlobalData):
         GenFdsGlobalVariable.SetEnv(FdfParserObject, WorkSpace, ArchList, GlobalData)
@@ -638,6 +769,24 @@ class GenFds(object):
                                            + str(UsedSizeValue) + ' (' + hex(UsedSizeValue) + ')' + ' used, '\
                                            + str(FreeSizeValue) + ' (' + hex(FreeSizeValue) + ')' + ' free')
 
+    ## DisplayFvTimeInfo()
+    #
+    #   Report the time spent to generate each FV image. The time of an FV
+    #   includes the FVs nested in it.
+    #
+    #   @param  FdfParserObject FDF contents parser
+    #   @retval None
+    #
+    @staticmethod
+    def DisplayFvTimeInfo(FdfParserObject):
+        if not GenFdsGlobalVariable.FvTimeDict:
+            return
+
+        GenFdsGlobalVariable.InfLogger('\nFV Generation Time')
+        for FvName in FdfParserObject.Profile.FvDict:
+            if FvName.upper() in GenFdsGlobalVariable.FvTimeDict:
+                GenFdsGlobalVariable.InfLogger('%s %.3f seconds' % (FvName, GenFdsGlobalVariable.FvTimeDict[FvName.upper()]))
+
     ## PreprocessImage()
     #
     #   @param  BuildDb         Database from build meta data files
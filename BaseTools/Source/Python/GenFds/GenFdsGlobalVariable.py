@@ -14,6 +14,7 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import threading
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
@@ -73,6 +74,7 @@ class GenFdsGlobalVariable:
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = True
+    ThreadNumber = 1
 
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -81,9 +83,10 @@ class GenFdsGlobalVariable:
     # if it is greater than 0xFFFFFF, the tail flag in list is set to true,
     # and EFI_FIRMWARE_FILE_SYSTEM3_GUID is passed to C GenFv.
     # At the end of generation of FV, pop the flag.
-    # List is used as a stack to handle nested FV generation.
+    # List is used as a stack to handle nested FV generation. Each thread has
+    # its own stack, as independent FVs may be generated concurrently.
     #
-    LargeFileInFvFlags = []
+    ThreadData = threading.local()
     EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     LARGE_FILE_SIZE = 0x1000000
 
@@ -92,6 +95,19 @@ class GenFdsGlobalVariable:
     # FvName, FdName, CapName in FDF, Image file name
     ImageBinDict = {}
 
+    # FvName in FDF, seconds spent to generate the FV image
+    FvTimeDict = {}
+
+    ## GetLargeFileInFvFlags()
+    #
+    #   @retval list        The large file flag stack of the calling thread
+    #
+    @staticmethod
+    def GetLargeFileInFvFlags():
+        if not hasattr(GenFdsGlobalVariable.ThreadData, 'LargeFileInFvFlags'):
+            GenFdsGlobalVariable.ThreadData.LargeFileInFvFlags = []
+        return GenFdsGlobalVariable.ThreadData.LargeFileInFvFlags
+
     ## LoadBuildRule
     #
     @staticmethod
@@ -518,8 +534,8 @@ class GenFdsGlobalVariable:
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
                 GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
-                    GenFdsGlobalVariable.LargeFileInFvFlags):
-                    GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
+                    GenFdsGlobalVariable.GetLargeFileInFvFlags()):
+                    GenFdsGlobalVariable.GetLargeFileInFvFlags()[-1] = True
 
     @staticmethod
     def GetAlignment (AlignString):
@@ -59,6 +59,21 @@ class Region(object):
             for i in range(0, Size):
                 Buffer.write(PadByte)
 
+    ## IsPrebuiltFv()
+    #
+    #   Check whether the FV image was generated ahead of time for this region.
+    #   Such an FV still goes through the FV generation below, so its alignment
+    #   is checked and FV.AddToBuffer() puts the prebuilt image into the region.
+    #
+    #   @param  RegionData  The FV name in the region
+    #   @retval True        The FV image was generated ahead of time
+    #   @retval False       The FV image was not generated ahead of time
+    #
+    @staticmethod
+    def IsPrebuiltFv(RegionData):
+        FvObj = GenFdsGlobalVariable.FdfParser.Profile.FvDict.get(RegionData.upper())
+        return FvObj is not None and FvObj.PrebuiltArgs is not None
+
     ## AddToBuffer()
     #
     #   Add region data to the Buffer
@@ -103,7 +118,7 @@ class Region(object):
                         EdkLogger.error("GenFds", FILE_NOT_FOUND, ExtraData=RegionData)
 
                     FileName = RegionData
-                elif RegionData.upper() + 'fv' in ImageBinDict:
+                elif RegionData.upper() + 'fv' in ImageBinDict and not self.IsPrebuiltFv(RegionData):
                     if not Flag:
                         GenFdsGlobalVariable.InfLogger('   Region Name = FV')
                     FileName = ImageBinDict[RegionData.upper() + 'fv']
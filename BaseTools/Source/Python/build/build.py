@@ -1000,6 +1000,7 @@ class Build():
         self.ToolChainFamily = ToolChainFamily
 
         self.ThreadNumber   = ThreadNum()
+        GlobalData.gGenfdsThreadNumber = self.ThreadNumber
     ## Initialize build configuration
     #
     #   This method will parse DSC file and merge the configurations from
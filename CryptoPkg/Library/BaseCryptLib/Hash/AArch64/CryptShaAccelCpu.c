@@ -0,0 +1,115 @@
+/** @file
+  Accelerated SHA block functions for AArch64 processors.
+
+  SHA-256 uses the ARMv8 Cryptography Extension. SHA-512 always uses
+  OpenSSL.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "../CryptShaAccel.h"
+
+//
+// ID_AA64ISAR0_EL1.SHA2, non-zero if SHA256H, SHA256H2, SHA256SU0 and
+// SHA256SU1 are implemented.
+//
+#define ID_AA64ISAR0_SHA2_SHIFT  12
+#define ID_AA64ISAR0_SHA2_MASK   0xF
+
+/**
+  Reads the ID_AA64ISAR0 Register.
+
+  @return The contents of the ID_AA64ISAR0 register.
+
+**/
+UINT64
+EFIAPI
+Sha256CeReadIdIsar0 (
+  VOID
+  );
+
+/**
+  Runs the SHA-256 compression function using the ARMv8 Cryptography
+  Extension.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+Sha256CeBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Probes the processor for the instructions used by the accelerated block
+  functions.
+
+  @param[in]  Environment  Where the caller runs. No block function is
+                           reported in standalone MM, because the MM entry
+                           code does not save the SIMD registers of the
+                           interrupted context.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelProbe (
+  IN SHA_ACCEL_ENVIRONMENT  Environment
+  )
+{
+  if (Environment == ShaAccelMm) {
+    return 0;
+  }
+
+  if (((Sha256CeReadIdIsar0 () >> ID_AA64ISAR0_SHA2_SHIFT) & ID_AA64ISAR0_SHA2_MASK) == 0) {
+    return 0;
+  }
+
+  return SHA_ACCEL_SHA256;
+}
+
+/**
+  Runs the SHA-256 compression function over whole 64 byte blocks.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  Sha256CeBlocks (State, Data, BlockCount);
+}
+
+/**
+  Runs the SHA-512 compression function over whole 128 byte blocks.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
@@ -7,8 +7,65 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data with the accelerated SHA-256 block function.
+
+  A partially filled block left by an earlier update, and the tail of the
+  input, go through OpenSSL so that it keeps the buffered bytes. Whole blocks
+  in between are compressed straight from Data.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-256 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-256 data digest succeeded.
+  @retval FALSE  SHA-256 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+Sha256AccelUpdate (
+  IN OUT  SHA256_CTX   *Context,
+  IN      CONST UINT8  *Data,
+  IN      UINTN        DataSize
+  )
+{
+  UINTN     Length;
+  SHA_LONG  BitCountLow;
+
+  if (Context->num != 0) {
+    Length = MIN (DataSize, SHA256_CBLOCK - Context->num);
+    if (SHA256_Update (Context, Data, Length) == 0) {
+      return FALSE;
+    }
+    Data     += Length;
+    DataSize -= Length;
+  }
+
+  Length = DataSize - (DataSize % SHA256_CBLOCK);
+  if (Length != 0) {
+    InternalSha256AccelBlocks (Context->h, Data, Length / SHA256_CBLOCK);
+
+    //
+    // Count the message bits the same way SHA256_Update() does.
+    //
+    BitCountLow = Context->Nl + (((SHA_LONG) Length) << 3);
+    if (BitCountLow < Context->Nl) {
+      Context->Nh++;
+    }
+    Context->Nh += (SHA_LONG) (Length >> 29);
+    Context->Nl  = BitCountLow;
+
+    Data     += Length;
+    DataSize -= Length;
+  }
+
+  return (BOOLEAN) (SHA256_Update (Context, Data, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-256 hash operations.
 
@@ -130,6 +187,15 @@ Sha256Update (
     return FALSE;
   }
 
+  //
+  // Only look for an accelerated block function when there is a whole block
+  // to hash; in PEI that means executing CPUID.
+  //
+  if (DataSize >= SHA256_CBLOCK &&
+      (InternalShaAccelGetFeatures () & SHA_ACCEL_SHA256) != 0) {
+    return Sha256AccelUpdate ((SHA256_CTX *) Sha256Context, Data, DataSize);
+  }
+
   //
   // OpenSSL SHA-256 Hash Update
   //
@@ -202,6 +268,9 @@ Sha256HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA256_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -213,11 +282,13 @@ Sha256HashAll (
   }
 
   //
-  // OpenSSL SHA-256 Hash Computation.
+  // SHA-256 Hash Computation, through Sha256Update () so that the data
+  // benefits from the accelerated block function.
   //
-  if (SHA256 (Data, DataSize, HashValue) == NULL) {
-    return FALSE;
-  } else {
-    return TRUE;
-  }
+  Status = Sha256Init (&Context) &&
+           Sha256Update (&Context, Data, DataSize) &&
+           Sha256Final (&Context, HashValue);
+
+  ZeroMem (&Context, sizeof (Context));
+  return Status;
 }
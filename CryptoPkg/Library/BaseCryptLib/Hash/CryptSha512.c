@@ -7,8 +7,66 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data with the accelerated SHA-512 block function. Serves
+  both SHA-384 and SHA-512, which share the context and block function.
+
+  A partially filled block left by an earlier update, and the tail of the
+  input, go through OpenSSL so that it keeps the buffered bytes. Whole blocks
+  in between are compressed straight from Data.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-512 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-512 data digest succeeded.
+  @retval FALSE  SHA-512 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+Sha512AccelUpdate (
+  IN OUT  SHA512_CTX   *Context,
+  IN      CONST UINT8  *Data,
+  IN      UINTN        DataSize
+  )
+{
+  UINTN       Length;
+  SHA_LONG64  BitCountLow;
+
+  if (Context->num != 0) {
+    Length = MIN (DataSize, SHA512_CBLOCK - Context->num);
+    if (SHA512_Update (Context, Data, Length) == 0) {
+      return FALSE;
+    }
+    Data     += Length;
+    DataSize -= Length;
+  }
+
+  Length = DataSize - (DataSize % SHA512_CBLOCK);
+  if (Length != 0) {
+    InternalSha512AccelBlocks (Context->h, Data, Length / SHA512_CBLOCK);
+
+    //
+    // Count the message bits the same way SHA512_Update() does.
+    //
+    BitCountLow = Context->Nl + LShiftU64 (Length, 3);
+    if (BitCountLow < Context->Nl) {
+      Context->Nh++;
+    }
+    Context->Nh += RShiftU64 (Length, 61);
+    Context->Nl  = BitCountLow;
+
+    Data     += Length;
+    DataSize -= Length;
+  }
+
+  return (BOOLEAN) (SHA512_Update (Context, Data, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -132,6 +190,15 @@ Sha384Update (
     return FALSE;
   }
 
+  //
+  // Only look for an accelerated block function when there is a whole block
+  // to hash; in PEI that means executing CPUID.
+  //
+  if (DataSize >= SHA512_CBLOCK &&
+      (InternalShaAccelGetFeatures () & SHA_ACCEL_SHA512) != 0) {
+    return Sha512AccelUpdate ((SHA512_CTX *) Sha384Context, Data, DataSize);
+  }
+
   //
   // OpenSSL SHA-384 Hash Update
   //
@@ -204,6 +271,9 @@ Sha384HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA512_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -215,13 +285,15 @@ Sha384HashAll (
   }
 
   //
-  // OpenSSL SHA-384 Hash Computation.
+  // SHA-384 Hash Computation, through Sha384Update () so that the data
+  // benefits from the accelerated block function.
   //
-  if (SHA384 (Data, DataSize, HashValue) == NULL) {
-    return FALSE;
-  } else {
-    return TRUE;
-  }
+  Status = Sha384Init (&Context) &&
+           Sha384Update (&Context, Data, DataSize) &&
+           Sha384Final (&Context, HashValue);
+
+  ZeroMem (&Context, sizeof (Context));
+  return Status;
 }
 
 /**
@@ -347,6 +419,15 @@ Sha512Update (
     return FALSE;
   }
 
+  //
+  // Only look for an accelerated block function when there is a whole block
+  // to hash; in PEI that means executing CPUID.
+  //
+  if (DataSize >= SHA512_CBLOCK &&
+      (InternalShaAccelGetFeatures () & SHA_ACCEL_SHA512) != 0) {
+    return Sha512AccelUpdate ((SHA512_CTX *) Sha512Context, Data, DataSize);
+  }
+
   //
   // OpenSSL SHA-512 Hash Update
   //
@@ -419,6 +500,9 @@ Sha512HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA512_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -430,11 +514,13 @@ Sha512HashAll (
   }
 
   //
-  // OpenSSL SHA-512 Hash Computation.
+  // SHA-512 Hash Computation, through Sha512Update () so that the data
+  // benefits from the accelerated block function.
   //
-  if (SHA512 (Data, DataSize, HashValue) == NULL) {
-    return FALSE;
-  } else {
-    return TRUE;
-  }
+  Status = Sha512Init (&Context) &&
+           Sha512Update (&Context, Data, DataSize) &&
+           Sha512Final (&Context, HashValue);
+
+  ZeroMem (&Context, sizeof (Context));
+  return Status;
 }
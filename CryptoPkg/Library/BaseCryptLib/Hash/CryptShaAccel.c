@@ -0,0 +1,35 @@
+/** @file
+  Accelerated SHA block function selection for DXE and runtime library
+  instances.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
+
+STATIC BOOLEAN  mShaAccelProbed   = FALSE;
+STATIC UINT32   mShaAccelFeatures = 0;
+
+/**
+  Returns the accelerated block functions usable by this library instance.
+
+  The processor is probed on the first call only.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  if (!mShaAccelProbed) {
+    mShaAccelFeatures = InternalShaAccelProbe (ShaAccelFirmware);
+    mShaAccelProbed   = TRUE;
+  }
+
+  return mShaAccelFeatures;
+}
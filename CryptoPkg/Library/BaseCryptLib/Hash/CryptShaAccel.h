@@ -0,0 +1,117 @@
+/** @file
+  Internal definitions for the processor accelerated SHA-256 and SHA-512
+  block functions.
+
+  OpenSSL is built without its assembly code, so Sha256Update() and
+  Sha512Update() hand whole blocks to these functions instead of the portable
+  C compression function when the processor has suitable instructions.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CRYPT_SHA_ACCEL_H__
+#define __CRYPT_SHA_ACCEL_H__
+
+#include <Base.h>
+
+//
+// Block functions reported by InternalShaAccelGetFeatures ().
+//
+#define SHA_ACCEL_SHA256  BIT0
+#define SHA_ACCEL_SHA512  BIT1
+
+//
+// Where the library instance runs. This decides which registers the block
+// functions may use, because code that interrupts them only preserves the
+// register state its entry code saves.
+//
+typedef enum {
+  //
+  // PEI, DXE and runtime. The X64 exception and interrupt entry code of
+  // CpuExceptionHandlerLib only saves the FXSAVE state, so the upper halves
+  // of the YMM registers are not preserved.
+  //
+  ShaAccelFirmware,
+  //
+  // SMM and standalone MM. The SMI entry code only saves the FXSAVE state on
+  // X64, and the AArch64 MM entry code saves no SIMD registers.
+  //
+  ShaAccelMm,
+  //
+  // Host based applications. The host OS saves the whole extended state.
+  //
+  ShaAccelHost
+} SHA_ACCEL_ENVIRONMENT;
+
+/**
+  Probes the processor for the instructions used by the accelerated block
+  functions.
+
+  @param[in]  Environment  Where the caller runs. Block functions using
+                           register state that is not preserved there are
+                           not reported.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelProbe (
+  IN SHA_ACCEL_ENVIRONMENT  Environment
+  );
+
+/**
+  Returns the accelerated block functions usable by this library instance.
+
+  Library instances that may write global variables probe the processor once;
+  the PEI instance probes on every call.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  );
+
+/**
+  Runs the SHA-256 compression function over whole 64 byte blocks.
+
+  Must only be called if InternalShaAccelGetFeatures () reports
+  SHA_ACCEL_SHA256.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Runs the SHA-512 compression function over whole 128 byte blocks. The
+  same function serves SHA-384.
+
+  Must only be called if InternalShaAccelGetFeatures () reports
+  SHA_ACCEL_SHA512.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#endif
@@ -0,0 +1,28 @@
+/** @file
+  Accelerated SHA block function selection for host based library instances.
+
+  The processor is probed on every call, which lets host based tests switch
+  between the accelerated and the OpenSSL block functions through the CPUID
+  results they report.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
+
+/**
+  Returns the accelerated block functions usable by this library instance.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  return InternalShaAccelProbe (ShaAccelHost);
+}
@@ -0,0 +1,66 @@
+/** @file
+  Accelerated SHA block functions for processors without an accelerated
+  implementation. Sha256Update() and Sha512Update() always use OpenSSL.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
+
+/**
+  Probes the processor for the instructions used by the accelerated block
+  functions.
+
+  @param[in]  Environment  Where the caller runs.
+
+  @return  0, no accelerated block function is available.
+
+**/
+UINT32
+InternalShaAccelProbe (
+  IN SHA_ACCEL_ENVIRONMENT  Environment
+  )
+{
+  return 0;
+}
+
+/**
+  Runs the SHA-256 compression function over whole 64 byte blocks.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Runs the SHA-512 compression function over whole 128 byte blocks.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
@@ -0,0 +1,28 @@
+/** @file
+  Accelerated SHA block function selection for PEI library instances.
+
+  PEIMs may run from read-only flash, so the probe result cannot be kept in
+  a global variable. Sha256Update() and Sha512Update() only ask for it when
+  they have at least one whole block to hash.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
+
+/**
+  Returns the accelerated block functions usable by this library instance.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  return InternalShaAccelProbe (ShaAccelFirmware);
+}
@@ -0,0 +1,39 @@
+/** @file
+  Accelerated SHA block function selection for SMM and standalone MM library
+  instances.
+
+  An SMI may interrupt code using any register, and the SMI entry code does
+  not save the whole extended register state. Block functions needing more
+  than it saves are not used here.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
+
+STATIC BOOLEAN  mShaAccelProbed   = FALSE;
+STATIC UINT32   mShaAccelFeatures = 0;
+
+/**
+  Returns the accelerated block functions usable by this library instance.
+
+  The processor is probed on the first call only.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  if (!mShaAccelProbed) {
+    mShaAccelFeatures = InternalShaAccelProbe (ShaAccelMm);
+    mShaAccelProbed   = TRUE;
+  }
+
+  return mShaAccelFeatures;
+}
@@ -0,0 +1,49 @@
+/** @file
+  AVX2 SHA-512 block function for host based library instances on X64.
+
+  The message schedule is computed with AVX2 and the rounds with the BMI2
+  RORX instruction. InternalShaAccelProbe () only reports it to host based
+  applications, where the OS saves the whole extended state.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "../CryptShaAccel.h"
+
+/**
+  Runs the SHA-512 compression function using AVX2 and BMI2.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+Sha512Avx2Blocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Runs the SHA-512 compression function over whole 128 byte blocks.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  Sha512Avx2Blocks (State, Data, BlockCount);
+}
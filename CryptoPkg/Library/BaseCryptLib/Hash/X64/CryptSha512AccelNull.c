@@ -0,0 +1,35 @@
+/** @file
+  SHA-512 block function for firmware library instances on X64.
+
+  Firmware has no accelerated SHA-512. X64 has no SHA-512 instructions, and
+  the AVX2 block function cannot be used because the firmware interrupt and
+  SMI entry code only saves the FXSAVE state. InternalShaAccelProbe () never
+  reports SHA_ACCEL_SHA512 to firmware, so Sha384Update() and Sha512Update()
+  always use OpenSSL.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "../CryptShaAccel.h"
+
+/**
+  Runs the SHA-512 compression function over whole 128 byte blocks.
+
+  @param[in, out]  State       The eight 64-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 128 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
@@ -0,0 +1,115 @@
+/** @file
+  Accelerated SHA block functions for X64 processors.
+
+  SHA-256 uses the Intel SHA extensions. SHA-512 has no dedicated
+  instructions. Host based library instances link CryptSha512AccelAvx2.c,
+  which computes the message schedule with AVX2 and the rounds with the BMI2
+  RORX instruction. Firmware library instances link CryptSha512AccelNull.c
+  instead, because firmware interrupt and SMI handlers do not preserve the
+  upper halves of the YMM registers, so SHA-512 always uses OpenSSL there.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+#include "../CryptShaAccel.h"
+#include <Register/Intel/Cpuid.h>
+
+//
+// XCR0 bits that must be set before AVX instructions may be used.
+//
+#define XCR0_SSE_AVX_STATE  (BIT1 | BIT2)
+
+/**
+  Runs the SHA-256 compression function using the Intel SHA extensions.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+Sha256ShaNiBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Probes the processor for the instructions used by the accelerated block
+  functions.
+
+  @param[in]  Environment  Where the caller runs. The AVX2 SHA-512 path is
+                           only reported to host based applications. In
+                           firmware, CpuExceptionHandlerLib saves the
+                           interrupted context with FXSAVE and the SMI entry
+                           code does not save the YMM state either, so an
+                           interrupt handler using AVX would corrupt the
+                           live YMM registers of the block function.
+
+  @return  A combination of the SHA_ACCEL_xxx bits.
+
+**/
+UINT32
+InternalShaAccelProbe (
+  IN SHA_ACCEL_ENVIRONMENT  Environment
+  )
+{
+  UINT32                                       MaxLeaf;
+  CPUID_VERSION_INFO_ECX                       VersionEcx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  ExtendedEbx;
+  UINT32                                       Features;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx.Uint32, NULL);
+  AsmCpuidEx (
+    CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+    CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+    NULL,
+    &ExtendedEbx.Uint32,
+    NULL,
+    NULL
+    );
+
+  Features = 0;
+  if (ExtendedEbx.Bits.SHA != 0 && VersionEcx.Bits.SSSE3 != 0 && VersionEcx.Bits.SSE4_1 != 0) {
+    Features |= SHA_ACCEL_SHA256;
+  }
+
+  //
+  // AVX2 also needs the OS to have enabled the YMM state.
+  //
+  if ((Environment == ShaAccelHost) && ExtendedEbx.Bits.AVX2 != 0 && ExtendedEbx.Bits.BMI2 != 0 &&
+      VersionEcx.Bits.OSXSAVE != 0 &&
+      (AsmXGetBv (0) & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE) {
+    Features |= SHA_ACCEL_SHA512;
+  }
+
+  return Features;
+}
+
+/**
+  Runs the SHA-256 compression function over whole 64 byte blocks.
+
+  @param[in, out]  State       The eight 32-bit state words A - H.
+  @param[in]       Data        The message blocks.
+  @param[in]       BlockCount  The number of 64 byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  Sha256ShaNiBlocks (State, Data, BlockCount);
+}
@@ -0,0 +1,558 @@
+/** @file
+  Host based throughput benchmark of the BaseCryptLib hash functions.
+
+  Every hash function is timed over a range of message sizes twice: once with
+  CPUID reporting no features, so that only the OpenSSL C code is used, and
+  once with the CPUID results of the host processor, so that the accelerated
+  block functions are used where the processor supports them. Both runs must
+  produce the same digest. Files named on the command line, such as firmware
+  volume images, are then hashed the same way.
+
+  Finally a buffer larger than the processor caches is hashed for 1, 2 and 4
+  PCR banks, as a TPM 2.0 measurement does, once bank by bank and once fed to
+  all banks in cache sized chunks the way HashLibBaseCryptoRouter does, and
+  the throughput is reported in bytes per TSC cycle.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined (_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/UnitTestHostBaseLib.h>
+
+//
+// Each measurement hashes for at least BENCHMARK_MIN_CLOCKS of processor time.
+//
+#define BENCHMARK_MIN_CLOCKS  (CLOCKS_PER_SEC / 4)
+
+#define MAX_DIGEST_SIZE       SHA512_DIGEST_SIZE
+
+//
+// Buffer hashed by the PCR bank benchmark. It must be larger than the last
+// level cache for the bank by bank run to read it from memory once per bank.
+//
+#define BANK_MESSAGE_SIZE     SIZE_64MB
+
+//
+// Must match HASH_UPDATE_CHUNK_SIZE in HashLibBaseCryptoRouterCommon.h.
+//
+#define BANK_CHUNK_SIZE       SIZE_16KB
+
+#define MAX_BANK_COUNT        4
+
+typedef
+UINTN
+(EFIAPI *HASH_GET_CONTEXT_SIZE) (
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_INIT) (
+  OUT  VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_UPDATE) (
+  IN OUT  VOID        *HashContext,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_FINAL) (
+  IN OUT  VOID   *HashContext,
+  OUT     UINT8  *HashValue
+  );
+
+typedef struct {
+  CONST CHAR8            *Name;
+  UINTN                  DigestSize;
+  HASH_GET_CONTEXT_SIZE  GetContextSize;
+  HASH_INIT              Init;
+  HASH_UPDATE            Update;
+  HASH_FINAL             Final;
+} HASH_ALGORITHM;
+
+STATIC CONST HASH_ALGORITHM  mHashAlgorithms[] = {
+  { "SHA-1",   SHA1_DIGEST_SIZE,   Sha1GetContextSize,   Sha1Init,   Sha1Update,   Sha1Final   },
+  { "SHA-256", SHA256_DIGEST_SIZE, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final },
+  { "SHA-384", SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final },
+  { "SHA-512", SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final },
+};
+
+//
+// Message sizes timed for each algorithm: a single TPM event, a small
+// variable, a typical PE/COFF section and a firmware volume.
+//
+STATIC CONST UINTN  mMessageSizes[] = {
+  64, 1024, SIZE_16KB, SIZE_1MB
+};
+
+//
+// PCR bank combinations timed by the bank benchmark, as indexes into
+// mHashAlgorithms. The first BankCount entries are used.
+//
+STATIC CONST UINTN  mBankAlgorithms[MAX_BANK_COUNT] = { 1, 0, 2, 3 };
+
+STATIC CONST UINTN  mBankCounts[] = { 1, 2, MAX_BANK_COUNT };
+
+STATIC UNIT_TEST_HOST_BASE_LIB_ASM_CPUID     mNoFeaturesAsmCpuid;
+STATIC UNIT_TEST_HOST_BASE_LIB_ASM_CPUID_EX  mNoFeaturesAsmCpuidEx;
+
+/**
+  Executes CPUID on the host processor.
+
+  @param[in]   Index     The value of EAX for CPUID.
+  @param[in]   SubIndex  The value of ECX for CPUID.
+  @param[out]  Eax       The value of EAX after CPUID. Optional.
+  @param[out]  Ebx       The value of EBX after CPUID. Optional.
+  @param[out]  Ecx       The value of ECX after CPUID. Optional.
+  @param[out]  Edx       The value of EDX after CPUID. Optional.
+
+  @return Index.
+**/
+STATIC
+UINT32
+EFIAPI
+HostAsmCpuidEx (
+  IN  UINT32  Index,
+  IN  UINT32  SubIndex,
+  OUT UINT32  *Eax,  OPTIONAL
+  OUT UINT32  *Ebx,  OPTIONAL
+  OUT UINT32  *Ecx,  OPTIONAL
+  OUT UINT32  *Edx   OPTIONAL
+  )
+{
+  UINT32  Registers[4];
+
+#if defined (_MSC_VER)
+  __cpuidex ((int *)Registers, (int)Index, (int)SubIndex);
+#else
+  __cpuid_count (Index, SubIndex, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+
+  if (Eax != NULL) {
+    *Eax = Registers[0];
+  }
+  if (Ebx != NULL) {
+    *Ebx = Registers[1];
+  }
+  if (Ecx != NULL) {
+    *Ecx = Registers[2];
+  }
+  if (Edx != NULL) {
+    *Edx = Registers[3];
+  }
+  return Index;
+}
+
+/**
+  Executes CPUID on the host processor.
+
+  @param[in]   Index  The value of EAX for CPUID.
+  @param[out]  Eax    The value of EAX after CPUID. Optional.
+  @param[out]  Ebx    The value of EBX after CPUID. Optional.
+  @param[out]  Ecx    The value of ECX after CPUID. Optional.
+  @param[out]  Edx    The value of EDX after CPUID. Optional.
+
+  @return Index.
+**/
+STATIC
+UINT32
+EFIAPI
+HostAsmCpuid (
+  IN  UINT32  Index,
+  OUT UINT32  *Eax,  OPTIONAL
+  OUT UINT32  *Ebx,  OPTIONAL
+  OUT UINT32  *Ecx,  OPTIONAL
+  OUT UINT32  *Edx   OPTIONAL
+  )
+{
+  return HostAsmCpuidEx (Index, 0, Eax, Ebx, Ecx, Edx);
+}
+
+/**
+  Selects the CPUID results seen by BaseCryptLib.
+
+  @param[in]  HostFeatures  TRUE to report the features of the host
+                            processor, FALSE to report no features.
+**/
+STATIC
+VOID
+SelectCpuid (
+  IN BOOLEAN  HostFeatures
+  )
+{
+  if (HostFeatures) {
+    gUnitTestHostBaseLib.X86->AsmCpuid   = HostAsmCpuid;
+    gUnitTestHostBaseLib.X86->AsmCpuidEx = HostAsmCpuidEx;
+  } else {
+    gUnitTestHostBaseLib.X86->AsmCpuid   = mNoFeaturesAsmCpuid;
+    gUnitTestHostBaseLib.X86->AsmCpuidEx = mNoFeaturesAsmCpuidEx;
+  }
+}
+
+/**
+  Hashes a message repeatedly for at least BENCHMARK_MIN_CLOCKS.
+
+  @param[in]   Algorithm    The hash algorithm.
+  @param[in]   Context      A context buffer of the size the algorithm needs.
+  @param[in]   Message      The message.
+  @param[in]   MessageSize  The size of the message in bytes.
+  @param[out]  Digest       The digest of the message.
+
+  @return  The throughput in MB/s, or a negative value if hashing failed.
+**/
+STATIC
+double
+TimeHash (
+  IN  CONST HASH_ALGORITHM  *Algorithm,
+  IN  VOID                  *Context,
+  IN  CONST UINT8           *Message,
+  IN  UINTN                 MessageSize,
+  OUT UINT8                 *Digest
+  )
+{
+  UINTN    Iterations;
+  clock_t  Start;
+  clock_t  Elapsed;
+
+  Iterations = 0;
+  Start      = clock ();
+  do {
+    if (!Algorithm->Init (Context) ||
+        !Algorithm->Update (Context, Message, MessageSize) ||
+        !Algorithm->Final (Context, Digest)) {
+      return -1.0;
+    }
+    Iterations++;
+    Elapsed = clock () - Start;
+  } while (Elapsed < BENCHMARK_MIN_CLOCKS);
+
+  return (double)MessageSize * Iterations / ((double)Elapsed / CLOCKS_PER_SEC) / 1000000.0;
+}
+
+/**
+  Times every hash algorithm over a message, with and without the
+  accelerated block functions, and prints the results.
+
+  @param[in]  Name         Name printed for the message.
+  @param[in]  Message      The message.
+  @param[in]  MessageSize  The size of the message in bytes.
+
+  @retval  TRUE   Both runs produced the same digests.
+  @retval  FALSE  Hashing failed, or the digests differ.
+**/
+STATIC
+BOOLEAN
+BenchmarkMessage (
+  IN CONST CHAR8  *Name,
+  IN CONST UINT8  *Message,
+  IN UINTN        MessageSize
+  )
+{
+  UINTN   Index;
+  VOID    *Context;
+  UINT8   Digest[MAX_DIGEST_SIZE];
+  UINT8   AcceleratedDigest[MAX_DIGEST_SIZE];
+  double  Throughput;
+  double  AcceleratedThroughput;
+
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgorithms); Index++) {
+    Context = AllocatePool (mHashAlgorithms[Index].GetContextSize ());
+    if (Context == NULL) {
+      return FALSE;
+    }
+
+    SelectCpuid (FALSE);
+    Throughput = TimeHash (&mHashAlgorithms[Index], Context, Message, MessageSize, Digest);
+    SelectCpuid (TRUE);
+    AcceleratedThroughput = TimeHash (&mHashAlgorithms[Index], Context, Message, MessageSize, AcceleratedDigest);
+    FreePool (Context);
+
+    if (Throughput < 0 || AcceleratedThroughput < 0) {
+      printf ("%s: %s failed\n", Name, mHashAlgorithms[Index].Name);
+      return FALSE;
+    }
+
+    if (CompareMem (Digest, AcceleratedDigest, mHashAlgorithms[Index].DigestSize) != 0) {
+      printf ("%s: %s digests differ\n", Name, mHashAlgorithms[Index].Name);
+      return FALSE;
+    }
+
+    printf (
+      "%-20s %-8s %9.1f MB/s %9.1f MB/s %6.2fx\n",
+      Name,
+      mHashAlgorithms[Index].Name,
+      Throughput,
+      AcceleratedThroughput,
+      AcceleratedThroughput / Throughput
+      );
+  }
+
+  return TRUE;
+}
+
+/**
+  Benchmarks hashing the contents of a file.
+
+  @param[in]  FileName  The file to hash.
+
+  @retval  TRUE   The file was hashed.
+  @retval  FALSE  The file could not be read, or hashing failed.
+**/
+STATIC
+BOOLEAN
+BenchmarkFile (
+  IN CONST CHAR8  *FileName
+  )
+{
+  FILE     *File;
+  long     FileSize;
+  UINT8    *Buffer;
+  BOOLEAN  Result;
+
+  File = fopen (FileName, "rb");
+  if (File == NULL) {
+    printf ("%s: cannot be opened\n", FileName);
+    return FALSE;
+  }
+
+  Buffer = NULL;
+  Result = FALSE;
+  if (fseek (File, 0, SEEK_END) == 0 &&
+      (FileSize = ftell (File)) > 0 &&
+      fseek (File, 0, SEEK_SET) == 0) {
+    Buffer = AllocatePool ((UINTN)FileSize);
+    if (Buffer != NULL && fread (Buffer, 1, (size_t)FileSize, File) == (size_t)FileSize) {
+      Result = BenchmarkMessage (FileName, Buffer, (UINTN)FileSize);
+    } else {
+      printf ("%s: cannot be read\n", FileName);
+    }
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+  fclose (File);
+  return Result;
+}
+
+/**
+  Hashes a message for several PCR banks and measures the TSC cycles taken.
+
+  @param[in]   BankCount    The number of banks, at most MAX_BANK_COUNT.
+  @param[in]   Contexts     A context buffer for each bank.
+  @param[in]   Message      The message.
+  @param[in]   MessageSize  The size of the message in bytes.
+  @param[in]   ChunkSize    0 to hash the whole message bank by bank, or the
+                            size of the pieces given to every bank in turn.
+  @param[out]  Digests      The digest of the message for each bank.
+
+  @return  The throughput in bytes per cycle, or a negative value if hashing
+           failed.
+**/
+STATIC
+double
+TimeBanks (
+  IN  UINTN        BankCount,
+  IN  VOID         **Contexts,
+  IN  CONST UINT8  *Message,
+  IN  UINTN        MessageSize,
+  IN  UINTN        ChunkSize,
+  OUT UINT8        Digests[][MAX_DIGEST_SIZE]
+  )
+{
+  CONST HASH_ALGORITHM  *Algorithm;
+  UINTN                 Bank;
+  UINTN                 Offset;
+  UINTN                 Size;
+  UINT64                Start;
+  UINT64                Cycles;
+
+  if (ChunkSize == 0) {
+    ChunkSize = MessageSize;
+  }
+
+  Start = __rdtsc ();
+  for (Bank = 0; Bank < BankCount; Bank++) {
+    if (!mHashAlgorithms[mBankAlgorithms[Bank]].Init (Contexts[Bank])) {
+      return -1.0;
+    }
+  }
+
+  for (Offset = 0; Offset < MessageSize; Offset += Size) {
+    Size = MIN (MessageSize - Offset, ChunkSize);
+    for (Bank = 0; Bank < BankCount; Bank++) {
+      if (!mHashAlgorithms[mBankAlgorithms[Bank]].Update (Contexts[Bank], Message + Offset, Size)) {
+        return -1.0;
+      }
+    }
+  }
+
+  for (Bank = 0; Bank < BankCount; Bank++) {
+    Algorithm = &mHashAlgorithms[mBankAlgorithms[Bank]];
+    if (!Algorithm->Final (Contexts[Bank], Digests[Bank])) {
+      return -1.0;
+    }
+  }
+  Cycles = __rdtsc () - Start;
+
+  return (double)MessageSize / (double)Cycles;
+}
+
+/**
+  Times hashing a message larger than the processor caches for 1, 2 and 4
+  PCR banks, bank by bank and in cache sized chunks, and prints the results.
+
+  @retval  TRUE   Both runs produced the same digests.
+  @retval  FALSE  Hashing failed, or the digests differ.
+**/
+STATIC
+BOOLEAN
+BenchmarkBanks (
+  VOID
+  )
+{
+  UINT8    *Message;
+  VOID     *Contexts[MAX_BANK_COUNT];
+  UINT8    Digests[MAX_BANK_COUNT][MAX_DIGEST_SIZE];
+  UINT8    ChunkedDigests[MAX_BANK_COUNT][MAX_DIGEST_SIZE];
+  UINTN    Index;
+  UINTN    Bank;
+  UINTN    BankCount;
+  double   Throughput;
+  double   ChunkedThroughput;
+  BOOLEAN  Result;
+
+  Message = AllocatePool (BANK_MESSAGE_SIZE);
+  if (Message == NULL) {
+    return FALSE;
+  }
+  for (Index = 0; Index < BANK_MESSAGE_SIZE; Index++) {
+    Message[Index] = (UINT8)(Index * 0x9E3779B1 >> 24);
+  }
+
+  ZeroMem (Contexts, sizeof (Contexts));
+  Result = TRUE;
+  for (Bank = 0; Bank < MAX_BANK_COUNT && Result; Bank++) {
+    Contexts[Bank] = AllocatePool (mHashAlgorithms[mBankAlgorithms[Bank]].GetContextSize ());
+    Result = (BOOLEAN)(Contexts[Bank] != NULL);
+  }
+
+  SelectCpuid (TRUE);
+  printf ("\n%-20s %-8s %14s %14s %7s\n", "PCR banks", "", "Bank by bank", "Chunked", "Speedup");
+
+  for (Index = 0; Index < ARRAY_SIZE (mBankCounts) && Result; Index++) {
+    BankCount = mBankCounts[Index];
+
+    //
+    // Each variant runs twice and the faster run is kept. This also leaves
+    // the first bank by bank run to fault the message in.
+    //
+    Throughput        = TimeBanks (BankCount, Contexts, Message, BANK_MESSAGE_SIZE, 0, Digests);
+    ChunkedThroughput = TimeBanks (BankCount, Contexts, Message, BANK_MESSAGE_SIZE, BANK_CHUNK_SIZE, ChunkedDigests);
+    if (Throughput < 0 || ChunkedThroughput < 0) {
+      printf ("%u banks: hashing failed\n", (unsigned)BankCount);
+      Result = FALSE;
+      break;
+    }
+    Throughput        = MAX (Throughput, TimeBanks (BankCount, Contexts, Message, BANK_MESSAGE_SIZE, 0, Digests));
+    ChunkedThroughput = MAX (ChunkedThroughput, TimeBanks (BankCount, Contexts, Message, BANK_MESSAGE_SIZE, BANK_CHUNK_SIZE, ChunkedDigests));
+
+    for (Bank = 0; Bank < BankCount; Bank++) {
+      if (CompareMem (Digests[Bank], ChunkedDigests[Bank], mHashAlgorithms[mBankAlgorithms[Bank]].DigestSize) != 0) {
+        printf ("%u banks: %s digests differ\n", (unsigned)BankCount, mHashAlgorithms[mBankAlgorithms[Bank]].Name);
+        Result = FALSE;
+      }
+    }
+
+    printf (
+      "%-20u %-8s %8.3f B/cyc %8.3f B/cyc %6.2fx\n",
+      (unsigned)BankCount,
+      "",
+      Throughput,
+      ChunkedThroughput,
+      ChunkedThroughput / Throughput
+      );
+  }
+
+  for (Bank = 0; Bank < MAX_BANK_COUNT; Bank++) {
+    if (Contexts[Bank] != NULL) {
+      FreePool (Contexts[Bank]);
+    }
+  }
+  FreePool (Message);
+  return Result;
+}
+
+/**
+  Standard POSIX C entry point for the host based benchmark.
+
+  Any arguments are files to benchmark after the built-in message sizes.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  UINT8    *Message;
+  UINTN    Index;
+  CHAR8    Name[32];
+  BOOLEAN  Result;
+
+  mNoFeaturesAsmCpuid   = gUnitTestHostBaseLib.X86->AsmCpuid;
+  mNoFeaturesAsmCpuidEx = gUnitTestHostBaseLib.X86->AsmCpuidEx;
+
+  Message = AllocatePool (SIZE_1MB);
+  if (Message == NULL) {
+    return 1;
+  }
+
+  //
+  // The contents do not matter for the timing; use something other than zero.
+  //
+  for (Index = 0; Index < SIZE_1MB; Index++) {
+    Message[Index] = (UINT8)(Index * 0x9E3779B1 >> 24);
+  }
+
+  printf ("%-20s %-8s %14s %14s %7s\n", "Message", "Hash", "OpenSSL C", "Accelerated", "Speedup");
+
+  Result = TRUE;
+  for (Index = 0; Index < ARRAY_SIZE (mMessageSizes) && Result; Index++) {
+    snprintf (Name, sizeof (Name), "%u bytes", (unsigned)mMessageSizes[Index]);
+    Result = BenchmarkMessage (Name, Message, mMessageSizes[Index]);
+  }
+
+  FreePool (Message);
+
+  for (Index = 1; Index < (UINTN)argc && Result; Index++) {
+    Result = BenchmarkFile (argv[Index]);
+  }
+
+  if (Result) {
+    Result = BenchmarkBanks ();
+  }
+
+  return Result ? 0 : 1;
+}
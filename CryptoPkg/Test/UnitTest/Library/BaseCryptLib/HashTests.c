@@ -62,6 +62,44 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha512Digest[SHA512_DIGEST_SIZE] = {
   0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f
   };
 
+//
+// Number of 'a' characters in the long message, and the sizes the message is
+// cut into when hashed in pieces. The sizes straddle the 64 and 128 byte
+// block sizes so that updates start and end inside blocks.
+//
+#define LONG_MESSAGE_SIZE  1000000
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINTN LongMessageChunkSizes[] = {
+  1, 63, 64, 65, 127, 128, 129, 200, 4096, 10000
+  };
+
+//
+// Result for SHA-256 of one million 'a'. (From "B.3 SHA-256 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha256LongDigest[SHA256_DIGEST_SIZE] = {
+  0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+  0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+  };
+
+//
+// Result for SHA-384 of one million 'a'. (From "D.3 SHA-384 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha384LongDigest[SHA384_DIGEST_SIZE] = {
+  0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e, 0x31, 0x0a, 0x4a, 0x1c,
+  0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52, 0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b,
+  0x07, 0xb8, 0xb3, 0xdc, 0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+  };
+
+//
+// Result for SHA-512 of one million 'a'. (From "C.3 SHA-512 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha512LongDigest[SHA512_DIGEST_SIZE] = {
+  0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63,
+  0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb,
+  0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+  0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+  };
+
 typedef
 UINTN
 (EFIAPI *EFI_HASH_GET_CONTEXT_SIZE) (
@@ -116,6 +154,10 @@ HASH_TEST_CONTEXT       mSha256TestCtx = {SHA256_DIGEST_SIZE, Sha256GetContextSi
 HASH_TEST_CONTEXT       mSha384TestCtx = {SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll, Sha384Digest};
 HASH_TEST_CONTEXT       mSha512TestCtx = {SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll, Sha512Digest};
 
+HASH_TEST_CONTEXT       mSha256LongTestCtx = {SHA256_DIGEST_SIZE, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll, Sha256LongDigest};
+HASH_TEST_CONTEXT       mSha384LongTestCtx = {SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll, Sha384LongDigest};
+HASH_TEST_CONTEXT       mSha512LongTestCtx = {SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll, Sha512LongDigest};
+
 UNIT_TEST_STATUS
 EFIAPI
 TestVerifyHashPreReq (
@@ -186,6 +228,59 @@ TestVerifyHash (
   return UNIT_TEST_PASSED;
 }
 
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyHashLongMessage (
+  IN UNIT_TEST_CONTEXT           Context
+  )
+{
+  UINT8    *Message;
+  UINTN    Offset;
+  UINTN    ChunkSize;
+  UINTN    ChunkIndex;
+  UINT8    Digest[MAX_DIGEST_SIZE];
+  BOOLEAN  Status;
+  HASH_TEST_CONTEXT *HashTestContext;
+
+  HashTestContext = Context;
+
+  Message = AllocatePool (LONG_MESSAGE_SIZE);
+  UT_ASSERT_NOT_NULL (Message);
+  SetMem (Message, LONG_MESSAGE_SIZE, 'a');
+
+  //
+  // Whole blocks and partial blocks are hashed along different paths, so
+  // feed the message in pieces of varying size.
+  //
+  ZeroMem (Digest, MAX_DIGEST_SIZE);
+  Status  = HashTestContext->HashInit (HashTestContext->HashCtx);
+  UT_ASSERT_TRUE (Status);
+
+  ChunkIndex = 0;
+  for (Offset = 0; Offset < LONG_MESSAGE_SIZE; Offset += ChunkSize) {
+    ChunkSize = MIN (LongMessageChunkSizes[ChunkIndex], LONG_MESSAGE_SIZE - Offset);
+    ChunkIndex = (ChunkIndex + 1) % ARRAY_SIZE (LongMessageChunkSizes);
+
+    Status  = HashTestContext->HashUpdate (HashTestContext->HashCtx, Message + Offset, ChunkSize);
+    UT_ASSERT_TRUE (Status);
+  }
+
+  Status  = HashTestContext->HashFinal (HashTestContext->HashCtx, Digest);
+  UT_ASSERT_TRUE (Status);
+
+  UT_ASSERT_MEM_EQUAL (Digest, HashTestContext->Digest, HashTestContext->DigestSize);
+
+  ZeroMem (Digest, MAX_DIGEST_SIZE);
+  Status  = HashTestContext->HashAll (Message, LONG_MESSAGE_SIZE, Digest);
+  UT_ASSERT_TRUE (Status);
+
+  UT_ASSERT_MEM_EQUAL (Digest, HashTestContext->Digest, HashTestContext->DigestSize);
+
+  FreePool (Message);
+
+  return UNIT_TEST_PASSED;
+}
+
 TEST_DESC mHashTest[] = {
     //
     // -----Description----------------Class---------------------Function---------------Pre------------------Post------------Context
@@ -197,6 +292,9 @@ TEST_DESC mHashTest[] = {
     {"TestVerifySha256()", "CryptoPkg.BaseCryptLib.Hash",   TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha256TestCtx},
     {"TestVerifySha384()", "CryptoPkg.BaseCryptLib.Hash",   TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha384TestCtx},
     {"TestVerifySha512()", "CryptoPkg.BaseCryptLib.Hash",   TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha512TestCtx},
+    {"TestVerifySha256LongMessage()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashLongMessage, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha256LongTestCtx},
+    {"TestVerifySha384LongMessage()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashLongMessage, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha384LongTestCtx},
+    {"TestVerifySha512LongMessage()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHashLongMessage, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha512LongTestCtx},
 };
 
 UINTN mHashTestNum = ARRAY_SIZE(mHashTest);
@@ -18,6 +18,11 @@ EFI_LOCK FatFsLock   = EFI_INITIALIZE_LOCK_VARIABLE (TPL_CALLBACK);
 
 EFI_LOCK FatTaskLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 
+//
+// Disk cache statistics of all volumes
+//
+FAT_CACHE_STATISTICS  gFatCacheStatistics;
+
 //
 // Filesystem interface functions
 //
@@ -37,6 +37,7 @@ FatFreeODir (
     FatFreeDirEnt (DirEnt);
   }
 
+  FatFreeHashTable (ODir);
   FreePool (ODir);
 }
 
@@ -63,6 +64,7 @@ FatAllocateODir (
     ODir->Signature = FAT_ODIR_SIGNATURE;
     InitializeListHead (&ODir->ChildList);
     ODir->CurrentCursor = &ODir->ChildList;
+    FatInitializeHashTable (ODir);
   }
 
   return ODir;
@@ -1219,6 +1219,10 @@ FatCloseDirEnt (
     RemoveEntryList (&OFile->ChildLink);
   }
 
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
   FreePool (OFile);
   DirEnt->OFile = NULL;
   if (DirEnt->Invalid == TRUE) {
@@ -8,6 +8,44 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+//
+// Cache statistics as last published
+//
+STATIC FAT_CACHE_STATISTICS  mFatPublishedCacheStatistics;
+
+/**
+
+  Invalidate the cache page if it holds PageNo. If a read-ahead of the
+  page is still in flight, its data is dropped when it completes.
+
+  @param  CacheTag              - The cache tag of the page.
+  @param  PageNo                - The page which has been written behind the cache.
+
+**/
+STATIC
+VOID
+FatInvalidateCachePage (
+  IN CACHE_TAG          *CacheTag,
+  IN UINTN              PageNo
+  )
+{
+  EFI_TPL OldTpl;
+
+  //
+  // The read-ahead completion runs at TPL_NOTIFY
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (CacheTag->PageNo == PageNo) {
+    if (CacheTag->Pending) {
+      CacheTag->Stale = TRUE;
+    } else {
+      CacheTag->RealSize = 0;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
 
   This function is used by the Data Cache.
@@ -73,7 +111,7 @@ FatFlushDataCacheRange (
         //
         // Make all valid entries in this range invalid.
         //
-        CacheTag->RealSize = 0;
+        FatInvalidateCachePage (CacheTag, PageNo);
       }
     }
   }
@@ -152,6 +190,210 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Wait for the read-ahead of a cache page to complete. If it takes too long,
+  read-ahead is disabled for the volume and the reads still in flight are
+  cancelled. Once that happened, pages whose read could not be cancelled are
+  not waited for again, so a hung read-ahead costs a single timeout.
+
+  @param  Volume                - FAT file system volume.
+  @param  CacheTag              - The cache tag of the page.
+
+  @retval EFI_SUCCESS           - No read-ahead is in flight for the page.
+  @retval EFI_TIMEOUT           - The read-ahead is still in flight.
+
+**/
+STATIC
+EFI_STATUS
+FatWaitCachePage (
+  IN FAT_VOLUME         *Volume,
+  IN CACHE_TAG          *CacheTag
+  )
+{
+  DISK_CACHE  *DiskCache;
+  UINTN       Index;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  if (CacheTag->Pending && !DiskCache->ReadAheadDisabled) {
+    for (Index = 0; CacheTag->Pending && Index < FAT_READ_AHEAD_TIMEOUT * 10; Index++) {
+      gBS->Stall (100);
+    }
+
+    if (CacheTag->Pending) {
+      DEBUG ((EFI_D_ERROR, "FatWaitCachePage: read-ahead timed out, disabled\n"));
+      DiskCache->ReadAheadDisabled = TRUE;
+      Volume->DiskIo2->Cancel (Volume->DiskIo2);
+    }
+  }
+
+  if (CacheTag->Pending) {
+    return EFI_TIMEOUT;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Notification function of the read-ahead of a data cache page.
+
+  @param  Event                 - The event signaled.
+  @param  Context               - The cache tag of the page.
+
+**/
+STATIC
+VOID
+EFIAPI
+FatOnReadAheadComplete (
+  IN EFI_EVENT          Event,
+  IN VOID               *Context
+  )
+{
+  CACHE_TAG *CacheTag;
+
+  CacheTag = (CACHE_TAG *) Context;
+  if (EFI_ERROR (CacheTag->ReadAheadToken.TransactionStatus) || CacheTag->Stale) {
+    CacheTag->RealSize  = 0;
+    CacheTag->ReadAhead = FALSE;
+  }
+
+  CacheTag->Pending = FALSE;
+}
+
+/**
+
+  Start an asynchronous read of a data cache page through DiskIo2.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The page to read ahead.
+
+  @retval EFI_SUCCESS           - The read is started, or the page needs no read-ahead.
+  @retval EFI_END_OF_MEDIA      - The page is beyond the end of the volume.
+  @return Others                - The read can not be started.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadPage (
+  IN FAT_VOLUME         *Volume,
+  IN UINTN              PageNo
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINT64      EntryPos;
+  UINTN       RealSize;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  GroupNo   = PageNo & DiskCache->GroupMask;
+  CacheTag  = &DiskCache->CacheTag[GroupNo];
+  EntryPos  = DiskCache->BaseAddress + LShiftU64 (PageNo, DiskCache->PageAlignment);
+  if (EntryPos >= DiskCache->LimitAddress) {
+    return EFI_END_OF_MEDIA;
+  }
+
+  //
+  // Never replace a dirty page or one whose read is still in flight
+  //
+  if (CacheTag->Pending || CacheTag->Dirty || (CacheTag->RealSize > 0 && CacheTag->PageNo == PageNo)) {
+    return EFI_SUCCESS;
+  }
+
+  if (CacheTag->ReadAheadToken.Event == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    FatOnReadAheadComplete,
+                    CacheTag,
+                    &CacheTag->ReadAheadToken.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  RealSize            = (UINTN) MIN (LShiftU64 (1, DiskCache->PageAlignment), DiskCache->LimitAddress - EntryPos);
+  CacheTag->PageNo    = PageNo;
+  CacheTag->RealSize  = RealSize;
+  CacheTag->Stale     = FALSE;
+  CacheTag->ReadAhead = TRUE;
+  CacheTag->Pending   = TRUE;
+  Status = Volume->DiskIo2->ReadDiskEx (
+                              Volume->DiskIo2,
+                              Volume->MediaId,
+                              EntryPos,
+                              &CacheTag->ReadAheadToken,
+                              RealSize,
+                              DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment)
+                              );
+  if (EFI_ERROR (Status)) {
+    CacheTag->RealSize  = 0;
+    CacheTag->ReadAhead = FALSE;
+    CacheTag->Pending   = FALSE;
+    return Status;
+  }
+
+  gFatCacheStatistics.ReadAheadPages++;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Track the pages read through the data cache, and once the access looks
+  sequential keep a window of pages ahead of it read in the background.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The data cache page just read.
+
+**/
+STATIC
+VOID
+FatReadAhead (
+  IN FAT_VOLUME         *Volume,
+  IN UINTN              PageNo
+  )
+{
+  DISK_CACHE  *DiskCache;
+  UINTN       Window;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  if (Volume->DiskIo2 == NULL || DiskCache->ReadAheadDisabled || PageNo == DiskCache->LastPageNo) {
+    return;
+  }
+
+  if (PageNo == DiskCache->LastPageNo + 1) {
+    DiskCache->SequentialCount++;
+  } else {
+    DiskCache->SequentialCount = 0;
+    DiskCache->ReadAheadPageNo = PageNo + 1;
+  }
+
+  DiskCache->LastPageNo = PageNo;
+  if (DiskCache->SequentialCount < FAT_READ_AHEAD_THRESHOLD) {
+    return;
+  }
+
+  //
+  // Keep the window well below the number of groups so that the pages read
+  // ahead never evict the one being accessed
+  //
+  Window = MIN (FAT_READ_AHEAD_MAX_PAGES, (DiskCache->GroupMask + 1) / 4);
+  if (DiskCache->ReadAheadPageNo <= PageNo) {
+    DiskCache->ReadAheadPageNo = PageNo + 1;
+  }
+
+  while (DiskCache->ReadAheadPageNo <= PageNo + Window) {
+    if (EFI_ERROR (FatReadAheadPage (Volume, DiskCache->ReadAheadPageNo))) {
+      break;
+    }
+
+    DiskCache->ReadAheadPageNo++;
+  }
+}
+
 /**
 
   Get one cache page by specified PageNo.
@@ -162,6 +404,7 @@ FatExchangeCachePage (
   @param  CacheTag              - The Cache Tag for the current cache page.
 
   @retval EFI_SUCCESS           - Get the cache page successfully.
+  @retval EFI_NOT_READY         - The cache page is stuck behind a read-ahead.
   @return other                 - An error occurred when accessing data.
 
 **/
@@ -177,14 +420,36 @@ FatGetCachePage (
   EFI_STATUS  Status;
   UINTN       OldPageNo;
 
+  if (CacheTag->Pending && EFI_ERROR (FatWaitCachePage (Volume, CacheTag))) {
+    return EFI_NOT_READY;
+  }
+
   OldPageNo = CacheTag->PageNo;
   if (CacheTag->RealSize > 0 && OldPageNo == PageNo) {
     //
     // Cache Hit occurred
     //
+    if (CacheDataType == CacheFat) {
+      gFatCacheStatistics.FatHits++;
+    } else {
+      gFatCacheStatistics.DataHits++;
+      if (CacheTag->ReadAhead) {
+        gFatCacheStatistics.ReadAheadHits++;
+        CacheTag->ReadAhead = FALSE;
+      }
+    }
+
     return EFI_SUCCESS;
   }
 
+  if (CacheDataType == CacheFat) {
+    gFatCacheStatistics.FatMisses++;
+  } else {
+    gFatCacheStatistics.DataMisses++;
+  }
+
+  CacheTag->ReadAhead = FALSE;
+
   //
   // Write dirty cache page back to disk
   //
@@ -243,6 +508,24 @@ FatAccessUnalignedCachePage (
   GroupNo   = PageNo & DiskCache->GroupMask;
   CacheTag  = &DiskCache->CacheTag[GroupNo];
   Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  if (Status == EFI_NOT_READY) {
+    //
+    // Bypass the cache page while its read-ahead is outstanding
+    //
+    if (IoMode != ReadDisk) {
+      FatInvalidateCachePage (CacheTag, PageNo);
+    }
+
+    return FatDiskIo (
+             Volume,
+             IoMode,
+             DiskCache->BaseAddress + LShiftU64 (PageNo, DiskCache->PageAlignment) + Offset,
+             Length,
+             Buffer,
+             NULL
+             );
+  }
+
   if (!EFI_ERROR (Status)) {
     Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
     Destination = Buffer;
@@ -254,6 +537,9 @@ FatAccessUnalignedCachePage (
     }
 
     CopyMem (Destination, Source, Length);
+    if (CacheDataType == CacheData && IoMode == ReadDisk) {
+      FatReadAhead (Volume, PageNo);
+    }
   }
 
   return Status;
@@ -428,13 +714,126 @@ FatVolumeFlushCache (
   // Flush the block device.
   //
   Status = Volume->BlockIo->FlushBlocks (Volume->BlockIo);
+
   return Status;
 }
 
+/**
+
+  Publish the cache statistics of all volumes in the FAT_CACHE_STATISTICS_NAME
+  variable, if they changed since they were last published.
+
+**/
+STATIC
+VOID
+FatPublishCacheStatistics (
+  VOID
+  )
+{
+  if (CompareMem (&mFatPublishedCacheStatistics, &gFatCacheStatistics, sizeof (FAT_CACHE_STATISTICS)) == 0) {
+    return;
+  }
+
+  CopyMem (&mFatPublishedCacheStatistics, &gFatCacheStatistics, sizeof (FAT_CACHE_STATISTICS));
+  gRT->SetVariable (
+         FAT_CACHE_STATISTICS_NAME,
+         &gEfiCallerIdGuid,
+         EFI_VARIABLE_BOOTSERVICE_ACCESS,
+         sizeof (FAT_CACHE_STATISTICS),
+         &gFatCacheStatistics
+         );
+}
+
+/**
+
+  Timer notification function that publishes the cache statistics, if they
+  changed since they were last published.
+
+  It runs at TPL_CALLBACK, the TPL of FatFsLock, so it never sees the
+  counters while a file system request is updating them.
+
+  @param  Event                 - The periodic timer event.
+  @param  Context               - Not used.
+
+**/
+VOID
+EFIAPI
+FatOnCacheStatisticsTimer (
+  IN EFI_EVENT          Event,
+  IN VOID               *Context
+  )
+{
+  FatPublishCacheStatistics ();
+}
+
+/**
+
+  Get the amount of free memory in the system.
+
+  @return The total size of the conventional memory not allocated yet, 0 if
+          the memory map can not be read.
+
+**/
+STATIC
+UINT64
+FatGetFreeMemorySize (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  EFI_MEMORY_DESCRIPTOR *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR *Entry;
+  UINTN                 MapSize;
+  UINTN                 MapKey;
+  UINTN                 DescriptorSize;
+  UINT32                DescriptorVersion;
+  UINT64                FreePages;
+
+  MapSize   = 0;
+  MemoryMap = NULL;
+  Status    = gBS->GetMemoryMap (&MapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  while (Status == EFI_BUFFER_TOO_SMALL) {
+    //
+    // Leave room for the descriptors the allocation itself may add
+    //
+    MapSize  += 2 * DescriptorSize;
+    MemoryMap = AllocatePool (MapSize);
+    if (MemoryMap == NULL) {
+      return 0;
+    }
+
+    Status = gBS->GetMemoryMap (&MapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+    if (EFI_ERROR (Status)) {
+      FreePool (MemoryMap);
+      MemoryMap = NULL;
+    }
+  }
+
+  if (MemoryMap == NULL) {
+    return 0;
+  }
+
+  FreePages = 0;
+  for (Entry = MemoryMap;
+       (UINT8 *) Entry < (UINT8 *) MemoryMap + MapSize;
+       Entry = NEXT_MEMORY_DESCRIPTOR (Entry, DescriptorSize)) {
+    if (Entry->Type == EfiConventionalMemory) {
+      FreePages += Entry->NumberOfPages;
+    }
+  }
+
+  FreePool (MemoryMap);
+  return LShiftU64 (FreePages, EFI_PAGE_SHIFT);
+}
+
 /**
 
   Initialize the disk cache according to Volume's FatType.
 
+  The page size of the data cache follows the optimal transfer length of the
+  device, and both caches grow with the free memory: the FAT cache up to the
+  size of the whole FAT, the data cache up to FAT_DATACACHE_GROUP_MAX_COUNT pages.
+
   @param  Volume                - FAT file system volume.
 
   @retval EFI_SUCCESS           - The disk cache is successfully initialized.
@@ -446,44 +845,163 @@ FatInitializeDiskCache (
   IN FAT_VOLUME         *Volume
   )
 {
-  DISK_CACHE  *DiskCache;
-  UINTN       FatCacheGroupCount;
-  UINTN       DataCacheSize;
-  UINTN       FatCacheSize;
-  UINT8       *CacheBuffer;
+  DISK_CACHE          *DiskCache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINTN               FatCacheGroupCount;
+  UINTN               DataCacheGroupCount;
+  UINTN               DataCacheSize;
+  UINTN               FatCacheSize;
+  UINTN               Pages;
+  UINT64              MemoryBudget;
+  UINT64              OptimalSize;
+  UINT8               *CacheBuffer;
+  CACHE_TAG           *CacheTag;
 
   DiskCache = Volume->DiskCache;
+  Media     = Volume->BlockIo->Media;
   //
   // Configure the parameters of disk cache
   //
   if (Volume->FatType == Fat12) {
     FatCacheGroupCount                  = FAT_FATCACHE_GROUP_MIN_COUNT;
+    DataCacheGroupCount                 = FAT_DATACACHE_GROUP_MIN_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MIN_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MIN_ALIGNMENT;
   } else {
-    FatCacheGroupCount                  = FAT_FATCACHE_GROUP_MAX_COUNT;
+    FatCacheGroupCount                  = FAT_FATCACHE_GROUP_DEFAULT_COUNT;
+    DataCacheGroupCount                 = FAT_DATACACHE_GROUP_MIN_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MAX_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
+
+    //
+    // Make a data cache page at least one optimal transfer of the device,
+    // keeping the minimum data cache size unchanged
+    //
+    if (Volume->BlockIo->Revision >= EFI_BLOCK_IO_PROTOCOL_REVISION3 &&
+        Media->OptimalTransferLengthGranularity != 0) {
+      OptimalSize = MultU64x32 (Media->OptimalTransferLengthGranularity, Media->BlockSize);
+      while (DiskCache[CacheData].PageAlignment < FAT_DATACACHE_PAGE_LIMIT_ALIGNMENT &&
+             LShiftU64 (1, DiskCache[CacheData].PageAlignment) < OptimalSize) {
+        DiskCache[CacheData].PageAlignment++;
+        DataCacheGroupCount /= 2;
+      }
+    }
+
+    //
+    // Grow the caches within the memory budget: the FAT cache until it holds
+    // the whole FAT, the data cache up to its maximum
+    //
+    MemoryBudget = RShiftU64 (FatGetFreeMemorySize (), FAT_CACHE_MEMORY_SHIFT);
+    while (FatCacheGroupCount < FAT_FATCACHE_GROUP_MAX_COUNT &&
+           LShiftU64 (FatCacheGroupCount, DiskCache[CacheFat].PageAlignment) < Volume->FatSize &&
+           LShiftU64 (FatCacheGroupCount * 2, DiskCache[CacheFat].PageAlignment) <= MemoryBudget) {
+      FatCacheGroupCount *= 2;
+    }
+
+    while (DataCacheGroupCount < FAT_DATACACHE_GROUP_MAX_COUNT &&
+           LShiftU64 (DataCacheGroupCount * 2, DiskCache[CacheData].PageAlignment) <= MemoryBudget) {
+      DataCacheGroupCount *= 2;
+    }
   }
 
-  DiskCache[CacheData].GroupMask     = FAT_DATACACHE_GROUP_COUNT - 1;
+  DiskCache[CacheData].GroupMask     = DataCacheGroupCount - 1;
   DiskCache[CacheData].BaseAddress   = Volume->RootPos;
   DiskCache[CacheData].LimitAddress  = Volume->VolumeSize;
   DiskCache[CacheFat].GroupMask      = FatCacheGroupCount - 1;
   DiskCache[CacheFat].BaseAddress    = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress   = Volume->FatPos + Volume->FatSize;
   FatCacheSize                        = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                       = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  DataCacheSize                       = DataCacheGroupCount << DiskCache[CacheData].PageAlignment;
   //
-  // Allocate the Fat Cache buffer
+  // Allocate the cache tags, and the cache buffer aligned for the device
+  // so that DiskIo needs no bounce buffer
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
+  CacheTag = AllocateZeroPool ((FatCacheGroupCount + DataCacheGroupCount) * sizeof (CACHE_TAG));
+  if (CacheTag == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Pages       = EFI_SIZE_TO_PAGES (FatCacheSize + DataCacheSize);
+  CacheBuffer = AllocateAlignedPages (Pages, (Media->IoAlign > EFI_PAGE_SIZE) ? Media->IoAlign : 0);
   if (CacheBuffer == NULL) {
+    FreePool (CacheTag);
     return EFI_OUT_OF_RESOURCES;
   }
 
   Volume->CacheBuffer             = CacheBuffer;
+  Volume->CacheBufferPages        = Pages;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
+  DiskCache[CacheFat].CacheTag   = CacheTag;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  DiskCache[CacheData].CacheTag  = CacheTag + FatCacheGroupCount;
+
+  DEBUG ((
+    EFI_D_INFO,
+    "FatInitializeDiskCache: FAT cache %d x %dKB, data cache %d x %dKB\n",
+    FatCacheGroupCount,
+    ((UINTN) 1 << DiskCache[CacheFat].PageAlignment) / SIZE_1KB,
+    DataCacheGroupCount,
+    ((UINTN) 1 << DiskCache[CacheData].PageAlignment) / SIZE_1KB
+    ));
   return EFI_SUCCESS;
 }
+
+/**
+
+  Free the disk cache of the volume, after waiting for any read-ahead in flight,
+  and publish the cache statistics as the volume is unmounted.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME         *Volume
+  )
+{
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  BOOLEAN     Pending;
+
+  if (Volume->CacheBuffer == NULL) {
+    return;
+  }
+
+  //
+  // The read-ahead in flight targets the cache buffer and tags, so they
+  // can only be freed once it has completed or been cancelled
+  //
+  DiskCache = &Volume->DiskCache[CacheData];
+  Pending   = FALSE;
+  for (GroupNo = 0; GroupNo <= DiskCache->GroupMask; GroupNo++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo];
+    if (CacheTag->Pending && !Pending && EFI_ERROR (FatWaitCachePage (Volume, CacheTag))) {
+      Pending = TRUE;
+    }
+  }
+
+  if (Pending) {
+    Volume->DiskIo2->Cancel (Volume->DiskIo2);
+    for (GroupNo = 0; GroupNo <= DiskCache->GroupMask; GroupNo++) {
+      if (DiskCache->CacheTag[GroupNo].Pending) {
+        DEBUG ((EFI_D_ERROR, "FatFreeDiskCache: read-ahead can not be cancelled, cache leaked\n"));
+        FatPublishCacheStatistics ();
+        return;
+      }
+    }
+  }
+
+  FatPublishCacheStatistics ();
+
+  for (GroupNo = 0; GroupNo <= DiskCache->GroupMask; GroupNo++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo];
+    if (CacheTag->ReadAheadToken.Event != NULL) {
+      gBS->CloseEvent (CacheTag->ReadAheadToken.Event);
+    }
+  }
+
+  FreeAlignedPages (Volume->CacheBuffer, Volume->CacheBufferPages);
+  FreePool (Volume->DiskCache[CacheFat].CacheTag);
+  Volume->CacheBuffer = NULL;
+}
@@ -110,6 +110,11 @@ FatDriverBindingStop (
   IN  EFI_HANDLE                   *ChildHandleBuffer
   );
 
+//
+// Periodic timer that publishes the cache statistics
+//
+STATIC EFI_EVENT  mFatCacheStatisticsEvent = NULL;
+
 //
 // DriverBinding protocol instance
 //
@@ -155,6 +160,24 @@ FatEntryPoint (
              );
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // The file system works without the statistics, so a failure here is
+  // not fatal
+  //
+  if (!EFI_ERROR (Status)) {
+    if (EFI_ERROR (gBS->CreateEvent (
+                          EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                          TPL_CALLBACK,
+                          FatOnCacheStatisticsTimer,
+                          NULL,
+                          &mFatCacheStatisticsEvent
+                          ))) {
+      mFatCacheStatisticsEvent = NULL;
+    } else {
+      gBS->SetTimer (mFatCacheStatisticsEvent, TimerPeriodic, FAT_CACHE_STATISTICS_PERIOD);
+    }
+  }
+
   return Status;
 }
 
@@ -210,6 +233,11 @@ FatUnload (
     //
     // Driver is stopped successfully.
     //
+    if (mFatCacheStatisticsEvent != NULL) {
+      gBS->CloseEvent (mFatCacheStatisticsEvent);
+      mFatCacheStatisticsEvent = NULL;
+    }
+
     Status = gBS->HandleProtocol (ImageHandle, &gEfiComponentNameProtocolGuid, &ComponentName);
     if (EFI_ERROR (Status)) {
       ComponentName = NULL;
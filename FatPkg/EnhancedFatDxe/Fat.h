@@ -75,14 +75,45 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Minimum fat page size is 8K, maximum fat page alignment is 32K
 // Minimum data page size is 8K, maximum fat page alignment is 64K
+// The data page grows up to 256K to match the device's optimal transfer length
 //
 #define FAT_FATCACHE_PAGE_MIN_ALIGNMENT   13
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_PAGE_LIMIT_ALIGNMENT 18
+#define FAT_DATACACHE_GROUP_MIN_COUNT     64
+#define FAT_DATACACHE_GROUP_MAX_COUNT     512
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
-#define FAT_FATCACHE_GROUP_MAX_COUNT      16
+#define FAT_FATCACHE_GROUP_DEFAULT_COUNT  16
+#define FAT_FATCACHE_GROUP_MAX_COUNT      256
+
+//
+// Each cache may use up to 1/2^FAT_CACHE_MEMORY_SHIFT of the free memory
+//
+#define FAT_CACHE_MEMORY_SHIFT            9
+
+//
+// Read-ahead of the data cache starts after FAT_READ_AHEAD_THRESHOLD
+// consecutive pages have been accessed and keeps up to
+// FAT_READ_AHEAD_MAX_PAGES pages in flight ahead of the access. An access
+// to a page whose read-ahead is still in flight polls for its completion
+// for up to FAT_READ_AHEAD_TIMEOUT, after which read-ahead is disabled for
+// the volume and the reads in flight are cancelled. Pages whose read does
+// not complete even then are bypassed without waiting again
+//
+#define FAT_READ_AHEAD_THRESHOLD          2
+#define FAT_READ_AHEAD_MAX_PAGES          8
+#define FAT_READ_AHEAD_TIMEOUT            1000  // ms to wait for one read-ahead page
+
+#define FAT_CACHE_STATISTICS_NAME         L"FatCacheStatistics"
+
+//
+// While they change, the cache statistics are published once every
+// FAT_CACHE_STATISTICS_PERIOD, so that they can be read while volumes
+// stay mounted
+//
+#define FAT_CACHE_STATISTICS_PERIOD       EFI_TIMER_PERIOD_SECONDS (1)
 
 //
 // Used in 8.3 generation algorithm
@@ -105,6 +136,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MAX_LANG_CODE_SIZE      100
 
 #define FAT_MAX_DIR_CACHE_COUNT 8
+#define FAT_FREE_BITMAP_READ_SIZE 0x10000
+#define FAT_EXTENT_MIN_COUNT    16
+#define FAT_EXTENT_MAX_COUNT    0x10000
 #define FAT_MAX_DIRENTRY_COUNT  0xFFFF
 typedef CHAR8                   LC_ISO_639_2;
 
@@ -144,9 +178,18 @@ typedef enum {
 // Disk cache tag
 //
 typedef struct {
-  UINTN   PageNo;
-  UINTN   RealSize;
-  BOOLEAN Dirty;
+  UINTN               PageNo;
+  UINTN               RealSize;
+  BOOLEAN             Dirty;
+  //
+  // Pending is set while a read-ahead of the page is in flight; the page
+  // must not be used or replaced until it completes. Stale is set if the
+  // page was written meanwhile, so the read-ahead data is dropped.
+  //
+  BOOLEAN             Pending;
+  BOOLEAN             Stale;
+  BOOLEAN             ReadAhead;    // Filled by read-ahead and not yet hit
+  EFI_DISK_IO2_TOKEN  ReadAheadToken;
 } CACHE_TAG;
 
 typedef struct {
@@ -156,14 +199,35 @@ typedef struct {
   BOOLEAN   Dirty;
   UINT8     PageAlignment;
   UINTN     GroupMask;
-  CACHE_TAG CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  CACHE_TAG *CacheTag;
+  //
+  // Sequential access detection for read-ahead
+  //
+  BOOLEAN   ReadAheadDisabled;
+  UINTN     LastPageNo;
+  UINTN     SequentialCount;
+  UINTN     ReadAheadPageNo;
 } DISK_CACHE;
 
 //
-// Hash table size
+// Disk cache statistics of all volumes, published in the
+// FAT_CACHE_STATISTICS_NAME variable under the driver's file GUID
+// every FAT_CACHE_STATISTICS_PERIOD and when a volume is unmounted
 //
-#define HASH_TABLE_SIZE  0x400
-#define HASH_TABLE_MASK  (HASH_TABLE_SIZE - 1)
+typedef struct {
+  UINT64    FatHits;
+  UINT64    FatMisses;
+  UINT64    DataHits;
+  UINT64    DataMisses;
+  UINT64    ReadAheadPages;
+  UINT64    ReadAheadHits;
+} FAT_CACHE_STATISTICS;
+
+//
+// Hash table size, the tables grow and shrink with the number of entries
+//
+#define HASH_TABLE_MIN_SIZE  0x20
+#define HASH_TABLE_MAX_SIZE  0x10000
 
 //
 // The directory entry for opened directory
@@ -183,6 +247,8 @@ struct _FAT_DIRENT {
   FAT_OFILE           *OFile;                 // The OFile of the corresponding directory entry
   FAT_DIRENT          *ShortNameForwardLink;  // Hash successor link for short filename
   FAT_DIRENT          *LongNameForwardLink;   // Hash successor link for long filename
+  UINT32              ShortNameHash;          // Hash value of the short filename
+  UINT32              LongNameHash;           // Hash value of the long filename
   LIST_ENTRY          Link;                   // Connection of every directory entry
   FAT_DIRECTORY_ENTRY Entry;                  // The physical directory entry stored in disk
 };
@@ -196,8 +262,11 @@ struct _FAT_ODIR {
   BOOLEAN             EndOfDir;               // Indicate whether we have reached the end of the directory
   LIST_ENTRY          DirCacheLink;           // Linked in Volume->DirCacheList when discarded
   UINTN               DirCacheTag;            // The identification of the directory when in directory cache
-  FAT_DIRENT          *LongNameHashTable[HASH_TABLE_SIZE];
-  FAT_DIRENT          *ShortNameHashTable[HASH_TABLE_SIZE];
+  UINTN               HashTableSize;          // Number of buckets of each hash table, a power of 2
+  UINTN               HashEntryCount;         // Number of directory entries in the hash tables
+  FAT_DIRENT          **LongNameHashTable;
+  FAT_DIRENT          **ShortNameHashTable;
+  FAT_DIRENT          *MinHashTable[2 * HASH_TABLE_MIN_SIZE];  // Used while the tables are at minimum size
 };
 
 typedef struct {
@@ -229,6 +298,15 @@ typedef struct {
   LIST_ENTRY          Link;
 } FAT_SUBTASK;
 
+//
+// FAT_EXTENT - A run of consecutive clusters in a file's cluster chain
+//
+typedef struct {
+  UINTN               FileCluster;            // Index of the run's first cluster within the file
+  UINTN               Cluster;                // The run's first cluster on the volume
+  UINTN               Length;                 // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -272,6 +350,14 @@ struct _FAT_OFILE {
   UINT64              PosDisk;  // on the disk
   UINTN               PosRem;   // remaining in this disk run
   //
+  // Run-length map of the first MappedClusters clusters of the file's
+  // cluster chain, built up as the chain is walked
+  //
+  FAT_EXTENT          *Extents;
+  UINTN               ExtentCount;
+  UINTN               ExtentMax;
+  UINTN               MappedClusters;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE           *Parent;
@@ -336,6 +422,12 @@ struct _FAT_VOLUME {
   UINTN                           FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                         FreeInfoValid;  // If free cluster info is valid
   //
+  // In-memory free cluster bitmap, one bit per cluster, set if the cluster
+  // is free. Built from the FAT on first allocation and kept in sync by
+  // every FAT entry update afterwards. NULL if not (yet) built.
+  //
+  UINT32                          *FreeClusterBitmap;
+  //
   // Unpacked Fat BPB info
   //
   UINTN                           NumFats;
@@ -374,6 +466,7 @@ struct _FAT_VOLUME {
   // Disk Cache for this volume
   //
   VOID                            *CacheBuffer;
+  UINTN                           CacheBufferPages;
   DISK_CACHE                      DiskCache[CacheMaxType];
 };
 
@@ -711,6 +804,34 @@ FatInitializeDiskCache (
   IN FAT_VOLUME              *Volume
   );
 
+/**
+
+  Free the disk cache of the volume, after waiting for any read-ahead in flight.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME              *Volume
+  );
+
+/**
+
+  Timer notification function that publishes the cache statistics, if they
+  changed since they were last published.
+
+  @param  Event                 - The periodic timer event.
+  @param  Context               - Not used.
+
+**/
+VOID
+EFIAPI
+FatOnCacheStatisticsTimer (
+  IN EFI_EVENT               Event,
+  IN VOID                    *Context
+  );
+
 /**
 
   Read BufferSize bytes from the position of Offset into Buffer,
@@ -1759,6 +1880,30 @@ FatSetVolumeEntry (
 //
 // Hash.c
 //
+/**
+
+  Initialize the hash tables of a directory at their minimum size.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatInitializeHashTable (
+  IN FAT_ODIR           *ODir
+  );
+
+/**
+
+  Free the hash tables of a directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR           *ODir
+  );
+
 /**
 
   Search the long name hash table for the directory entry.
@@ -2004,5 +2149,6 @@ extern EFI_COMPONENT_NAME2_PROTOCOL    gFatComponentName2;
 extern EFI_LOCK                        FatFsLock;
 extern EFI_LOCK                        FatTaskLock;
 extern EFI_FILE_PROTOCOL               FatFileInterface;
+extern FAT_CACHE_STATISTICS            gFatCacheStatistics;
 
 #endif
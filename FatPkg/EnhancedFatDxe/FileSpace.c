@@ -10,6 +10,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+//
+// Free cluster bitmap accessors
+//
+#define FAT_FREE_BITMAP_BIT(Index)            ((UINT32) 1 << ((Index) % 32))
+#define FAT_FREE_BITMAP_TEST(Bitmap, Index)   (((Bitmap)[(Index) / 32] & FAT_FREE_BITMAP_BIT (Index)) != 0)
+#define FAT_FREE_BITMAP_SET(Bitmap, Index)    ((Bitmap)[(Index) / 32] |= FAT_FREE_BITMAP_BIT (Index))
+#define FAT_FREE_BITMAP_CLEAR(Bitmap, Index)  ((Bitmap)[(Index) / 32] &= ~FAT_FREE_BITMAP_BIT (Index))
 
 /**
 
@@ -166,6 +173,16 @@ FatSetFatEntry (
     }
   }
   //
+  // Keep the free cluster bitmap in sync with the FAT
+  //
+  if (Volume->FreeClusterBitmap != NULL && Index <= Volume->MaxCluster + 1) {
+    if (Value == FAT_CLUSTER_FREE) {
+      FAT_FREE_BITMAP_SET (Volume->FreeClusterBitmap, Index);
+    } else {
+      FAT_FREE_BITMAP_CLEAR (Volume->FreeClusterBitmap, Index);
+    }
+  }
+  //
   // Make sure the entry is in memory
   //
   Pos = FatLoadFatEntry (Volume, Index);
@@ -310,6 +327,320 @@ FatAllocateCluster (
   return Cluster;
 }
 
+/**
+
+  Build the free cluster bitmap of the volume by reading the whole FAT once,
+  and recompute the free cluster info from it.
+
+  @param  Volume                - FAT file system volume.
+
+  @retval EFI_SUCCESS           - The bitmap is built and the free info is valid.
+  @retval EFI_OUT_OF_RESOURCES  - Can not allocate memory for the bitmap.
+  @retval EFI_DEVICE_ERROR      - The FAT can not be read.
+
+**/
+STATIC
+EFI_STATUS
+FatBuildFreeClusterBitmap (
+  IN FAT_VOLUME   *Volume
+  )
+{
+  UINT32      *Bitmap;
+  VOID        *Buffer;
+  UINTN       EndCluster;
+  UINTN       EntrySize;
+  UINTN       Index;
+  UINTN       Count;
+  UINTN       Offset;
+  UINTN       Entry;
+  UINTN       FreeCount;
+  UINTN       NextCluster;
+
+  ASSERT (Volume->FreeClusterBitmap == NULL);
+
+  if (Volume->DiskError) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  EndCluster = Volume->MaxCluster + 2;
+  Bitmap     = AllocateZeroPool (((EndCluster + 31) / 32) * sizeof (UINT32));
+  if (Bitmap == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  FreeCount   = 0;
+  NextCluster = EndCluster;
+  if (Volume->FatType == Fat12) {
+    //
+    // FAT12 entries straddle bytes and the whole FAT is tiny, so go through
+    // the regular entry accessor
+    //
+    for (Index = FAT_MIN_CLUSTER; Index < EndCluster && !Volume->DiskError; Index++) {
+      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+        FAT_FREE_BITMAP_SET (Bitmap, Index);
+        FreeCount += 1;
+        NextCluster = MIN (NextCluster, Index);
+      }
+    }
+  } else {
+    //
+    // Read the FAT in large chunks rather than entry by entry
+    //
+    EntrySize = (Volume->FatType == Fat16) ? sizeof (UINT16) : sizeof (UINT32);
+    Buffer    = AllocatePool (FAT_FREE_BITMAP_READ_SIZE);
+    if (Buffer == NULL) {
+      FreePool (Bitmap);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    for (Index = FAT_MIN_CLUSTER; Index < EndCluster; Index += Count) {
+      Count = MIN (EndCluster - Index, FAT_FREE_BITMAP_READ_SIZE / EntrySize);
+      if (EFI_ERROR (FatDiskIo (Volume, ReadFat, Volume->FatPos + Index * EntrySize, Count * EntrySize, Buffer, NULL))) {
+        break;
+      }
+
+      for (Offset = 0; Offset < Count; Offset++) {
+        if (Volume->FatType == Fat16) {
+          Entry = ((UINT16 *) Buffer)[Offset];
+        } else {
+          Entry = ((UINT32 *) Buffer)[Offset] & FAT_CLUSTER_MASK_FAT32;
+        }
+
+        if (Entry == FAT_CLUSTER_FREE) {
+          FAT_FREE_BITMAP_SET (Bitmap, Index + Offset);
+          FreeCount += 1;
+          NextCluster = MIN (NextCluster, Index + Offset);
+        }
+      }
+    }
+
+    FreePool (Buffer);
+  }
+
+  if (Volume->DiskError) {
+    FreePool (Bitmap);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Volume->FreeClusterBitmap                    = Bitmap;
+  Volume->FreeInfoValid                        = TRUE;
+  Volume->FatInfoSector.FreeInfo.ClusterCount  = (UINT32) FreeCount;
+  if (NextCluster < EndCluster) {
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) NextCluster;
+  }
+
+  Volume->FatInfoSector.Signature          = FAT_INFO_SIGNATURE;
+  Volume->FatInfoSector.InfoBeginSignature = FAT_INFO_BEGIN_SIGNATURE;
+  Volume->FatInfoSector.InfoEndSignature   = FAT_INFO_END_SIGNATURE;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Get the number of consecutive free clusters starting at Cluster, as recorded
+  in the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The first cluster of the run.
+  @param  Wanted                - The maximum run length of interest.
+
+  @return The length of the free run, at most Wanted; 0 if Cluster is not free.
+
+**/
+STATIC
+UINTN
+FatFreeRunLength (
+  IN FAT_VOLUME   *Volume,
+  IN UINTN        Cluster,
+  IN UINTN        Wanted
+  )
+{
+  UINT32  *Bitmap;
+  UINTN   EndCluster;
+  UINTN   Index;
+  UINTN   Length;
+
+  Bitmap     = Volume->FreeClusterBitmap;
+  EndCluster = Volume->MaxCluster + 2;
+  Length     = 0;
+
+  while (Length < Wanted && Cluster + Length < EndCluster) {
+    Index = Cluster + Length;
+    //
+    // Skip whole words of free clusters at once
+    //
+    if ((Index % 32) == 0 && Bitmap[Index / 32] == MAX_UINT32) {
+      Length += 32;
+      continue;
+    }
+
+    if (!FAT_FREE_BITMAP_TEST (Bitmap, Index)) {
+      break;
+    }
+
+    Length += 1;
+  }
+
+  return MIN (Length, Wanted);
+}
+
+/**
+
+  Search the free cluster bitmap in [Start, End) for a run of Wanted free
+  clusters. The first run that is long enough is returned, otherwise the
+  longest run found.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The first cluster to look at.
+  @param  End                   - The cluster after the last one to look at.
+  @param  Wanted                - The number of clusters wanted.
+  @param  Length                - The length of the run found, 0 if none.
+
+  @return The first cluster of the run found.
+
+**/
+STATIC
+UINTN
+FatFindFreeRun (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       Start,
+  IN  UINTN       End,
+  IN  UINTN       Wanted,
+  OUT UINTN       *Length
+  )
+{
+  UINT32  *Bitmap;
+  UINT32  Word;
+  UINTN   Index;
+  UINTN   RunLength;
+  UINTN   BestCluster;
+  UINTN   BestLength;
+
+  Bitmap      = Volume->FreeClusterBitmap;
+  BestCluster = 0;
+  BestLength  = 0;
+  Index       = Start;
+
+  while (Index < End) {
+    //
+    // Skip whole words of allocated clusters at once
+    //
+    Word = Bitmap[Index / 32] >> (Index % 32);
+    if (Word == 0) {
+      Index = (Index | 31) + 1;
+      continue;
+    }
+
+    Index += (UINTN) LowBitSet32 (Word);
+    if (Index >= End) {
+      break;
+    }
+
+    RunLength = FatFreeRunLength (Volume, Index, Wanted);
+    if (RunLength > BestLength) {
+      BestCluster = Index;
+      BestLength  = RunLength;
+      if (BestLength >= Wanted) {
+        break;
+      }
+    }
+
+    //
+    // The cluster right after a short run is known to be in use
+    //
+    Index += RunLength + 1;
+  }
+
+  *Length = BestLength;
+  return BestCluster;
+}
+
+/**
+
+  Allocate a run of consecutive free clusters. The clusters are not marked
+  as used in the FAT; the caller must do so.
+
+  @param  Volume                - FAT file system volume.
+  @param  Hint                  - Preferred first cluster, usually the one following
+                                  the file's last cluster.
+  @param  Wanted                - The number of clusters wanted.
+  @param  Count                 - The number of consecutive clusters allocated,
+                                  between 1 and Wanted.
+
+  @return The index of the first cluster of the run, or FAT_CLUSTER_LAST if the
+          volume is full.
+
+**/
+STATIC
+UINTN
+FatAllocateClusters (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       Hint,
+  IN  UINTN       Wanted,
+  OUT UINTN       *Count
+  )
+{
+  UINTN Cluster;
+  UINTN Length;
+  UINTN EndCluster;
+  UINTN Start;
+  UINTN WrapCluster;
+  UINTN WrapLength;
+
+  *Count = 1;
+  if (Volume->DiskError) {
+    return (UINTN) FAT_CLUSTER_LAST;
+  }
+
+  if (Volume->FreeClusterBitmap == NULL) {
+    if (EFI_ERROR (FatBuildFreeClusterBitmap (Volume))) {
+      //
+      // No bitmap, fall back to scanning the FAT one cluster at a time
+      //
+      return FatAllocateCluster (Volume);
+    }
+  }
+
+  EndCluster = Volume->MaxCluster + 2;
+
+  //
+  // Prefer growing the file in place so that it stays contiguous
+  //
+  Length = 0;
+  if (Hint >= FAT_MIN_CLUSTER && Hint < EndCluster) {
+    Cluster = Hint;
+    Length  = FatFreeRunLength (Volume, Hint, Wanted);
+  }
+
+  if (Length == 0) {
+    //
+    // Look for a long enough run from the free info hint to the end of the
+    // volume, then wrap around to the beginning
+    //
+    Start = Volume->FatInfoSector.FreeInfo.NextCluster;
+    if (Start < FAT_MIN_CLUSTER || Start >= EndCluster) {
+      Start = FAT_MIN_CLUSTER;
+    }
+
+    Cluster = FatFindFreeRun (Volume, Start, EndCluster, Wanted, &Length);
+    if (Length < Wanted && Start > FAT_MIN_CLUSTER) {
+      WrapCluster = FatFindFreeRun (Volume, FAT_MIN_CLUSTER, Start, Wanted, &WrapLength);
+      if (WrapLength > Length) {
+        Cluster = WrapCluster;
+        Length  = WrapLength;
+      }
+    }
+
+    if (Length == 0) {
+      return (UINTN) FAT_CLUSTER_LAST;
+    }
+  }
+
+  Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) (Cluster + Length);
+  *Count = Length;
+  return Cluster;
+}
+
 /**
 
   Count the number of clusters given a size.
@@ -337,6 +668,126 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Extend the extent map of the open file by walking its cluster chain, until
+  at least the given number of clusters is mapped or the chain ends.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters from the start of the file
+                                  which should be mapped.
+
+  @retval EFI_SUCCESS           - The map covers Clusters clusters or the whole chain.
+  @retval EFI_OUT_OF_RESOURCES  - The map can not grow any further.
+  @retval EFI_VOLUME_CORRUPTED  - Cluster chain corrupt.
+
+**/
+STATIC
+EFI_STATUS
+FatExtendExtentMap (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Clusters
+  )
+{
+  FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       NewMax;
+  UINTN       Cluster;
+
+  Volume = OFile->Volume;
+  Extent = NULL;
+
+  while (OFile->MappedClusters < Clusters) {
+    if (OFile->ExtentCount == 0) {
+      Cluster = OFile->FileCluster;
+      if (Cluster == FAT_CLUSTER_FREE) {
+        break;
+      }
+    } else {
+      Extent  = &OFile->Extents[OFile->ExtentCount - 1];
+      Cluster = FatGetFatEntry (Volume, Extent->Cluster + Extent->Length - 1);
+    }
+
+    if (FAT_END_OF_FAT_CHAIN (Cluster)) {
+      break;
+    }
+
+    if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1) {
+      DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatExtendExtentMap: cluster chain corrupt\n"));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (Extent != NULL && Cluster == Extent->Cluster + Extent->Length) {
+      Extent->Length += 1;
+    } else {
+      if (OFile->ExtentCount == OFile->ExtentMax) {
+        if (OFile->ExtentMax >= FAT_EXTENT_MAX_COUNT) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+
+        NewMax     = (OFile->ExtentMax == 0) ? FAT_EXTENT_MIN_COUNT : OFile->ExtentMax * 2;
+        NewExtents = ReallocatePool (
+                       OFile->ExtentMax * sizeof (FAT_EXTENT),
+                       NewMax * sizeof (FAT_EXTENT),
+                       OFile->Extents
+                       );
+        if (NewExtents == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+
+        OFile->Extents   = NewExtents;
+        OFile->ExtentMax = NewMax;
+      }
+
+      Extent              = &OFile->Extents[OFile->ExtentCount];
+      Extent->FileCluster = OFile->MappedClusters;
+      Extent->Cluster     = Cluster;
+      Extent->Length      = 1;
+      OFile->ExtentCount += 1;
+    }
+
+    OFile->MappedClusters += 1;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Drop the part of the open file's extent map beyond the given number of
+  clusters, after the cluster chain has been cut there.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters left in the file.
+
+**/
+STATIC
+VOID
+FatTrimExtentMap (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Clusters
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  if (OFile->MappedClusters <= Clusters) {
+    return;
+  }
+
+  while (OFile->ExtentCount > 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster < Clusters) {
+      Extent->Length = MIN (Extent->Length, Clusters - Extent->FileCluster);
+      break;
+    }
+
+    OFile->ExtentCount -= 1;
+  }
+
+  OFile->MappedClusters = Clusters;
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -362,6 +813,7 @@ FatShrinkEof (
   ASSERT_VOLUME_LOCKED (Volume);
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
+  FatTrimExtentMap (OFile, NewSize);
 
   //
   // Find the address of the last cluster
@@ -436,6 +888,8 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  UINTN       RunLength;
+  UINTN       Index;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -492,7 +946,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateClusters (Volume, LastCluster + 1, NewSize - CurSize, &RunLength);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
@@ -503,11 +957,31 @@ FatGrowEof (
         goto Done;
       }
 
-      if (NewCluster < FAT_MIN_CLUSTER || NewCluster > Volume->MaxCluster + 1) {
+      if (NewCluster < FAT_MIN_CLUSTER || NewCluster + RunLength > Volume->MaxCluster + 2) {
         Status = EFI_VOLUME_CORRUPTED;
         goto Done;
       }
 
+      //
+      // Chain the newly allocated run of clusters together
+      //
+      for (Index = NewCluster; Index < NewCluster + RunLength - 1; Index++) {
+        FatSetFatEntry (Volume, Index, Index + 1);
+      }
+
+      //
+      // Terminate the cluster list
+      //
+      // Note that we must do this EVERY time we allocate clusters, because
+      // the allocator scans for free clusters and the new "LastCluster"
+      // is no longer free!  Without the free cluster bitmap, FatAllocateCluster
+      // will usually start looking with the cluster after "LastCluster";
+      // however, when there is only one free cluster left, it will find
+      // "LastCluster" a second time.  There are other, less predictable
+      // scenarios where this could happen, as well.
+      //
+      FatSetFatEntry (Volume, NewCluster + RunLength - 1, (UINTN) FAT_CLUSTER_LAST);
+
       if (LastCluster != 0) {
         FatSetFatEntry (Volume, LastCluster, NewCluster);
       } else {
@@ -515,21 +989,8 @@ FatGrowEof (
         OFile->FileCurrentCluster = NewCluster;
       }
 
-      LastCluster = NewCluster;
-      CurSize += 1;
-
-      //
-      // Terminate the cluster list
-      //
-      // Note that we must do this EVERY time we allocate a cluster, because
-      // FatAllocateCluster scans the FAT looking for a free cluster and
-      // "LastCluster" is no longer free!  Usually, FatAllocateCluster will
-      // start looking with the cluster after "LastCluster"; however, when
-      // there is only one free cluster left, it will find "LastCluster"
-      // a second time.  There are other, less predictable scenarios
-      // where this could happen, as well.
-      //
-      FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
+      LastCluster = NewCluster + RunLength - 1;
+      CurSize    += RunLength;
       OFile->FileLastCluster = LastCluster;
     }
   }
@@ -568,6 +1029,13 @@ FatOFilePosition (
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       ClusterIndex;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+  FAT_EXTENT  *Extent;
+  UINT64      RunSize;
+  EFI_STATUS  Status;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -581,9 +1049,60 @@ FatOFilePosition (
   if (OFile->IsFixedRootDir) {
     OFile->PosDisk  = Volume->RootPos + Position;
     Run             = OFile->FileSize - Position;
+    OFile->PosRem   = Run;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Make sure the extent map covers the position and as much of the
+  // access as the cluster chain allows
+  //
+  ClusterIndex = Position >> Volume->ClusterAlignment;
+  Status       = FatExtendExtentMap (OFile, ((Position + MAX (PosLimit, 1) - 1) >> Volume->ClusterAlignment) + 1);
+  if (EFI_ERROR (Status) && Status != EFI_OUT_OF_RESOURCES) {
+    return Status;
+  }
+
+  if (ClusterIndex < OFile->MappedClusters) {
+    //
+    // Binary search the extent holding the position
+    //
+    Low  = 0;
+    High = OFile->ExtentCount - 1;
+    while (Low < High) {
+      Middle = (Low + High + 1) / 2;
+      if (OFile->Extents[Middle].FileCluster <= ClusterIndex) {
+        Low = Middle;
+      } else {
+        High = Middle - 1;
+      }
+    }
+
+    Extent                    = &OFile->Extents[Low];
+    Cluster                   = Extent->Cluster + (ClusterIndex - Extent->FileCluster);
+    StartPos                  = Position & ~(ClusterSize - 1);
+    OFile->PosDisk            = Volume->FirstClusterPos +
+                                LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
+                                Position - StartPos;
+    OFile->FileCurrentCluster = Cluster;
+    OFile->Position           = StartPos;
+
+    //
+    // The rest of the extent is contiguous on the disk, so it can be
+    // accessed as a single run
+    //
+    RunSize = LShiftU64 (Extent->FileCluster + Extent->Length - ClusterIndex, Volume->ClusterAlignment) - (Position - StartPos);
+    Run     = (UINTN) MIN (RunSize, MAX_UINTN);
+  } else if (!EFI_ERROR (Status)) {
+    //
+    // The cluster chain ends before the position
+    //
+    DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatOFilePosition:"" cluster chain corrupt\n"));
+    return EFI_VOLUME_CORRUPTED;
   } else {
     //
-    // Run the file's cluster chain to find the current position
+    // The extent map can not grow any more, run the file's cluster chain
+    // to find the current position
     // If possible, run from the current cluster rather than
     // start from beginning
     // Assumption: OFile->Position is always consistent with
@@ -723,6 +1242,13 @@ FatComputeFreeInfo (
   // If we don't have valid info, compute it now
   //
   if (!Volume->FreeInfoValid) {
+    //
+    // Building the free cluster bitmap reads the whole FAT in large chunks
+    // and computes the free info as a side effect
+    //
+    if (Volume->FreeClusterBitmap == NULL && !EFI_ERROR (FatBuildFreeClusterBitmap (Volume))) {
+      return;
+    }
 
     Volume->FreeInfoValid                        = TRUE;
     Volume->FatInfoSector.FreeInfo.ClusterCount  = 0;
@@ -8,10 +8,44 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+//
+// 32-bit FNV-1a parameters
+//
+#define FAT_HASH_OFFSET_BASIS  0x811C9DC5
+#define FAT_HASH_PRIME         0x01000193
+
+/**
+
+  Mix the bits of a hash value so that its low bits, which select the bucket,
+  depend on every character hashed.
+
+  @param  HashValue             - The hash value to mix.
+
+  @return The mixed hash value.
+
+**/
+STATIC
+UINT32
+FatHashFinalize (
+  IN UINT32   HashValue
+  )
+{
+  HashValue ^= HashValue >> 16;
+  HashValue *= 0x85EBCA6B;
+  HashValue ^= HashValue >> 13;
+  HashValue *= 0xC2B2AE35;
+  HashValue ^= HashValue >> 16;
+  return HashValue;
+}
+
 /**
 
   Get hash value for long name.
 
+  The name is upcased one character at a time while hashing, so that names
+  comparing equal with FatStriCmp hash equally. ASCII letters are folded
+  inline, other characters go through the Unicode Collation protocol.
+
   @param  LongNameString        - The long name string to be hashed.
 
   @return HashValue.
@@ -24,16 +58,25 @@ FatHashLongName (
   )
 {
   UINT32  HashValue;
-  CHAR16  UpCasedLongFileName[EFI_PATH_STRING_LENGTH];
-  StrnCpyS (
-    UpCasedLongFileName,
-    ARRAY_SIZE (UpCasedLongFileName),
-    LongNameString,
-    ARRAY_SIZE (UpCasedLongFileName) - 1
-    );
-  FatStrUpr (UpCasedLongFileName);
-  gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  CHAR16  Char;
+  CHAR16  UpCasedChar[2];
+
+  HashValue = FAT_HASH_OFFSET_BASIS;
+  for (; *LongNameString != 0; LongNameString++) {
+    Char = *LongNameString;
+    if (Char >= L'a' && Char <= L'z') {
+      Char = (CHAR16) (Char - L'a' + L'A');
+    } else if (Char >= 0x80) {
+      UpCasedChar[0] = Char;
+      UpCasedChar[1] = 0;
+      FatStrUpr (UpCasedChar);
+      Char = UpCasedChar[0];
+    }
+
+    HashValue = (HashValue ^ Char) * FAT_HASH_PRIME;
+  }
+
+  return FatHashFinalize (HashValue);
 }
 
 /**
@@ -52,8 +95,115 @@ FatHashShortName (
   )
 {
   UINT32  HashValue;
-  gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  UINTN   Index;
+
+  HashValue = FAT_HASH_OFFSET_BASIS;
+  for (Index = 0; Index < FAT_NAME_LEN; Index++) {
+    HashValue = (HashValue ^ (UINT8) ShortNameString[Index]) * FAT_HASH_PRIME;
+  }
+
+  return FatHashFinalize (HashValue);
+}
+
+/**
+
+  Initialize the hash tables of a directory at their minimum size.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatInitializeHashTable (
+  IN FAT_ODIR     *ODir
+  )
+{
+  ODir->HashTableSize       = HASH_TABLE_MIN_SIZE;
+  ODir->HashEntryCount      = 0;
+  ODir->LongNameHashTable   = ODir->MinHashTable;
+  ODir->ShortNameHashTable  = ODir->MinHashTable + HASH_TABLE_MIN_SIZE;
+  ZeroMem (ODir->MinHashTable, sizeof (ODir->MinHashTable));
+}
+
+/**
+
+  Free the hash tables of a directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR     *ODir
+  )
+{
+  if (ODir->LongNameHashTable != ODir->MinHashTable) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
+  FatInitializeHashTable (ODir);
+}
+
+/**
+
+  Rehash all the directory entries of a directory into tables of a new size.
+  The tables are left unchanged if memory can not be allocated.
+
+  @param  ODir                  - The directory.
+  @param  NewSize               - The new number of buckets, a power of 2.
+
+**/
+STATIC
+VOID
+FatResizeHashTable (
+  IN FAT_ODIR     *ODir,
+  IN UINTN        NewSize
+  )
+{
+  FAT_DIRENT  **NewLongNameTable;
+  FAT_DIRENT  **NewShortNameTable;
+  FAT_DIRENT  *DirEnt;
+  FAT_DIRENT  *NextDirEnt;
+  UINTN       Index;
+  UINTN       HashTableIndex;
+
+  if (NewSize == HASH_TABLE_MIN_SIZE) {
+    //
+    // Move back to the minimum tables embedded in the directory
+    //
+    ZeroMem (ODir->MinHashTable, sizeof (ODir->MinHashTable));
+    NewLongNameTable = ODir->MinHashTable;
+  } else {
+    NewLongNameTable = AllocateZeroPool (2 * NewSize * sizeof (FAT_DIRENT *));
+    if (NewLongNameTable == NULL) {
+      return;
+    }
+  }
+
+  NewShortNameTable = NewLongNameTable + NewSize;
+
+  for (Index = 0; Index < ODir->HashTableSize; Index++) {
+    for (DirEnt = ODir->LongNameHashTable[Index]; DirEnt != NULL; DirEnt = NextDirEnt) {
+      NextDirEnt                        = DirEnt->LongNameForwardLink;
+      HashTableIndex                    = DirEnt->LongNameHash & (NewSize - 1);
+      DirEnt->LongNameForwardLink       = NewLongNameTable[HashTableIndex];
+      NewLongNameTable[HashTableIndex]  = DirEnt;
+    }
+
+    for (DirEnt = ODir->ShortNameHashTable[Index]; DirEnt != NULL; DirEnt = NextDirEnt) {
+      NextDirEnt                        = DirEnt->ShortNameForwardLink;
+      HashTableIndex                    = DirEnt->ShortNameHash & (NewSize - 1);
+      DirEnt->ShortNameForwardLink      = NewShortNameTable[HashTableIndex];
+      NewShortNameTable[HashTableIndex] = DirEnt;
+    }
+  }
+
+  if (ODir->LongNameHashTable != ODir->MinHashTable) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
+  ODir->HashTableSize       = NewSize;
+  ODir->LongNameHashTable   = NewLongNameTable;
+  ODir->ShortNameHashTable  = NewShortNameTable;
 }
 
 /**
@@ -73,11 +223,15 @@ FatLongNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  UINT32      HashValue;
+
+  HashValue = FatHashLongName (LongNameString);
+  for (PreviousHashNode   = &ODir->LongNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
       ) {
-    if (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
+    if ((*PreviousHashNode)->LongNameHash == HashValue &&
+        FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
       break;
     }
   }
@@ -102,11 +256,15 @@ FatShortNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
-  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString)];
+  UINT32      HashValue;
+
+  HashValue = FatHashShortName (ShortNameString);
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
       ) {
-    if (CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0) {
+    if ((*PreviousHashNode)->ShortNameHash == HashValue &&
+        CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0) {
       break;
     }
   }
@@ -131,17 +289,27 @@ FatInsertToHashTable (
   FAT_DIRENT  **HashTable;
   UINT32      HashTableIndex;
 
+  //
+  // Keep the tables at no more than one entry per bucket on average
+  //
+  ODir->HashEntryCount++;
+  if (ODir->HashEntryCount > ODir->HashTableSize && ODir->HashTableSize < HASH_TABLE_MAX_SIZE) {
+    FatResizeHashTable (ODir, ODir->HashTableSize * 2);
+  }
+
   //
   // Insert hash table index for short name
   //
-  HashTableIndex                = FatHashShortName (DirEnt->Entry.FileName);
+  DirEnt->ShortNameHash         = FatHashShortName (DirEnt->Entry.FileName);
+  HashTableIndex                = DirEnt->ShortNameHash & (UINT32) (ODir->HashTableSize - 1);
   HashTable                     = ODir->ShortNameHashTable;
   DirEnt->ShortNameForwardLink  = HashTable[HashTableIndex];
   HashTable[HashTableIndex]     = DirEnt;
   //
   // Insert hash table index for long name
   //
-  HashTableIndex                = FatHashLongName (DirEnt->FileString);
+  DirEnt->LongNameHash          = FatHashLongName (DirEnt->FileString);
+  HashTableIndex                = DirEnt->LongNameHash & (UINT32) (ODir->HashTableSize - 1);
   HashTable                     = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink   = HashTable[HashTableIndex];
   HashTable[HashTableIndex]     = DirEnt;
@@ -161,6 +329,35 @@ FatDeleteFromHashTable (
   IN FAT_DIRENT   *DirEnt
   )
 {
-  *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
-  *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  FAT_DIRENT  **PreviousHashNode;
+
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[DirEnt->ShortNameHash & (ODir->HashTableSize - 1)];
+       *PreviousHashNode != NULL && *PreviousHashNode != DirEnt;
+       PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
+      ) {
+  }
+
+  ASSERT (*PreviousHashNode == DirEnt);
+  if (*PreviousHashNode != NULL) {
+    *PreviousHashNode = DirEnt->ShortNameForwardLink;
+  }
+
+  for (PreviousHashNode   = &ODir->LongNameHashTable[DirEnt->LongNameHash & (ODir->HashTableSize - 1)];
+       *PreviousHashNode != NULL && *PreviousHashNode != DirEnt;
+       PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
+      ) {
+  }
+
+  ASSERT (*PreviousHashNode == DirEnt);
+  if (*PreviousHashNode != NULL) {
+    *PreviousHashNode = DirEnt->LongNameForwardLink;
+  }
+
+  //
+  // Shrink the tables once they are mostly empty
+  //
+  ODir->HashEntryCount--;
+  if (ODir->HashTableSize > HASH_TABLE_MIN_SIZE && ODir->HashEntryCount < ODir->HashTableSize / 4) {
+    FatResizeHashTable (ODir, ODir->HashTableSize / 2);
+  }
 }
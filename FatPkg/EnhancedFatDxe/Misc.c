@@ -461,8 +461,12 @@ FatFreeVolume (
   //
   // Free disk cache
   //
-  if (Volume->CacheBuffer != NULL) {
-    FreePool (Volume->CacheBuffer);
+  FatFreeDiskCache (Volume);
+  //
+  // Free the free cluster bitmap
+  //
+  if (Volume->FreeClusterBitmap != NULL) {
+    FreePool (Volume->FreeClusterBitmap);
   }
   //
   // Free directory cache
@@ -620,6 +620,38 @@ DumpMemoryProfileMemoryRange (
   return (VOID *) Descriptor;
 }
 
+/**
+  Dump memory profile pool slab information.
+
+  @param[in] PoolSlab           Pointer to memory profile pool slab.
+
+  @return Pointer to the end of memory profile pool slab buffer.
+
+**/
+VOID *
+DumpMemoryProfilePoolSlab (
+  IN MEMORY_PROFILE_POOL_SLAB       *PoolSlab
+  )
+{
+  UINTN                         TypeIndex;
+
+  if (PoolSlab->Header.Signature != MEMORY_PROFILE_POOL_SLAB_SIGNATURE) {
+    return NULL;
+  }
+  Print (L"MEMORY_PROFILE_POOL_SLAB\n");
+  Print (L"  Signature                     - 0x%08x\n", PoolSlab->Header.Signature);
+  Print (L"  Length                        - 0x%04x\n", PoolSlab->Header.Length);
+  Print (L"  Revision                      - 0x%04x\n", PoolSlab->Header.Revision);
+  for (TypeIndex = 0; TypeIndex < sizeof (PoolSlab->SlabSizeByType) / sizeof (PoolSlab->SlabSizeByType[0]); TypeIndex++) {
+    if (PoolSlab->SlabSizeByType[TypeIndex] != 0) {
+      Print (L"  SlabSize[0x%02x]                - 0x%016lx (%a)\n", TypeIndex, PoolSlab->SlabSizeByType[TypeIndex], mMemoryTypeString[TypeIndex]);
+      Print (L"  SlabUsage[0x%02x]               - 0x%016lx (%a)\n", TypeIndex, PoolSlab->SlabUsageByType[TypeIndex], mMemoryTypeString[TypeIndex]);
+    }
+  }
+
+  return (VOID *) ((UINTN) PoolSlab + PoolSlab->Header.Length);
+}
+
 /**
   Scan memory profile by Signature.
 
@@ -678,6 +710,7 @@ DumpMemoryProfile (
   MEMORY_PROFILE_CONTEXT        *Context;
   MEMORY_PROFILE_FREE_MEMORY    *FreeMemory;
   MEMORY_PROFILE_MEMORY_RANGE   *MemoryRange;
+  MEMORY_PROFILE_POOL_SLAB      *PoolSlab;
 
   Context = (MEMORY_PROFILE_CONTEXT *) ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_CONTEXT_SIGNATURE);
   if (Context != NULL) {
@@ -693,6 +726,11 @@ DumpMemoryProfile (
   if (MemoryRange != NULL) {
     DumpMemoryProfileMemoryRange (MemoryRange);
   }
+
+  PoolSlab = (MEMORY_PROFILE_POOL_SLAB *) ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_POOL_SLAB_SIGNATURE);
+  if (PoolSlab != NULL) {
+    DumpMemoryProfilePoolSlab (PoolSlab);
+  }
 }
 
 /**
@@ -64,6 +64,55 @@ GetVariableStatisticsData (
   return Status;
 }
 
+/**
+  This function gets and prints the flash usage of the reclaims of the
+  non-volatile variable store from SMM variable driver.
+
+  @param[in, out] SmmCommunicateHeader The SMM communication buffer.
+  @param[in]      SmmCommunicateSize   The size of the SmmCommunicateHeader.
+
+**/
+VOID
+PrintReclaimStatisticsFromSmm (
+  IN OUT  EFI_MM_COMMUNICATE_HEADER   *SmmCommunicateHeader,
+  IN      UINTN                       SmmCommunicateSize
+  )
+{
+  EFI_STATUS                                       Status;
+  SMM_VARIABLE_COMMUNICATE_HEADER                  *SmmVariableFunctionHeader;
+  SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS  *ReclaimStatistics;
+  UINTN                                            CommSize;
+
+  CommSize = SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + sizeof (*ReclaimStatistics);
+  if (CommSize > SmmCommunicateSize) {
+    return;
+  }
+  ZeroMem (SmmCommunicateHeader, CommSize);
+
+  CopyGuid (&SmmCommunicateHeader->HeaderGuid, &gEfiSmmVariableProtocolGuid);
+  SmmCommunicateHeader->MessageLength = CommSize - OFFSET_OF (EFI_MM_COMMUNICATE_HEADER, Data);
+
+  SmmVariableFunctionHeader = (SMM_VARIABLE_COMMUNICATE_HEADER *) &SmmCommunicateHeader->Data[0];
+  SmmVariableFunctionHeader->Function = SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS;
+
+  Status = mMmCommunication2->Communicate (mMmCommunication2,
+                                           SmmCommunicateHeader,
+                                           SmmCommunicateHeader,
+                                           &CommSize);
+  if (EFI_ERROR (Status) || EFI_ERROR (SmmVariableFunctionHeader->ReturnStatus)) {
+    return;
+  }
+
+  ReclaimStatistics = (SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS *) SmmVariableFunctionHeader->Data;
+  Print (L"SMM Driver Non-Volatile Variable Store Reclaims:\n");
+  Print (
+    L"%d reclaims, 0x%lx bytes rewritten by the last one, 0x%lx bytes in total\n",
+    ReclaimStatistics->ReclaimCount,
+    ReclaimStatistics->LastRewrittenSize,
+    ReclaimStatistics->TotalRewrittenSize
+    );
+}
+
 /**
 
   This function get and print the variable statistics data from SMM variable driver.
@@ -188,6 +237,8 @@ PrintInfoFromSmm (
     }
   } while (TRUE);
 
+  PrintReclaimStatisticsFromSmm (CommBuffer, RealCommSize);
+
   return Status;
 }
 
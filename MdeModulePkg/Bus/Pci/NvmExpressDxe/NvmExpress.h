@@ -40,6 +40,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA     NVME_DEVICE_PRIVATE_DATA;
@@ -64,17 +65,35 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 //
 // Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// With the default depth of 255, the asynchronous I/O submission queue size
+// is 16kB in total.
 //
-#define NVME_ASYNC_CSQ_SIZE                       63
+#define NVME_ASYNC_CSQ_SIZE                       FixedPcdGet16 (PcdNvmeAsyncIoQueueSize)
 //
 // Number of asynchronous I/O completion queue entries, which is 0-based.
-// The asynchronous I/O completion queue size is 4kB in total.
+// It is never smaller than the submission queue, so every command queued on
+// the asynchronous I/O submission queue has a completion queue entry.
 //
-#define NVME_ASYNC_CCQ_SIZE                       255
+#define NVME_ASYNC_CCQ_SIZE                       MAX (NVME_ASYNC_CSQ_SIZE, 255)
 
 #define NVME_MAX_QUEUES                           3     // Number of queues supported by the driver
 
+//
+// Number of pages backing the asynchronous I/O submission & completion queues.
+// They are derived from the queue depths above, so the depths can be tuned
+// without touching the layout of the queue buffer.
+//
+#define NVME_ASYNC_SQ_PAGES                       EFI_SIZE_TO_PAGES ((NVME_ASYNC_CSQ_SIZE + 1) * sizeof (NVME_SQ))
+#define NVME_ASYNC_CQ_PAGES                       EFI_SIZE_TO_PAGES ((NVME_ASYNC_CCQ_SIZE + 1) * sizeof (NVME_CQ))
+#define NVME_QUEUE_BUFFER_PAGES                   (4 + NVME_ASYNC_SQ_PAGES + NVME_ASYNC_CQ_PAGES)
+
+//
+// Number of single page PRP lists preallocated behind the queues, one bit per
+// page is tracked in PrpListPoolUsed so it can not exceed 32.
+//
+#define NVME_PRP_LIST_POOL_PAGES                  32
+#define NVME_BUFFER_PAGES                         (NVME_QUEUE_BUFFER_PAGES + NVME_PRP_LIST_POOL_PAGES)
+
 #define NVME_CONTROLLER_ID                        0
 
 //
@@ -116,13 +135,14 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA          *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // NVME_BUFFER_PAGES x 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // 5th 4kB boundary is the start of I/O submission queue #2, which spans
+  // NVME_ASYNC_SQ_PAGES pages and is followed by I/O completion queue #2.
+  // The remaining NVME_PRP_LIST_POOL_PAGES pages hold the PRP list pool.
   //
   UINT8                               *Buffer;
   UINT8                               *BufferPciAddr;
@@ -150,6 +170,11 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   UINT8                               Pt[NVME_MAX_QUEUES];
   UINT16                              Cid[NVME_MAX_QUEUES];
 
+  //
+  // Pages of the PRP list pool that are in use, one bit per page.
+  //
+  UINT32                              PrpListPoolUsed;
+
   //
   // Nvme controller capabilities
   //
@@ -722,6 +747,77 @@ NvmeDumpStatus (
   IN NVME_CQ             *Cq
   );
 
+/**
+  Create PRP lists for data transfer which is larger than 2 memory pages.
+  Note here we calcuate the number of required PRP lists and allocate them at one time.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PhysicalAddr        The physical base address of data buffer.
+  @param[in]     Pages               The number of pages to be transfered.
+  @param[out]    PrpListHost         The host base address of PRP lists.
+  @param[in,out] PrpListNo           The number of PRP List.
+  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+
+  @retval The pointer to the first PRP List of the PRP lists.
+
+**/
+VOID*
+NvmeCreatePrpList (
+  IN     NVME_CONTROLLER_PRIVATE_DATA *Private,
+  IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
+  IN     UINTN                        Pages,
+     OUT VOID                         **PrpListHost,
+  IN OUT UINTN                        *PrpListNo,
+     OUT VOID                         **Mapping
+  );
+
+/**
+  Free the PRP lists created by NvmeCreatePrpList().
+
+  The caller is responsible for unmapping the PRP lists beforehand.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PrpListHost         The host base address of PRP lists.
+  @param[in]     PrpListNo           The number of PRP List.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN VOID                             *PrpListHost,
+  IN UINTN                            PrpListNo
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT                    Event,
+  IN VOID*                        Context
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
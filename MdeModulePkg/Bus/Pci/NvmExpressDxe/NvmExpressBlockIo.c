@@ -195,6 +195,17 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer in flight at the same time,
+    // unless the request can not be queued at all.
+    //
+    Status = NvmeConcurrentReadWrite (Device, Buffer, Lba, Blocks, MaxTransferBlocks, FALSE);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      Blocks = 0;
+    }
+  }
+
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
       Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
@@ -273,6 +284,17 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer in flight at the same time,
+    // unless the request can not be queued at all.
+    //
+    Status = NvmeConcurrentReadWrite (Device, Buffer, Lba, Blocks, MaxTransferBlocks, TRUE);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      Blocks = 0;
+    }
+  }
+
   while (Blocks > 0) {
     if (Blocks > MaxTransferBlocks) {
       Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
@@ -923,6 +945,130 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Read or write some blocks on behalf of a blocking caller. The transfer is
+  split into commands which are in flight on the asynchronous I/O queue at the
+  same time, instead of being issued one after another on the synchronous I/O
+  queue.
+
+  @param  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data
+                             structure.
+  @param  Buffer             The buffer used to store the data read from or
+                             written to the device.
+  @param  Lba                The start block number.
+  @param  Blocks             Total block number to be transferred.
+  @param  MaxTransferBlocks  The maximum block number of a single command.
+  @param  IsWrite            Indicates whether it is a write operation.
+
+  @retval EFI_SUCCESS            Data are transferred.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be queued, no data has
+                                 been transferred.
+  @retval EFI_TIMEOUT            The commands did not complete in time, the
+                                 controller has been reset.
+  @retval Others                 Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeConcurrentReadWrite (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks,
+  IN     BOOLEAN                        IsWrite
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA     *Private;
+  EFI_BLOCK_IO2_TOKEN              Token;
+  EFI_EVENT                        TimerEvent;
+  EFI_STATUS                       Status;
+  EFI_TPL                          OldTpl;
+
+  Private    = Device->Controller;
+  TimerEvent = NULL;
+  ZeroMem (&Token, sizeof (EFI_BLOCK_IO2_TOKEN));
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Give every command the same time it would get on the synchronous queue.
+  //
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (
+                    TimerEvent,
+                    TimerRelative,
+                    MultU64x64 (
+                      NVME_GENERIC_TIMEOUT,
+                      DivU64x32 (Blocks + MaxTransferBlocks - 1, MaxTransferBlocks)
+                      )
+                    );
+  }
+  if (EFI_ERROR (Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Token.TransactionStatus = EFI_SUCCESS;
+  if (IsWrite) {
+    Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, &Token);
+  } else {
+    Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, &Token);
+  }
+  if (EFI_ERROR (Status)) {
+    //
+    // Nothing has been queued, let the caller fall back to the synchronous
+    // I/O queue.
+    //
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  //
+  // Reap the completions here rather than waiting for the periodic timer, so
+  // the blocking caller does not pay the timer period for every command.
+  //
+  while (EFI_ERROR (gBS->CheckEvent (Token.Event))) {
+    if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe command.\n", __FUNCTION__));
+
+      //
+      // Reset the NVMe controller to abort the outstanding commands. The
+      // subtasks refer to the token and buffer of the caller, so they are
+      // completed with error even if the controller can not be brought back.
+      //
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+      if (EFI_ERROR (NvmeControllerInit (Private))) {
+        Status = EFI_DEVICE_ERROR;
+      } else {
+        Status = EFI_TIMEOUT;
+      }
+      AbortAsyncPassThruTasks (Private);
+      gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+
+      ASSERT (!EFI_ERROR (gBS->CheckEvent (Token.Event)));
+      goto Exit;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  Status = Token.TransactionStatus;
+
+Exit:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+  gBS->CloseEvent (Token.Event);
+
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
@@ -408,4 +408,37 @@ NvmeStorageSecuritySendData (
   IN VOID                                     *PayloadBuffer
   );
 
+/**
+  Read or write some blocks on behalf of a blocking caller. The transfer is
+  split into commands which are in flight on the asynchronous I/O queue at the
+  same time, instead of being issued one after another on the synchronous I/O
+  queue.
+
+  @param  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data
+                             structure.
+  @param  Buffer             The buffer used to store the data read from or
+                             written to the device.
+  @param  Lba                The start block number.
+  @param  Blocks             Total block number to be transferred.
+  @param  MaxTransferBlocks  The maximum block number of a single command.
+  @param  IsWrite            Indicates whether it is a write operation.
+
+  @retval EFI_SUCCESS            Data are transferred.
+  @retval EFI_OUT_OF_RESOURCES   The request could not be queued, no data has
+                                 been transferred.
+  @retval EFI_TIMEOUT            The commands did not complete in time, the
+                                 controller has been reset.
+  @retval Others                 Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeConcurrentReadWrite (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks,
+  IN     BOOLEAN                        IsWrite
+  );
+
 #endif
@@ -192,11 +192,84 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Take a single page PRP list from the pool preallocated behind the queues.
+
+  @param[in]  Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[out] PrpListPhyAddr      The bus master address of the PRP list.
+
+  @return The host address of the PRP list, or NULL if the pool is exhausted.
+
+**/
+VOID *
+NvmeAllocatePrpListFromPool (
+  IN     NVME_CONTROLLER_PRIVATE_DATA *Private,
+     OUT EFI_PHYSICAL_ADDRESS         *PrpListPhyAddr
+  )
+{
+  UINTN                       Index;
+  UINTN                       Offset;
+  EFI_TPL                     OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Index = 0; Index < NVME_PRP_LIST_POOL_PAGES; Index++) {
+    if ((Private->PrpListPoolUsed & (1U << Index)) == 0) {
+      Private->PrpListPoolUsed |= (1U << Index);
+      break;
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (Index == NVME_PRP_LIST_POOL_PAGES) {
+    return NULL;
+  }
+
+  Offset          = EFI_PAGES_TO_SIZE (NVME_QUEUE_BUFFER_PAGES + Index);
+  *PrpListPhyAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Private->BufferPciAddr + Offset);
+  return Private->Buffer + Offset;
+}
+
+/**
+  Free the PRP lists created by NvmeCreatePrpList().
+
+  The caller is responsible for unmapping the PRP lists beforehand.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PrpListHost         The host base address of PRP lists.
+  @param[in]     PrpListNo           The number of PRP List.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN VOID                             *PrpListHost,
+  IN UINTN                            PrpListNo
+  )
+{
+  UINT8                       *PoolBase;
+  UINTN                       Index;
+  EFI_TPL                     OldTpl;
+
+  PoolBase = Private->Buffer + EFI_PAGES_TO_SIZE (NVME_QUEUE_BUFFER_PAGES);
+  if (((UINT8 *)PrpListHost < PoolBase) ||
+      ((UINT8 *)PrpListHost >= PoolBase + EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_PAGES))) {
+    Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+    return;
+  }
+
+  Index  = EFI_SIZE_TO_PAGES ((UINTN)((UINT8 *)PrpListHost - PoolBase));
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ASSERT ((Private->PrpListPoolUsed & (1U << Index)) != 0);
+  Private->PrpListPoolUsed &= ~(1U << Index);
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
+  A single PRP list is taken from the preallocated pool when one is available.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
@@ -208,7 +281,7 @@ NvmeDumpStatus (
 **/
 VOID*
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL          *PciIo,
+  IN     NVME_CONTROLLER_PRIVATE_DATA *Private,
   IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
   IN     UINTN                        Pages,
      OUT VOID                         **PrpListHost,
@@ -224,6 +297,11 @@ NvmeCreatePrpList (
   EFI_PHYSICAL_ADDRESS        PrpListPhyAddr;
   UINTN                       Bytes;
   EFI_STATUS                  Status;
+  EFI_PCI_IO_PROTOCOL         *PciIo;
+
+  PciIo        = Private->PciIo;
+  *PrpListHost = NULL;
+  *Mapping     = NULL;
 
   //
   // The number of Prp Entry in a memory page.
@@ -244,33 +322,46 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
+  //
+  // Transfers up to the maximum data transfer size of most controllers need
+  // a single PRP list, which is served from the pool that is already mapped
+  // as common buffer.
+  //
+  if (*PrpListNo == 1) {
+    *PrpListHost = NvmeAllocatePrpListFromPool (Private, &PrpListPhyAddr);
+  }
+
+  if (*PrpListHost == NULL) {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      *PrpListNo,
+                      PrpListHost,
+                      0
+                      );
 
-  if (EFI_ERROR (Status)) {
-    return NULL;
+    if (EFI_ERROR (Status)) {
+      return NULL;
+    }
+
+    Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      *PrpListHost,
+                      &Bytes,
+                      &PrpListPhyAddr,
+                      Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
+      DEBUG ((EFI_D_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      goto EXIT;
+    }
   }
 
   Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((EFI_D_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
-  }
   //
   // Fill all PRP lists except of last one.
   //
@@ -379,11 +470,11 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
     }
     if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+      NvmeFreePrpList (
+        Private,
+        AsyncRequest->PrpListHost,
+        AsyncRequest->PrpListNo
+        );
     }
 
     RemoveEntryList (Link);
@@ -662,7 +753,7 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES(Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES(Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -886,7 +977,7 @@ EXIT:
   }
 
   if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo);
   }
 
   if (TimerEvent != NULL) {
@@ -19,6 +19,31 @@ BOOLEAN *mDepexEvaluationStack        = NULL;
 BOOLEAN *mDepexEvaluationStackEnd     = NULL;
 BOOLEAN *mDepexEvaluationStackPointer = NULL;
 
+//
+// Reverse index from the protocols referenced by PUSH opcodes to the drivers
+// whose dependency expression references them. A driver whose dependency
+// expression evaluated to FALSE only needs to be evaluated again once one of
+// the protocols it references has been installed or uninstalled.
+//
+#define DEPEX_PROTOCOL_ENTRY_SIGNATURE  SIGNATURE_32('d','p','x','p')
+#define DEPEX_PROTOCOL_DRIVERS_INCREMENT  16
+
+typedef struct {
+  UINTN                   Signature;
+  /// Link Entry inserted to mDepexProtocolList
+  LIST_ENTRY              Link;
+  /// GUID of the protocol referenced by the dependency expressions
+  EFI_GUID                ProtocolGuid;
+  /// Protocol change count when the Drivers were last told about a change
+  UINT64                  ChangeCount;
+  /// Drivers whose dependency expression references ProtocolGuid
+  EFI_CORE_DRIVER_ENTRY   **Drivers;
+  UINTN                   DriverCount;
+  UINTN                   MaxDriverCount;
+} DEPEX_PROTOCOL_ENTRY;
+
+LIST_ENTRY  mDepexProtocolList = INITIALIZE_LIST_HEAD_VARIABLE (mDepexProtocolList);
+
 //
 // Worker functions
 //
@@ -434,3 +459,163 @@ Done:
 }
 
 
+/**
+  Add DriverEntry to the list of drivers that reference the protocol
+  ProtocolGuid in their dependency expression.
+
+  @param  ProtocolGuid          The protocol referenced by a PUSH opcode.
+  @param  DriverEntry           The driver whose Depex references ProtocolGuid.
+
+  @retval EFI_SUCCESS           DriverEntry was added to the index.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough system memory to grow the index.
+
+**/
+EFI_STATUS
+CoreAddDepexProtocolReference (
+  IN  EFI_GUID                *ProtocolGuid,
+  IN  EFI_CORE_DRIVER_ENTRY   *DriverEntry
+  )
+{
+  LIST_ENTRY              *Link;
+  DEPEX_PROTOCOL_ENTRY    *Entry;
+  EFI_CORE_DRIVER_ENTRY   **NewDrivers;
+
+  Entry = NULL;
+  for (Link = mDepexProtocolList.ForwardLink; Link != &mDepexProtocolList; Link = Link->ForwardLink) {
+    Entry = CR (Link, DEPEX_PROTOCOL_ENTRY, Link, DEPEX_PROTOCOL_ENTRY_SIGNATURE);
+    if (CompareGuid (&Entry->ProtocolGuid, ProtocolGuid)) {
+      break;
+    }
+    Entry = NULL;
+  }
+
+  if (Entry == NULL) {
+    Entry = AllocateZeroPool (sizeof (DEPEX_PROTOCOL_ENTRY));
+    if (Entry == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Entry->Signature   = DEPEX_PROTOCOL_ENTRY_SIGNATURE;
+    CopyGuid (&Entry->ProtocolGuid, ProtocolGuid);
+    Entry->ChangeCount = CoreGetProtocolChangeCount (ProtocolGuid);
+    InsertTailList (&mDepexProtocolList, &Entry->Link);
+  }
+
+  //
+  // A Depex referencing the same protocol twice only needs one reference
+  //
+  if ((Entry->DriverCount != 0) && (Entry->Drivers[Entry->DriverCount - 1] == DriverEntry)) {
+    return EFI_SUCCESS;
+  }
+
+  if (Entry->DriverCount == Entry->MaxDriverCount) {
+    NewDrivers = AllocatePool ((Entry->MaxDriverCount + DEPEX_PROTOCOL_DRIVERS_INCREMENT) * sizeof (EFI_CORE_DRIVER_ENTRY *));
+    if (NewDrivers == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    if (Entry->Drivers != NULL) {
+      CopyMem (NewDrivers, Entry->Drivers, Entry->DriverCount * sizeof (EFI_CORE_DRIVER_ENTRY *));
+      FreePool (Entry->Drivers);
+    }
+    Entry->Drivers         = NewDrivers;
+    Entry->MaxDriverCount += DEPEX_PROTOCOL_DRIVERS_INCREMENT;
+  }
+
+  Entry->Drivers[Entry->DriverCount++] = DriverEntry;
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Record the protocols referenced by the dependency expression of a driver in
+  the reverse index used by CoreUpdateDepexProtocolIndex (). This is done once
+  per driver, before its Depex is evaluated for the first time, so a protocol
+  change racing with that evaluation is never missed.
+
+  Drivers without a Depex, or with a Before or After Depex, are not indexed and
+  always have to be evaluated.
+
+  @param  DriverEntry           The driver to index.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY   *DriverEntry
+  )
+{
+  UINT8       *Iterator;
+  UINT8       *End;
+  EFI_GUID    ProtocolGuid;
+  EFI_STATUS  Status;
+
+  if (DriverEntry->DepexIndexed || (DriverEntry->Depex == NULL) ||
+      DriverEntry->Before || DriverEntry->After) {
+    return;
+  }
+
+  Iterator = DriverEntry->Depex;
+  End      = Iterator + DriverEntry->DepexSize;
+  while (Iterator < End) {
+    switch (*Iterator) {
+    case EFI_DEP_PUSH:
+    case EFI_DEP_REPLACE_TRUE:
+      if (Iterator + 1 + sizeof (EFI_GUID) > End) {
+        //
+        // A truncated Depex always evaluates to FALSE
+        //
+        Iterator = End;
+        break;
+      }
+      CopyMem (&ProtocolGuid, Iterator + 1, sizeof (EFI_GUID));
+      Status = CoreAddDepexProtocolReference (&ProtocolGuid, DriverEntry);
+      if (EFI_ERROR (Status)) {
+        return;
+      }
+      Iterator += sizeof (EFI_GUID) + 1;
+      break;
+
+    case EFI_DEP_END:
+      Iterator = End;
+      break;
+
+    default:
+      Iterator++;
+      break;
+    }
+  }
+
+  DriverEntry->DepexIndexed = TRUE;
+}
+
+
+/**
+  Check the protocols referenced by the dependency expressions of the indexed
+  drivers, and mark every driver referencing a protocol that has been installed
+  or uninstalled since the previous call as needing a new Depex evaluation.
+
+**/
+VOID
+CoreUpdateDepexProtocolIndex (
+  VOID
+  )
+{
+  LIST_ENTRY              *Link;
+  DEPEX_PROTOCOL_ENTRY    *Entry;
+  UINT64                  ChangeCount;
+  UINTN                   Index;
+
+  for (Link = mDepexProtocolList.ForwardLink; Link != &mDepexProtocolList; Link = Link->ForwardLink) {
+    Entry = CR (Link, DEPEX_PROTOCOL_ENTRY, Link, DEPEX_PROTOCOL_ENTRY_SIGNATURE);
+
+    ChangeCount = CoreGetProtocolChangeCount (&Entry->ProtocolGuid);
+    if (ChangeCount == Entry->ChangeCount) {
+      continue;
+    }
+
+    Entry->ChangeCount = ChangeCount;
+    for (Index = 0; Index < Entry->DriverCount; Index++) {
+      Entry->Drivers[Index]->DepexUpToDate = FALSE;
+    }
+  }
+}
+
+
@@ -411,6 +411,8 @@ CoreDispatcher (
   EFI_CORE_DRIVER_ENTRY           *DriverEntry;
   BOOLEAN                         ReadyToRun;
   EFI_EVENT                       DxeDispatchEvent;
+  UINTN                           DepexEvaluated;
+  UINTN                           DepexSkipped;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -542,10 +544,18 @@ CoreDispatcher (
       CoreSignalEvent (DxeDispatchEvent);
     }
 
+    //
+    // Find the drivers whose Depex references a protocol that was installed
+    // or uninstalled since the last search.
+    //
+    CoreUpdateDepexProtocolIndex ();
+
     //
     // Search DriverList for items to place on Scheduled Queue
     //
-    ReadyToRun = FALSE;
+    ReadyToRun     = FALSE;
+    DepexEvaluated = 0;
+    DepexSkipped   = 0;
     for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
       DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
 
@@ -557,9 +567,22 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        if (DriverEntry->DepexUpToDate) {
+          //
+          // The Depex evaluated to FALSE and none of the protocols it
+          // references has changed since, so it is still FALSE.
+          //
+          DepexSkipped++;
+          continue;
+        }
+
+        CoreIndexDepexProtocols (DriverEntry);
+        DepexEvaluated++;
         if (CoreIsSchedulable (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
+        } else {
+          DriverEntry->DepexUpToDate = DriverEntry->DepexIndexed;
         }
       } else {
         if (DriverEntry->Unrequested) {
@@ -569,6 +592,13 @@ CoreDispatcher (
         }
       }
     }
+
+    DEBUG ((
+      DEBUG_DISPATCH,
+      "Dispatcher pass: %u DEPEX evaluated, %u DEPEX evaluations avoided\n",
+      (UINT32) DepexEvaluated,
+      (UINT32) DepexSkipped
+      ));
   } while (ReadyToRun);
 
   //
@@ -64,6 +64,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/FvFileIndexHob.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -162,6 +163,12 @@ typedef struct {
   BOOLEAN                         Untrusted;
   BOOLEAN                         Initialized;
   BOOLEAN                         DepexProtocolError;
+  //
+  // TRUE when the last evaluation of Depex returned FALSE and none of the
+  // protocols it references has been installed or uninstalled since.
+  //
+  BOOLEAN                         DepexUpToDate;
+  BOOLEAN                         DepexIndexed;
 
   EFI_HANDLE                      ImageHandle;
   BOOLEAN                         IsFvImage;
@@ -502,6 +509,30 @@ CoreIsSchedulable (
   );
 
 
+/**
+  Record the protocols referenced by the dependency expression of a driver in
+  the reverse index used by CoreUpdateDepexProtocolIndex ().
+
+  @param  DriverEntry           The driver to index.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY   *DriverEntry
+  );
+
+
+/**
+  Mark every indexed driver referencing a protocol that has been installed or
+  uninstalled since the previous call as needing a new Depex evaluation.
+
+**/
+VOID
+CoreUpdateDepexProtocolIndex (
+  VOID
+  );
+
+
 /**
   Preprocess dependency expression and update DriverEntry to reflect the
   state of  Before, After, and SOR dependencies. If DriverEntry->Before
@@ -1138,6 +1169,39 @@ CoreGetHandleDatabaseKey (
   );
 
 
+/**
+  Return the number of times an interface of a protocol has been installed,
+  reinstalled or uninstalled.
+
+  @param  Protocol               The protocol GUID.
+
+  @return The change count of the protocol, or 0 if the protocol has never
+          been installed.
+
+**/
+UINT64
+CoreGetProtocolChangeCount (
+  IN EFI_GUID   *Protocol
+  );
+
+
+/**
+  Reports the hit and miss counts of the per-handle protocol interface cache
+  used by OpenProtocol(), HandleProtocol(), CloseProtocol() and
+  OpenProtocolInformation().
+
+  @param  Hits                   Returns the number of lookups served by the cache.
+  @param  Misses                 Returns the number of lookups that walked the
+                                 protocol list of the handle.
+
+**/
+VOID
+CoreGetProtocolInterfaceCacheStatistics (
+  OUT UINT64    *Hits,
+  OUT UINT64    *Misses
+  );
+
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -748,6 +748,14 @@ CoreExitBootServices (
 {
   EFI_STATUS                Status;
 
+  DEBUG_CODE_BEGIN ();
+    UINT64  CacheHits;
+    UINT64  CacheMisses;
+
+    CoreGetProtocolInterfaceCacheStatistics (&CacheHits, &CacheMisses);
+    DEBUG ((DEBUG_INFO, "Protocol interface cache: %ld hits, %ld misses\n", CacheHits, CacheMisses));
+  DEBUG_CODE_END ();
+
   //
   // Disable Timer
   //
@@ -10,20 +10,142 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "DxeMain.h"
 #include "Event.h"
 
+//
+// The timer database is a hashed timer wheel. Each slot of the wheel covers
+// 2^TIMER_WHEEL_SHIFT units of 100ns, and a timer is queued to the slot of its
+// trigger time, modulo the size of the wheel. Each slot is kept in ascending
+// order of trigger time, and timers with the same trigger time stay in the
+// order they were set. A bitmap of the slots holding timers lets the searches
+// skip the empty slots.
+//
+#define TIMER_WHEEL_SIZE        512
+#define TIMER_WHEEL_SHIFT       16
+
+#define TIMER_WHEEL_TIME(Time)  RShiftU64 ((Time), TIMER_WHEEL_SHIFT)
+#define TIMER_WHEEL_SLOT(WheelTime)  ((UINTN)(WheelTime) & (TIMER_WHEEL_SIZE - 1))
+
 //
 // Internal data
 //
 
-LIST_ENTRY       mEfiTimerList = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
+LIST_ENTRY       mEfiTimerWheel[TIMER_WHEEL_SIZE];
+UINT64           mEfiTimerWheelOccupied[TIMER_WHEEL_SIZE / 64];
+BOOLEAN          mEfiTimerWheelInitialized = FALSE;
+//
+// The wheel time of the first slot that may hold expired timers. No timer
+// with a trigger time before this slot is queued.
+//
+UINT64           mEfiTimerWheelCursor = 0;
 EFI_LOCK         mEfiTimerLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
 EFI_EVENT        mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK         mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64           mEfiSystemTime = 0;
+//
+// Not later than the earliest trigger time in the timer database. Protected
+// by mEfiSystemTimeLock so that CoreTimerTick() can read it.
+//
+UINT64           mEfiTimerNextTriggerTime = MAX_UINT64;
 
 //
 // Timer functions
 //
+/**
+  Initializes the slots of the timer wheel.
+
+**/
+VOID
+CoreInitializeTimerWheel (
+  VOID
+  )
+{
+  UINTN           Index;
+
+  if (mEfiTimerWheelInitialized) {
+    return;
+  }
+
+  for (Index = 0; Index < TIMER_WHEEL_SIZE; Index++) {
+    InitializeListHead (&mEfiTimerWheel[Index]);
+  }
+  mEfiTimerWheelInitialized = TRUE;
+}
+
+/**
+  Updates the trigger time CoreTimerTick() checks the system time against.
+
+  @param  TriggerTime            The earliest trigger time in the timer database
+
+**/
+VOID
+CoreSetNextTimerTriggerTime (
+  IN UINT64   TriggerTime
+  )
+{
+  CoreAcquireLock (&mEfiSystemTimeLock);
+  mEfiTimerNextTriggerTime = TriggerTime;
+  CoreReleaseLock (&mEfiSystemTimeLock);
+}
+
+/**
+  Finds the first slot of the timer wheel holding timers, in wheel order from
+  a given slot.
+
+  @param  Start                  The slot to start from
+
+  @return The number of slots from Start to the first slot holding timers, or
+          TIMER_WHEEL_SIZE if no timer is queued
+
+**/
+UINTN
+CoreNextOccupiedTimerSlot (
+  IN UINTN    Start
+  )
+{
+  UINTN           Distance;
+  UINTN           Slot;
+  UINT64          Bits;
+
+  for (Distance = 0; Distance < TIMER_WHEEL_SIZE; Distance += 64 - Slot % 64) {
+    Slot = TIMER_WHEEL_SLOT (Start + Distance);
+    Bits = RShiftU64 (mEfiTimerWheelOccupied[Slot / 64], Slot % 64);
+    if (Bits != 0) {
+      return Distance + (UINTN)LowBitSet64 (Bits);
+    }
+  }
+
+  return TIMER_WHEEL_SIZE;
+}
+
+/**
+  Removes the timer event from the timer wheel.
+
+  @param  Event                  The timer event to remove
+
+**/
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT   *Event
+  )
+{
+  UINTN           Slot;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  //
+  // If the timer is the only one of its slot, both its links point to the
+  // head of the slot, which then becomes empty
+  //
+  if (Event->Timer.Link.ForwardLink == Event->Timer.Link.BackLink) {
+    Slot = (UINTN)(Event->Timer.Link.ForwardLink - mEfiTimerWheel);
+    ASSERT (Slot < TIMER_WHEEL_SIZE);
+    mEfiTimerWheelOccupied[Slot / 64] &= ~LShiftU64 (1, Slot % 64);
+  }
+
+  RemoveEntryList (&Event->Timer.Link);
+  Event->Timer.Link.ForwardLink = NULL;
+}
+
 /**
   Inserts the timer event.
 
@@ -37,28 +159,157 @@ CoreInsertEventTimer (
   )
 {
   UINT64          TriggerTime;
+  UINT64          WheelTime;
+  LIST_ENTRY      *Slot;
   LIST_ENTRY      *Link;
   IEVENT          *Event2;
 
   ASSERT_LOCKED (&mEfiTimerLock);
 
+  CoreInitializeTimerWheel ();
+
   //
   // Get the timer's trigger time
   //
   TriggerTime = Event->Timer.TriggerTime;
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // A trigger time before the cursor can only come from a relative time that
+  // overflowed. Queue it to the slot of the cursor, where it is found as
+  // expired on the next check like it was in a sorted list.
+  //
+  WheelTime = TIMER_WHEEL_TIME (TriggerTime);
+  if (WheelTime < mEfiTimerWheelCursor) {
+    WheelTime = mEfiTimerWheelCursor;
+  }
+
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
+  // Insert the timer into its slot in assending sorted order. Timers are
+  // mostly set to expire after the ones already queued, so search from the end.
+  //
+  Slot = &mEfiTimerWheel[TIMER_WHEEL_SLOT (WheelTime)];
+  mEfiTimerWheelOccupied[TIMER_WHEEL_SLOT (WheelTime) / 64] |= LShiftU64 (1, TIMER_WHEEL_SLOT (WheelTime) % 64);
+  for (Link = Slot->BackLink; Link != Slot; Link = Link->BackLink) {
     Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
+    if (Event2->Timer.TriggerTime <= TriggerTime) {
+      break;
+    }
+  }
+
+  InsertHeadList (Link, &Event->Timer.Link);
+
+  if (TriggerTime < mEfiTimerNextTriggerTime) {
+    CoreSetNextTimerTriggerTime (TriggerTime);
+  }
+}
+
+/**
+  Finds the timer with the earliest trigger time.
+
+  @return The earliest timer, or NULL if no timer is set
+
+**/
+IEVENT *
+CoreEarliestTimer (
+  VOID
+  )
+{
+  UINTN           Index;
+  UINT64          WheelTime;
+  IEVENT          *Event;
+  IEVENT          *Earliest;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  //
+  // Look at the slots holding timers in time order from the cursor, and keep
+  // the earliest of their first timers. Once the first timer of a slot belongs
+  // to the current turn of the wheel, no later slot holds an earlier timer.
+  //
+  Earliest = NULL;
+  for (Index = CoreNextOccupiedTimerSlot (TIMER_WHEEL_SLOT (mEfiTimerWheelCursor));
+       Index < TIMER_WHEEL_SIZE;
+       Index += 1 + CoreNextOccupiedTimerSlot (TIMER_WHEEL_SLOT (mEfiTimerWheelCursor + Index + 1))) {
+    WheelTime = mEfiTimerWheelCursor + Index;
+    Event     = CR (mEfiTimerWheel[TIMER_WHEEL_SLOT (WheelTime)].ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+    if ((Earliest == NULL) || (Event->Timer.TriggerTime < Earliest->Timer.TriggerTime)) {
+      Earliest = Event;
+    }
+    if (TIMER_WHEEL_TIME (Event->Timer.TriggerTime) == WheelTime) {
+      break;
+    }
+  }
+
+  return Earliest;
+}
+
+/**
+  Finds the expired timer with the earliest trigger time, and advances the
+  cursor of the timer wheel over the slots with no expired timers.
+
+  @param  SystemTime             The current system time
+
+  @return The earliest expired timer, or NULL if no timer has expired
+
+**/
+IEVENT *
+CoreFindExpiredTimer (
+  IN UINT64   SystemTime
+  )
+{
+  UINT64          Now;
+  UINTN           Distance;
+  IEVENT          *Event;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  Now = TIMER_WHEEL_TIME (SystemTime);
+
+  if (Now - mEfiTimerWheelCursor >= TIMER_WHEEL_SIZE) {
+    //
+    // The timers were not checked for a whole turn of the wheel, so expired
+    // timers may be in any slot. No timer is queued before the earliest one,
+    // so the cursor can move up to it.
+    //
+    Event = CoreEarliestTimer ();
+    if ((Event == NULL) || (Event->Timer.TriggerTime > SystemTime)) {
+      mEfiTimerWheelCursor = Now;
+      return NULL;
+    }
+
+    if (TIMER_WHEEL_TIME (Event->Timer.TriggerTime) > mEfiTimerWheelCursor) {
+      mEfiTimerWheelCursor = TIMER_WHEEL_TIME (Event->Timer.TriggerTime);
+    }
+    if (Now - mEfiTimerWheelCursor >= TIMER_WHEEL_SIZE) {
+      return Event;
+    }
+  }
+
+  //
+  // Walk the slots holding timers up to the current time. The first timer of
+  // a slot can only be expired if it belongs to the current turn of the wheel.
+  //
+  while (TRUE) {
+    Distance = CoreNextOccupiedTimerSlot (TIMER_WHEEL_SLOT (mEfiTimerWheelCursor));
+    if (Distance > (UINTN)(Now - mEfiTimerWheelCursor)) {
+      mEfiTimerWheelCursor = Now;
+      break;
+    }
+
+    mEfiTimerWheelCursor += Distance;
+    Event = CR (mEfiTimerWheel[TIMER_WHEEL_SLOT (mEfiTimerWheelCursor)].ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+    if (Event->Timer.TriggerTime <= SystemTime) {
+      return Event;
+    }
+
+    if (mEfiTimerWheelCursor == Now) {
       break;
     }
+    mEfiTimerWheelCursor++;
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  return NULL;
 }
 
 /**
@@ -82,8 +333,8 @@ CoreCurrentSystemTime (
 }
 
 /**
-  Checks the sorted timer list against the current system time.
-  Signals any expired event timer.
+  Checks the timer wheel against the current system time.
+  Signals any expired event timer, in trigger time order.
 
   @param  CheckEvent             Not used
   @param  Context                Not used
@@ -105,13 +356,15 @@ CoreCheckTimers (
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  CoreInitializeTimerWheel ();
+
+  while (TRUE) {
+    Event = CoreFindExpiredTimer (SystemTime);
 
     //
-    // If this timer is not expired, then we're done
+    // If no timer is expired, then we're done
     //
-    if (Event->Timer.TriggerTime > SystemTime) {
+    if (Event == NULL) {
       break;
     }
 
@@ -119,8 +372,7 @@ CoreCheckTimers (
     // Remove this timer from the timer queue
     //
 
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
 
     //
     // Signal it
@@ -151,6 +403,9 @@ CoreCheckTimers (
     }
   }
 
+  Event = CoreEarliestTimer ();
+  CoreSetNextTimerTriggerTime ((Event == NULL) ? MAX_UINT64 : Event->Timer.TriggerTime);
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -166,6 +421,8 @@ CoreInitializeTimer (
 {
   EFI_STATUS  Status;
 
+  CoreInitializeTimerWheel ();
+
   Status = CoreCreateEventInternal (
              EVT_NOTIFY_SIGNAL,
              TPL_HIGH_LEVEL - 1,
@@ -191,8 +448,6 @@ CoreTimerTick (
   IN UINT64   Duration
   )
 {
-  IEVENT          *Event;
-
   //
   // Check runtiem flag in case there are ticks while exiting boot services
   //
@@ -204,15 +459,11 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the earliest timer is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
-      CoreSignalEvent (mEfiCheckTimerEvent);
-    }
+  if (mEfiTimerNextTriggerTime <= mEfiSystemTime) {
+    CoreSignalEvent (mEfiCheckTimerEvent);
   }
 
   CoreReleaseLock (&mEfiSystemTimeLock);
@@ -262,11 +513,12 @@ CoreSetTimer (
   CoreAcquireLock (&mEfiTimerLock);
 
   //
-  // If the timer is queued to the timer database, remove it
+  // If the timer is queued to the timer database, remove it. The trigger
+  // time CoreTimerTick() checks may then be early, which only causes an
+  // extra check of the timers.
   //
   if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -299,6 +299,128 @@ FreeFvDeviceResource (
 
 
 
+/**
+  Build the FFS file list of a memory mapped FV from the file index HOB
+  published by the PEI Core, without walking the FFS file headers.
+
+  @param  FvDevice              A pointer to the FvDevice whose file list is built.
+
+  @retval EFI_SUCCESS           The file list was built from the file index.
+  @retval EFI_NOT_FOUND         There is no usable file index for the FV, the
+                                FV has to be walked.
+  @retval EFI_OUT_OF_RESOURCES  No enough buffer could be allocated.
+  @retval EFI_VOLUME_CORRUPTED  File system is corrupted.
+
+**/
+EFI_STATUS
+FvBuildFileListFromIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER            *FwVolHeader;
+  EFI_HOB_GUID_TYPE                     *GuidHob;
+  EDKII_FV_FILE_INDEX                   *FvFileIndex;
+  EDKII_FV_FILE_INDEX_ENTRY             *Entries;
+  FFS_FILE_LIST_ENTRY                   *FfsFileEntry;
+  EFI_FFS_FILE_HEADER                   *FfsHeader;
+  BOOLEAN                               FileCached;
+  UINTN                                 Index;
+
+  if (!FvDevice->IsMemoryMapped) {
+    return EFI_NOT_FOUND;
+  }
+
+  FwVolHeader = FvDevice->FwVolHeader;
+  FvFileIndex = NULL;
+  for (GuidHob = GetFirstGuidHob (&gEdkiiFvFileIndexHobGuid);
+       GuidHob != NULL;
+       GuidHob = GetNextGuidHob (&gEdkiiFvFileIndexHobGuid, GET_NEXT_HOB (GuidHob))) {
+    FvFileIndex = GET_GUID_HOB_DATA (GuidHob);
+    if ((GET_GUID_HOB_DATA_SIZE (GuidHob) >= sizeof (EDKII_FV_FILE_INDEX)) &&
+        (FvFileIndex->FvBase == (EFI_PHYSICAL_ADDRESS) (UINTN) FvDevice->CachedFv) &&
+        (FvFileIndex->FvLength == FwVolHeader->FvLength) &&
+        (FvFileIndex->FvChecksum == FwVolHeader->Checksum) &&
+        (GET_GUID_HOB_DATA_SIZE (GuidHob) >= sizeof (EDKII_FV_FILE_INDEX) + FvFileIndex->FileCount * sizeof (EDKII_FV_FILE_INDEX_ENTRY))) {
+      break;
+    }
+    FvFileIndex = NULL;
+  }
+
+  if (FvFileIndex == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Make sure every file lies within the FV, and that the name and size of
+  // the FFS file header found at its offset match, before trusting the index.
+  // Otherwise the FV is walked as if there was no index.
+  //
+  Entries = (EDKII_FV_FILE_INDEX_ENTRY *) (FvFileIndex + 1);
+  for (Index = 0; Index < FvFileIndex->FileCount; Index++) {
+    if ((Entries[Index].Offset < FwVolHeader->HeaderLength) ||
+        (Entries[Index].Size < sizeof (EFI_FFS_FILE_HEADER)) ||
+        ((UINT64) Entries[Index].Offset + Entries[Index].Size > FwVolHeader->FvLength)) {
+      break;
+    }
+
+    FfsHeader = (EFI_FFS_FILE_HEADER *) (FvDevice->CachedFv + Entries[Index].Offset);
+    if (!CompareGuid (&FfsHeader->Name, &Entries[Index].Name)) {
+      break;
+    }
+
+    if (IS_FFS_FILE2 (FfsHeader)) {
+      if ((Entries[Index].Size < sizeof (EFI_FFS_FILE_HEADER2)) ||
+          (FFS_FILE2_SIZE (FfsHeader) != Entries[Index].Size)) {
+        break;
+      }
+    } else if (FFS_FILE_SIZE (FfsHeader) != Entries[Index].Size) {
+      break;
+    }
+  }
+
+  if (Index < FvFileIndex->FileCount) {
+    DEBUG ((DEBUG_ERROR, "Ignoring invalid file index of FV at 0x%lx\n", FvFileIndex->FvBase));
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < FvFileIndex->FileCount; Index++) {
+    FfsHeader  = (EFI_FFS_FILE_HEADER *) (FvDevice->CachedFv + Entries[Index].Offset);
+    FileCached = FALSE;
+
+    if ((Entries[Index].Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+      //
+      // The PEI Core does not verify the data checksum, cache the file and
+      // verify it here as FvCheck () does.
+      //
+      FfsHeader = AllocateCopyPool (Entries[Index].Size, FfsHeader);
+      if (FfsHeader == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      if (!IsValidFfsFile (FvDevice->ErasePolarity, FfsHeader)) {
+        CoreFreePool (FfsHeader);
+        return EFI_VOLUME_CORRUPTED;
+      }
+      FileCached = TRUE;
+    }
+
+    FfsFileEntry = AllocateZeroPool (sizeof (FFS_FILE_LIST_ENTRY));
+    if (FfsFileEntry == NULL) {
+      if (FileCached) {
+        CoreFreePool (FfsHeader);
+      }
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    FfsFileEntry->FfsHeader = FfsHeader;
+    FfsFileEntry->FileCached = FileCached;
+    InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
+  }
+
+  DEBUG ((DEBUG_INFO, "FV at 0x%lx: %d files from the file index\n", FvFileIndex->FvBase, FvFileIndex->FileCount));
+  return EFI_SUCCESS;
+}
+
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -425,6 +547,15 @@ FvCheck (
   Status = EFI_SUCCESS;
   InitializeListHead (&FvDevice->FfsFileListHeader);
 
+  //
+  // Use the file list handed over by the PEI Core if there is one for this FV
+  //
+  Status = FvBuildFileListFromIndex (FvDevice);
+  if (Status != EFI_NOT_FOUND) {
+    goto Done;
+  }
+  Status = EFI_SUCCESS;
+
   //
   // Build FFS list
   //
@@ -11,16 +11,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// Number of buckets in the protocol GUID hash table. Must be a power of 2.
+//
+#define PROTOCOL_HASH_TABLE_SIZE  256
+
+//
+// mProtocolDatabase     - A list of all protocols in the system.
+// mProtocolHashTable    - The protocols in mProtocolDatabase, bucketed by GUID hash
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
 LIST_ENTRY      mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY      mProtocolHashTable[PROTOCOL_HASH_TABLE_SIZE];
+BOOLEAN         mProtocolHashTableInitialized = FALSE;
 LIST_ENTRY      gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK        gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64          gHandleDatabaseKey    = 0;
 
+//
+// Hit and miss counters of the per-handle protocol interface cache
+//
+UINT64          mProtocolCacheHits    = 0;
+UINT64          mProtocolCacheMisses  = 0;
+
 
 
 /**
@@ -84,6 +98,38 @@ CoreValidateHandle (
 
 
 
+/**
+  Computes the bucket index of a protocol GUID in mProtocolHashTable.
+
+  @param  Protocol               The ID of the protocol
+
+  @return Index of the hash bucket for Protocol
+
+**/
+UINTN
+CoreProtocolHash (
+  IN EFI_GUID   *Protocol
+  )
+{
+  UINT32              Hash;
+
+  //
+  // GUIDs are already well distributed, so folding the four 32-bit words
+  // together is enough to spread them over the buckets. The GUID may not
+  // be naturally aligned (e.g. when it comes from a DEPEX expression).
+  //
+  Hash = ReadUnaligned32 ((UINT32 *)Protocol) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 1) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 2) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return (UINTN)(Hash & (PROTOCOL_HASH_TABLE_SIZE - 1));
+}
+
+
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -100,22 +146,32 @@ CoreFindProtocolEntry (
   IN BOOLEAN    Create
   )
 {
+  LIST_ENTRY          *Bucket;
   LIST_ENTRY          *Link;
   PROTOCOL_ENTRY      *Item;
   PROTOCOL_ENTRY      *ProtEntry;
+  UINTN               Index;
 
   ASSERT_LOCKED(&gProtocolDatabaseLock);
 
+  if (!mProtocolHashTableInitialized) {
+    for (Index = 0; Index < PROTOCOL_HASH_TABLE_SIZE; Index++) {
+      InitializeListHead (&mProtocolHashTable[Index]);
+    }
+    mProtocolHashTableInitialized = TRUE;
+  }
+
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the GUID for the matching entry
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = &mProtocolHashTable[CoreProtocolHash (Protocol)];
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink) {
 
-    Item = CR(Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR(Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
 
       //
@@ -142,11 +198,13 @@ CoreFindProtocolEntry (
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
+      ProtEntry->ChangeCount = 0;
 
       //
-      // Add it to protocol database
+      // Add it to protocol database and to the hash bucket of its GUID
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -465,6 +523,7 @@ CoreInstallProtocolInterfaceNotify (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  ProtEntry->ChangeCount++;
 
   //
   // Notify the notification list for this protocol
@@ -774,6 +833,7 @@ CoreUninstallProtocolInterface (
     // Remove the protocol interface from the handle
     //
     RemoveEntryList (&Prot->Link);
+    CoreInvalidateProtocolInterfaceCache (Handle, Prot);
 
     //
     // Free the memory
@@ -898,6 +958,7 @@ CoreGetProtocolInterface (
   PROTOCOL_INTERFACE  *Prot;
   IHANDLE             *Handle;
   LIST_ENTRY          *Link;
+  UINTN               Index;
 
   Status = CoreValidateHandle (UserHandle);
   if (EFI_ERROR (Status)) {
@@ -906,6 +967,20 @@ CoreGetProtocolInterface (
 
   Handle = (IHANDLE *)UserHandle;
 
+  //
+  // Check the protocol interfaces most recently located on this handle.
+  // A protocol can only be installed once per handle, so a cached interface
+  // with a matching GUID is the one the list walk below would find.
+  //
+  for (Index = 0; Index < PROTOCOL_INTERFACE_CACHE_SIZE; Index++) {
+    Prot = Handle->ProtocolCache[Index];
+    if ((Prot != NULL) && CompareGuid (&Prot->Protocol->ProtocolID, Protocol)) {
+      mProtocolCacheHits++;
+      return Prot;
+    }
+  }
+  mProtocolCacheMisses++;
+
   //
   // Look at each protocol interface for a match
   //
@@ -913,6 +988,11 @@ CoreGetProtocolInterface (
     Prot = CR(Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
     ProtEntry = Prot->Protocol;
     if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+      //
+      // Replace the oldest entry of the cache with this interface
+      //
+      Handle->ProtocolCache[Handle->ProtocolCacheNext] = Prot;
+      Handle->ProtocolCacheNext = (Handle->ProtocolCacheNext + 1) % PROTOCOL_INTERFACE_CACHE_SIZE;
       return Prot;
     }
   }
@@ -921,6 +1001,55 @@ CoreGetProtocolInterface (
 
 
 
+/**
+  Removes a protocol interface from the protocol interface cache of a handle.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle whose cache is updated
+  @param  Prot                   The protocol interface to invalidate
+
+**/
+VOID
+CoreInvalidateProtocolInterfaceCache (
+  IN IHANDLE              *Handle,
+  IN PROTOCOL_INTERFACE   *Prot
+  )
+{
+  UINTN               Index;
+
+  ASSERT_LOCKED(&gProtocolDatabaseLock);
+
+  for (Index = 0; Index < PROTOCOL_INTERFACE_CACHE_SIZE; Index++) {
+    if (Handle->ProtocolCache[Index] == Prot) {
+      Handle->ProtocolCache[Index] = NULL;
+    }
+  }
+}
+
+
+
+/**
+  Reports the hit and miss counts of the per-handle protocol interface cache
+  used by OpenProtocol(), HandleProtocol(), CloseProtocol() and
+  OpenProtocolInformation().
+
+  @param  Hits                   Returns the number of lookups served by the cache.
+  @param  Misses                 Returns the number of lookups that walked the
+                                 protocol list of the handle.
+
+**/
+VOID
+CoreGetProtocolInterfaceCacheStatistics (
+  OUT UINT64    *Hits,
+  OUT UINT64    *Misses
+  )
+{
+  *Hits   = mProtocolCacheHits;
+  *Misses = mProtocolCacheMisses;
+}
+
+
+
 /**
   Queries a handle to determine if it supports a specified protocol.
 
@@ -1516,6 +1645,42 @@ CoreGetHandleDatabaseKey (
 }
 
 
+/**
+  Return the number of times an interface of a protocol has been installed,
+  reinstalled or uninstalled.
+
+  The value only changes when the result of LocateProtocol() for the protocol
+  may have changed, so callers can cache the outcome of a lookup and only
+  repeat it once the value moves.
+
+  @param  Protocol               The protocol GUID.
+
+  @return The change count of the protocol, or 0 if the protocol has never
+          been installed.
+
+**/
+UINT64
+CoreGetProtocolChangeCount (
+  IN EFI_GUID   *Protocol
+  )
+{
+  PROTOCOL_ENTRY  *ProtEntry;
+  UINT64          ChangeCount;
+
+  CoreAcquireProtocolLock ();
+
+  ChangeCount = 0;
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry != NULL) {
+    ChangeCount = ProtEntry->ChangeCount;
+  }
+
+  CoreReleaseProtocolLock ();
+
+  return ChangeCount;
+}
+
+
 
 /**
   Go connect any handles that were created or modified while a image executed.
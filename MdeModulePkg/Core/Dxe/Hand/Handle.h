@@ -12,6 +12,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define EFI_HANDLE_SIGNATURE            SIGNATURE_32('h','n','d','l')
 
+///
+/// Number of recently located protocol interfaces cached per handle
+///
+#define PROTOCOL_INTERFACE_CACHE_SIZE   4
+
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
@@ -24,6 +29,10 @@ typedef struct {
   UINTN               LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
   UINT64              Key;
+  /// Recently located PROTOCOL_INTERFACE's on this handle, used by CoreGetProtocolInterface
+  VOID                *ProtocolCache[PROTOCOL_INTERFACE_CACHE_SIZE];
+  /// Next ProtocolCache slot to be replaced
+  UINTN               ProtocolCacheNext;
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -39,12 +48,16 @@ typedef struct {
   UINTN               Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY          AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket of ProtocolID
+  LIST_ENTRY          HashLink;
   /// ID of the protocol
   EFI_GUID            ProtocolID;
   /// All protocol interfaces
   LIST_ENTRY          Protocols;
   /// Registerd notification handlers
   LIST_ENTRY          Notify;
+  /// Number of times an interface of this protocol was installed or removed
+  UINT64              ChangeCount;
 } PROTOCOL_ENTRY;
 
 
@@ -153,6 +166,21 @@ CoreFindProtocolInterface (
   );
 
 
+/**
+  Removes a protocol interface from the protocol interface cache of a handle.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle whose cache is updated
+  @param  Prot                   The protocol interface to invalidate
+
+**/
+VOID
+CoreInvalidateProtocolInterfaceCache (
+  IN IHANDLE              *Handle,
+  IN PROTOCOL_INTERFACE   *Prot
+  );
+
+
 /**
   Removes Protocol from the protocol list (but not the handle list).
 
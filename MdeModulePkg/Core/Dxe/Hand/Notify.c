@@ -79,6 +79,7 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+    ProtEntry->ChangeCount++;
   }
 
   return Prot;
@@ -239,6 +240,11 @@ CoreReinstallProtocolInterface (
 
   ProtEntry = Prot->Protocol;
 
+  //
+  // Drop the stale interface from the lookup cache of the handle
+  //
+  CoreInvalidateProtocolInterfaceCache (Handle, Prot);
+
   //
   // Update the interface on the protocol
   //
@@ -249,6 +255,7 @@ CoreReinstallProtocolInterface (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  ProtEntry->ChangeCount++;
 
   //
   // Update the Key to show that the handle has been created/modified
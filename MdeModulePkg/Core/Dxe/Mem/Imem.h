@@ -33,6 +33,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct {
   UINTN           Signature;
   LIST_ENTRY      Link;
+  //
+  // Link in the mFreeMemoryMapIndex size class of an EfiConventionalMemory
+  // entry. ForwardLink is NULL while the entry is not indexed.
+  //
+  LIST_ENTRY      FreeLink;
   BOOLEAN         FromPages;
 
   EFI_MEMORY_TYPE Type;
@@ -172,6 +177,21 @@ CoreInternalAllocatePages (
   IN BOOLEAN                NeedGuard
   );
 
+/**
+  Get the pool slab occupancy of all memory types.
+
+  @param  SlabSizeByType         Receives the size of the slab pages of each
+                                 memory profile memory type index
+  @param  SlabUsageByType        Receives the size of the slab blocks in use
+                                 of each memory profile memory type index
+
+**/
+VOID
+CoreGetPoolSlabUsage (
+  OUT UINT64                *SlabSizeByType,
+  OUT UINT64                *SlabUsageByType
+  );
+
 //
 // Internal Global data
 //
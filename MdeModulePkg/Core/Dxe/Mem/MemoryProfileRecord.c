@@ -1455,6 +1455,8 @@ MemoryProfileGetDataSize (
     }
   }
 
+  TotalSize += sizeof (MEMORY_PROFILE_POOL_SLAB);
+
   return TotalSize;
 }
 
@@ -1472,6 +1474,7 @@ MemoryProfileCopyData (
   MEMORY_PROFILE_CONTEXT            *Context;
   MEMORY_PROFILE_DRIVER_INFO        *DriverInfo;
   MEMORY_PROFILE_ALLOC_INFO         *AllocInfo;
+  MEMORY_PROFILE_POOL_SLAB          *PoolSlab;
   MEMORY_PROFILE_CONTEXT_DATA       *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA   *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA    *AllocInfoData;
@@ -1528,6 +1531,12 @@ MemoryProfileCopyData (
 
     DriverInfo = (MEMORY_PROFILE_DRIVER_INFO *)  AllocInfo;
   }
+
+  PoolSlab = (MEMORY_PROFILE_POOL_SLAB *) DriverInfo;
+  PoolSlab->Header.Signature = MEMORY_PROFILE_POOL_SLAB_SIGNATURE;
+  PoolSlab->Header.Length    = sizeof (MEMORY_PROFILE_POOL_SLAB);
+  PoolSlab->Header.Revision  = MEMORY_PROFILE_POOL_SLAB_REVISION;
+  CoreGetPoolSlabUsage (PoolSlab->SlabSizeByType, PoolSlab->SlabUsageByType);
 }
 
 /**
@@ -45,6 +45,16 @@ UINTN         mFreeMapStack = 0;
 LIST_ENTRY   mFreeMemoryMapEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN      mMemoryTypeInformationInitialized = FALSE;
 
+#define FREE_MEMORY_INDEX_SIZE  64
+
+///
+/// mFreeMemoryMapIndex - the EfiConventionalMemory entries of gMemoryMap,
+/// segregated by size. Entry N holds the descriptors whose page count has
+/// its highest bit set at bit N.
+///
+LIST_ENTRY   mFreeMemoryMapIndex[FREE_MEMORY_INDEX_SIZE];
+BOOLEAN      mFreeMemoryMapIndexInitialized = FALSE;
+
 EFI_MEMORY_TYPE_STATISTICS mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiLoaderCode
@@ -121,6 +131,53 @@ CoreReleaseMemoryLock (
 
 
 
+/**
+  Internal function.  Removes a descriptor entry from the free memory index.
+
+  @param  Entry                  The entry to remove from the index
+
+**/
+VOID
+UnindexFreeMemoryMapEntry (
+  IN OUT MEMORY_MAP      *Entry
+  )
+{
+  if (Entry->FreeLink.ForwardLink != NULL) {
+    RemoveEntryList (&Entry->FreeLink);
+    Entry->FreeLink.ForwardLink = NULL;
+  }
+}
+
+/**
+  Internal function.  Files a descriptor entry in the size class of the free
+  memory index matching its current range. Entries that do not describe
+  EfiConventionalMemory are removed from the index.
+
+  @param  Entry                  The entry to index
+
+**/
+VOID
+IndexFreeMemoryMapEntry (
+  IN OUT MEMORY_MAP      *Entry
+  )
+{
+  UINTN                  Index;
+
+  if (!mFreeMemoryMapIndexInitialized) {
+    for (Index = 0; Index < FREE_MEMORY_INDEX_SIZE; Index++) {
+      InitializeListHead (&mFreeMemoryMapIndex[Index]);
+    }
+    mFreeMemoryMapIndexInitialized = TRUE;
+  }
+
+  UnindexFreeMemoryMapEntry (Entry);
+
+  if (Entry->Type == EfiConventionalMemory && Entry->End > Entry->Start) {
+    Index = (UINTN)HighBitSet64 (RShiftU64 (Entry->End - Entry->Start + 1, EFI_PAGE_SHIFT));
+    InsertTailList (&mFreeMemoryMapIndex[Index], &Entry->FreeLink);
+  }
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -132,6 +189,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP      *Entry
   )
 {
+  UnindexFreeMemoryMapEntry (Entry);
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -248,7 +306,9 @@ CoreAddRange (
   mMapStack[mMapDepth].End           = End;
   mMapStack[mMapDepth].VirtualStart  = 0;
   mMapStack[mMapDepth].Attribute     = Attribute;
+  mMapStack[mMapDepth].FreeLink.ForwardLink = NULL;
   InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  IndexFreeMemoryMapEntry (&mMapStack[mMapDepth]);
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -358,6 +418,7 @@ CoreFreeMemoryMapStack (
       //
       RemoveEntryList (&mMapStack[mMapDepth].Link);
       mMapStack[mMapDepth].Link.ForwardLink = NULL;
+      UnindexFreeMemoryMapEntry (&mMapStack[mMapDepth]);
 
       CopyMem (Entry , &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
@@ -373,6 +434,7 @@ CoreFreeMemoryMapStack (
       }
 
       InsertTailList (Link2, &Entry->Link);
+      IndexFreeMemoryMapEntry (Entry);
 
     } else {
       //
@@ -852,6 +914,7 @@ CoreConvertPagesEx (
       // Clip start
       //
       Entry->Start = RangeEnd + 1;
+      IndexFreeMemoryMapEntry (Entry);
 
     } else if (Entry->End == RangeEnd) {
 
@@ -859,6 +922,7 @@ CoreConvertPagesEx (
       // Clip end
       //
       Entry->End = Start - 1;
+      IndexFreeMemoryMapEntry (Entry);
 
     } else {
 
@@ -879,12 +943,15 @@ CoreConvertPagesEx (
       // Inherit Attribute from the Memory Descriptor that is being clipped
       //
       mMapStack[mMapDepth].Attribute = Entry->Attribute;
+      mMapStack[mMapDepth].FreeLink.ForwardLink = NULL;
 
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      IndexFreeMemoryMapEntry (Entry);
 
       Entry = &mMapStack[mMapDepth];
       InsertTailList (&gMemoryMap, &Entry->Link);
+      IndexFreeMemoryMapEntry (Entry);
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1008,6 +1075,101 @@ CoreUpdateMemoryAttributes (
 }
 
 
+/**
+  Internal function.  Checks whether a free descriptor can hold a range below
+  MaxAddress and above MinAddress, and whether it ends higher than the best
+  range found so far.
+
+  @param  Entry                  The EfiConventionalMemory descriptor to check
+  @param  MaxAddress             The address that the range must be below,
+                                 already set to the end of a page
+  @param  MinAddress             The address that the range must be above
+  @param  NumberOfBytes          Number of bytes needed
+  @param  Alignment              Bits to align with
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+  @param  Target                 The end of the best range found so far, or 0
+
+  @return The end of the range in Entry if it is the best one so far,
+          Target otherwise.
+
+**/
+STATIC
+UINT64
+CoreFindFreePagesInEntry (
+  IN MEMORY_MAP       *Entry,
+  IN UINT64           MaxAddress,
+  IN UINT64           MinAddress,
+  IN UINT64           NumberOfBytes,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard,
+  IN UINT64           Target
+  )
+{
+  UINT64          DescStart;
+  UINT64          DescEnd;
+  UINT64          DescNumberOfBytes;
+
+  DescStart = Entry->Start;
+  DescEnd = Entry->End;
+
+  //
+  // If desc is past max allowed address or below min allowed address, skip it
+  //
+  if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
+    return Target;
+  }
+
+  //
+  // If desc ends past max allowed address, clip the end
+  //
+  if (DescEnd >= MaxAddress) {
+    DescEnd = MaxAddress;
+  }
+
+  DescEnd = ((DescEnd + 1) & (~(Alignment - 1))) - 1;
+
+  // Skip if DescEnd is less than DescStart after alignment clipping
+  if (DescEnd < DescStart) {
+    return Target;
+  }
+
+  //
+  // Compute the number of bytes we can used from this
+  // descriptor, and see it's enough to satisfy the request
+  //
+  DescNumberOfBytes = DescEnd - DescStart + 1;
+
+  if (DescNumberOfBytes >= NumberOfBytes) {
+    //
+    // If the start of the allocated range is below the min address allowed, skip it
+    //
+    if ((DescEnd - NumberOfBytes + 1) < MinAddress) {
+      return Target;
+    }
+
+    //
+    // If this is the best match so far remember it
+    //
+    if (DescEnd > Target) {
+      if (NeedGuard) {
+        DescEnd = AdjustMemoryS (
+                    DescEnd + 1 - DescNumberOfBytes,
+                    DescNumberOfBytes,
+                    NumberOfBytes
+                    );
+        if (DescEnd == 0) {
+          return Target;
+        }
+      }
+
+      return DescEnd;
+    }
+  }
+
+  return Target;
+}
+
+
 /**
   Internal function. Finds a consecutive free page range below
   the requested address.
@@ -1035,16 +1197,18 @@ CoreFindFreePagesI (
 {
   UINT64          NumberOfBytes;
   UINT64          Target;
-  UINT64          DescStart;
-  UINT64          DescEnd;
-  UINT64          DescNumberOfBytes;
   LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
+  UINTN           Index;
 
   if ((MaxAddress < EFI_PAGE_MASK) ||(NumberOfPages == 0)) {
     return 0;
   }
 
+  if (!mFreeMemoryMapIndexInitialized) {
+    return 0;
+  }
+
   if ((MaxAddress & EFI_PAGE_MASK) != EFI_PAGE_MASK) {
 
     //
@@ -1070,70 +1234,37 @@ CoreFindFreePagesI (
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target = 0;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
-
-    DescStart = Entry->Start;
-    DescEnd = Entry->End;
-
-    //
-    // If desc is past max allowed address or below min allowed address, skip it
-    //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
-    }
-
-    //
-    // If desc ends past max allowed address, clip the end
-    //
-    if (DescEnd >= MaxAddress) {
-      DescEnd = MaxAddress;
-    }
-
-    DescEnd = ((DescEnd + 1) & (~(Alignment - 1))) - 1;
-
-    // Skip if DescEnd is less than DescStart after alignment clipping
-    if (DescEnd < DescStart) {
-      continue;
-    }
-
+  if (NeedGuard) {
     //
-    // Compute the number of bytes we can used from this
-    // descriptor, and see it's enough to satisfy the request
+    // AdjustMemoryS() may lower the end of a descriptor after it was found
+    // to be the best one so far, so the descriptor picked depends on the
+    // order they are checked in. Keep the order of gMemoryMap.
     //
-    DescNumberOfBytes = DescEnd - DescStart + 1;
+    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
 
-    if (DescNumberOfBytes >= NumberOfBytes) {
       //
-      // If the start of the allocated range is below the min address allowed, skip it
+      // If it's not a free entry, don't bother with it
       //
-      if ((DescEnd - NumberOfBytes + 1) < MinAddress) {
+      if (Entry->Type != EfiConventionalMemory) {
         continue;
       }
 
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
-        }
+      Target = CoreFindFreePagesInEntry (Entry, MaxAddress, MinAddress, NumberOfBytes, Alignment, TRUE, Target);
+    }
+  } else {
+    //
+    // Only free entries are in the index. The size classes below the one of
+    // NumberOfPages only hold descriptors that are too small for the request.
+    // Without guard pages the highest fitting end wins whatever the order,
+    // so the result is the same as checking every descriptor of gMemoryMap.
+    //
+    for (Index = (UINTN)HighBitSet64 (NumberOfPages); Index < FREE_MEMORY_INDEX_SIZE; Index++) {
+      for (Link = mFreeMemoryMapIndex[Index].ForwardLink; Link != &mFreeMemoryMapIndex[Index]; Link = Link->ForwardLink) {
+        Entry = CR (Link, MEMORY_MAP, FreeLink, MEMORY_MAP_SIGNATURE);
+        ASSERT (Entry->Type == EfiConventionalMemory);
 
-        Target = DescEnd;
+        Target = CoreFindFreePagesInEntry (Entry, MaxAddress, MinAddress, NumberOfBytes, Alignment, FALSE, Target);
       }
     }
   }
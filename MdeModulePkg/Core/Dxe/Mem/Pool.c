@@ -22,6 +22,7 @@ typedef struct {
 
 #define POOL_HEAD_SIGNATURE       SIGNATURE_32('p','h','d','0')
 #define POOLPAGE_HEAD_SIGNATURE   SIGNATURE_32('p','h','d','1')
+#define POOLSLAB_HEAD_SIGNATURE   SIGNATURE_32('p','h','d','2')
 typedef struct {
   UINT32          Signature;
   UINT32          Reserved;
@@ -60,6 +61,36 @@ STATIC CONST UINT16 mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE     (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Requests too large for the bins above are served from slabs of
+// POOL_SLAB_PAGES pages when one of the slab block sizes wastes less memory
+// than rounding the request up to whole pages. The block sizes are picked so
+// that 6, 4, 3 and 2 blocks exactly fill a slab after its header, covering
+// the odd sized device path, HII and configuration buffers that would
+// otherwise cost an extra page each.
+//
+// Blocks of a slab carry POOLSLAB_HEAD_SIGNATURE, and the Reserved field of
+// their POOL_HEAD holds the block number within the slab.
+//
+#define POOL_SLAB_SIGNATURE     SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32          Signature;
+  UINT32          Index;
+  UINTN           Used;
+} POOL_SLAB;
+
+#define POOL_SLAB_PAGES         5
+#define SIZE_OF_POOL_SLAB_HEAD  64
+
+STATIC CONST UINT16 mPoolSlabSizeTable[] = {
+  3392, 5104, 6800, 10208
+};
+
+#define SLAB_LIST_TO_SIZE(a)    (mPoolSlabSizeTable [a])
+#define SLAB_LIST_TO_COUNT(a)   ((EFI_PAGES_TO_SIZE (POOL_SLAB_PAGES) - SIZE_OF_POOL_SLAB_HEAD) / mPoolSlabSizeTable [a])
+
+#define MAX_SLAB_LIST           (ARRAY_SIZE (mPoolSlabSizeTable))
+
 //
 // Globals
 //
@@ -71,6 +102,9 @@ typedef struct {
     EFI_MEMORY_TYPE  MemoryType;
     LIST_ENTRY       FreeList[MAX_POOL_LIST];
     LIST_ENTRY       Link;
+    LIST_ENTRY       SlabFreeList[MAX_SLAB_LIST];
+    UINTN            SlabPages;
+    UINTN            SlabUsed;
 } POOL;
 
 //
@@ -107,6 +141,35 @@ GetPoolIndexFromSize (
   return MAX_POOL_LIST;
 }
 
+/**
+  Get slab size table index from the specified size.
+
+  @param  Size          The specified size to get index from slab size table.
+
+  @return               The index of slab size table, or MAX_SLAB_LIST if a
+                        slab block would not use less memory than allocating
+                        whole pages for Size.
+
+**/
+STATIC
+UINTN
+GetSlabIndexFromSize (
+  UINTN   Size
+  )
+{
+  UINTN   Index;
+
+  for (Index = 0; Index < MAX_SLAB_LIST; Index++) {
+    if (mPoolSlabSizeTable [Index] >= Size) {
+      if (mPoolSlabSizeTable [Index] < EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (Size))) {
+        return Index;
+      }
+      break;
+    }
+  }
+  return MAX_SLAB_LIST;
+}
+
 /**
   Called to initialize the pool.
 
@@ -126,6 +189,11 @@ CoreInitializePool (
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+    for (Index=0; Index < MAX_SLAB_LIST; Index++) {
+      InitializeListHead (&mPoolHead[Type].SlabFreeList[Index]);
+    }
+    mPoolHead[Type].SlabPages  = 0;
+    mPoolHead[Type].SlabUsed   = 0;
   }
 }
 
@@ -176,6 +244,11 @@ LookupPoolHead (
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
     }
+    for (Index=0; Index < MAX_SLAB_LIST; Index++) {
+      InitializeListHead (&Pool->SlabFreeList[Index]);
+    }
+    Pool->SlabPages = 0;
+    Pool->SlabUsed  = 0;
 
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
@@ -185,6 +258,53 @@ LookupPoolHead (
   return NULL;
 }
 
+/**
+  Get the pool slab occupancy of all memory types.
+
+  @param  SlabSizeByType         Receives the size of the slab pages of each
+                                 memory profile memory type index
+  @param  SlabUsageByType        Receives the size of the slab blocks in use
+                                 of each memory profile memory type index
+
+**/
+VOID
+CoreGetPoolSlabUsage (
+  OUT UINT64                *SlabSizeByType,
+  OUT UINT64                *SlabUsageByType
+  )
+{
+  POOL        *Pool;
+  LIST_ENTRY  *Link;
+  UINTN       Index;
+
+  ZeroMem (SlabSizeByType, sizeof (UINT64) * (EfiMaxMemoryType + 2));
+  ZeroMem (SlabUsageByType, sizeof (UINT64) * (EfiMaxMemoryType + 2));
+
+  CoreAcquireLock (&mPoolMemoryLock);
+
+  for (Index = 0; Index < EfiMaxMemoryType; Index++) {
+    SlabSizeByType[Index]  = EFI_PAGES_TO_SIZE (mPoolHead[Index].SlabPages);
+    SlabUsageByType[Index] = mPoolHead[Index].SlabUsed;
+  }
+
+  //
+  // OS and OEM reserved types are combined into one entry each, as in the
+  // memory profile context
+  //
+  for (Link = mPoolHeadList.ForwardLink; Link != &mPoolHeadList; Link = Link->ForwardLink) {
+    Pool = CR (Link, POOL, Link, POOL_SIGNATURE);
+    if ((UINT32) Pool->MemoryType >= MEMORY_TYPE_OS_RESERVED_MIN) {
+      Index = EfiMaxMemoryType;
+    } else {
+      Index = EfiMaxMemoryType + 1;
+    }
+    SlabSizeByType[Index]  += EFI_PAGES_TO_SIZE (Pool->SlabPages);
+    SlabUsageByType[Index] += Pool->SlabUsed;
+  }
+
+  CoreReleaseLock (&mPoolMemoryLock);
+}
+
 
 
 /**
@@ -332,6 +452,85 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function to allocate a pool block from a slab.
+  Caller must have the memory lock held
+
+  @param  Pool                   The pool head of the memory type to allocate
+  @param  Size                   The size of the pool block, including the pool
+                                 header and tail
+  @param  Granularity            The page allocation granularity of the type
+
+  @return The pool header of the allocated block, or NULL if Size has no slab
+          size class or no memory is available for a new slab.
+
+**/
+STATIC
+POOL_HEAD *
+CoreAllocatePoolSlabBlock (
+  IN POOL             *Pool,
+  IN UINTN            Size,
+  IN UINTN            Granularity
+  )
+{
+  POOL_SLAB   *Slab;
+  POOL_FREE   *Free;
+  POOL_HEAD   *Head;
+  CHAR8       *NewPage;
+  UINTN       Index;
+  UINTN       Block;
+  UINTN       BlockSize;
+
+  ASSERT_LOCKED (&mPoolMemoryLock);
+
+  if (Granularity != EFI_PAGE_SIZE) {
+    return NULL;
+  }
+
+  Index = GetSlabIndexFromSize (Size);
+  if (Index >= MAX_SLAB_LIST) {
+    return NULL;
+  }
+  BlockSize = SLAB_LIST_TO_SIZE (Index);
+
+  if (IsListEmpty (&Pool->SlabFreeList[Index])) {
+    //
+    // Get a new slab and put all its blocks on the free list
+    //
+    NewPage = CoreAllocatePoolPagesI (Pool->MemoryType, POOL_SLAB_PAGES, Granularity, FALSE);
+    if (NewPage == NULL) {
+      return NULL;
+    }
+
+    Slab = (POOL_SLAB *) NewPage;
+    Slab->Signature = POOL_SLAB_SIGNATURE;
+    Slab->Index     = (UINT32)Index;
+    Slab->Used      = 0;
+
+    for (Block = SLAB_LIST_TO_COUNT (Index); Block > 0; Block--) {
+      Free = (POOL_FREE *) &NewPage[SIZE_OF_POOL_SLAB_HEAD + (Block - 1) * BlockSize];
+      Free->Signature = POOL_FREE_SIGNATURE;
+      Free->Index     = (UINT32)(Block - 1);
+      InsertHeadList (&Pool->SlabFreeList[Index], &Free->Link);
+    }
+
+    Pool->SlabPages += POOL_SLAB_PAGES;
+  }
+
+  Free = CR (Pool->SlabFreeList[Index].ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
+  RemoveEntryList (&Free->Link);
+
+  Block = Free->Index;
+  Slab  = (POOL_SLAB *)((CHAR8 *) Free - Block * BlockSize - SIZE_OF_POOL_SLAB_HEAD);
+  ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+  Slab->Used++;
+  Pool->SlabUsed += Size;
+
+  Head = (POOL_HEAD *) Free;
+  Head->Reserved = (UINT32) Block;
+  return Head;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -363,6 +562,7 @@ CoreAllocatePoolI (
   UINTN       Granularity;
   BOOLEAN     HasPoolTail;
   BOOLEAN     PageAsPool;
+  BOOLEAN     FromSlab;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -398,6 +598,19 @@ CoreAllocatePoolI (
     return NULL;
   }
   Head = NULL;
+  FromSlab = FALSE;
+
+  //
+  // If allocation is over max size, try to serve it from a slab before
+  // falling back to pages
+  //
+  if (Index >= SIZE_TO_LIST (Granularity) && !NeedGuard && !PageAsPool) {
+    Head = CoreAllocatePoolSlabBlock (Pool, Size, Granularity);
+    if (Head != NULL) {
+      FromSlab = TRUE;
+      goto Done;
+    }
+  }
 
   //
   // If allocation is over max size, just allocate pages for the request
@@ -495,7 +708,11 @@ Done:
     //
     // If we have a pool buffer, fill in the header & tail info
     //
-    Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    if (FromSlab) {
+      Head->Signature = POOLSLAB_HEAD_SIGNATURE;
+    } else {
+      Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    }
     Head->Size      = Size;
     Head->Type      = (EFI_MEMORY_TYPE) PoolType;
     Buffer          = Head->Data;
@@ -653,6 +870,71 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function to return a pool block to its slab. The slab is freed
+  when none of its blocks are in use anymore.
+  Caller must have the memory lock held
+
+  @param  Pool                   The pool head of the memory type of the block
+  @param  Head                   The pool header of the block to free
+  @param  Size                   The size of the block, including the pool
+                                 header and tail
+  @param  Block                  The block number of Head within its slab
+
+**/
+STATIC
+VOID
+CoreFreePoolSlabBlock (
+  IN POOL             *Pool,
+  IN POOL_HEAD        *Head,
+  IN UINTN            Size,
+  IN UINTN            Block
+  )
+{
+  POOL_SLAB   *Slab;
+  POOL_FREE   *Free;
+  CHAR8       *NewPage;
+  UINTN       Index;
+  UINTN       BlockSize;
+
+  ASSERT_LOCKED (&mPoolMemoryLock);
+
+  Index     = GetSlabIndexFromSize (Size);
+  ASSERT (Index < MAX_SLAB_LIST);
+  BlockSize = SLAB_LIST_TO_SIZE (Index);
+  NewPage   = (CHAR8 *) Head - Block * BlockSize - SIZE_OF_POOL_SLAB_HEAD;
+  Slab      = (POOL_SLAB *) NewPage;
+  ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+  ASSERT (Slab->Index == Index);
+  ASSERT (Slab->Used > 0);
+
+  Free = (POOL_FREE *) Head;
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32) Block;
+  InsertHeadList (&Pool->SlabFreeList[Index], &Free->Link);
+
+  Pool->SlabUsed -= Size;
+  Slab->Used--;
+  if (Slab->Used != 0) {
+    return;
+  }
+
+  //
+  // All the blocks of the slab are free. Remove them from the free list and
+  // return the pages of the slab.
+  //
+  for (Block = 0; Block < SLAB_LIST_TO_COUNT (Index); Block++) {
+    Free = (POOL_FREE *) &NewPage[SIZE_OF_POOL_SLAB_HEAD + Block * BlockSize];
+    ASSERT (Free->Signature == POOL_FREE_SIGNATURE);
+    RemoveEntryList (&Free->Link);
+  }
+
+  Slab->Signature = 0;
+  Pool->SlabPages -= POOL_SLAB_PAGES;
+
+  CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS) (UINTN) NewPage, POOL_SLAB_PAGES);
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -684,6 +966,8 @@ CoreFreePoolI (
   BOOLEAN     IsGuarded;
   BOOLEAN     HasPoolTail;
   BOOLEAN     PageAsPool;
+  BOOLEAN     FromSlab;
+  UINTN       Block;
 
   ASSERT(Buffer != NULL);
   //
@@ -693,9 +977,11 @@ CoreFreePoolI (
   ASSERT(Head != NULL);
 
   if (Head->Signature != POOL_HEAD_SIGNATURE &&
-      Head->Signature != POOLPAGE_HEAD_SIGNATURE) {
+      Head->Signature != POOLPAGE_HEAD_SIGNATURE &&
+      Head->Signature != POOLSLAB_HEAD_SIGNATURE) {
     ASSERT (Head->Signature == POOL_HEAD_SIGNATURE ||
-            Head->Signature == POOLPAGE_HEAD_SIGNATURE);
+            Head->Signature == POOLPAGE_HEAD_SIGNATURE ||
+            Head->Signature == POOLSLAB_HEAD_SIGNATURE);
     return EFI_INVALID_PARAMETER;
   }
 
@@ -704,6 +990,8 @@ CoreFreePoolI (
   HasPoolTail = !(IsGuarded &&
                   ((PcdGet8 (PcdHeapGuardPropertyMask) & BIT7) == 0));
   PageAsPool = (Head->Signature == POOLPAGE_HEAD_SIGNATURE);
+  FromSlab   = (Head->Signature == POOLSLAB_HEAD_SIGNATURE);
+  Block      = Head->Reserved;
 
   if (HasPoolTail) {
     Tail = HEAD_TO_TAIL (Head);
@@ -757,10 +1045,18 @@ CoreFreePoolI (
   Index = SIZE_TO_LIST(Size);
   DEBUG_CLEAR_MEMORY (Head, Size);
 
-  //
-  // If it's not on the list, it must be pool pages
-  //
-  if (Index >= SIZE_TO_LIST (Granularity) || IsGuarded || PageAsPool) {
+  if (FromSlab) {
+
+    //
+    // Return the block to its slab
+    //
+    CoreFreePoolSlabBlock (Pool, Head, Size, Block);
+
+  } else if (Index >= SIZE_TO_LIST (Granularity) || IsGuarded || PageAsPool) {
+
+    //
+    // If it's not on the list, it must be pool pages
+    //
 
     //
     // Return the memory pages back to free memory
@@ -0,0 +1,519 @@
+/** @file
+  Host based unit tests of the DXE core timer wheel.
+
+  Event/Timer.c is built into this application unchanged, with the few DXE
+  core services it calls replaced by the minimal versions below. Thousands of
+  timer events are armed, re-armed and cancelled in random order while the
+  system time advances by random ticks, including gaps of more than one turn
+  of the wheel. After every check of the timers, the events signaled are
+  compared against a reference model that keeps all timers in one array and
+  fires them in trigger time order, like the sorted timer list did.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+
+#include "DxeMain.h"
+#include "Event.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME        "DXE Core Timer Wheel Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+#define TIMER_COUNT               4096
+#define STRESS_ITERATIONS         50000
+
+//
+// One slot of the wheel covers 2^16 units of 100ns, and the wheel has 512
+// slots. Keep in sync with Event/Timer.c.
+//
+#define TIMER_WHEEL_TURN          ((UINT64)512 << 16)
+
+//
+// The DXE core globals and services used by Event/Timer.c.
+//
+EFI_TIMER_ARCH_PROTOCOL   *gTimer = NULL;
+STATIC EFI_TPL            mTestTpl = TPL_APPLICATION;
+
+extern UINT64             mEfiTimerNextTriggerTime;
+extern UINT64             mEfiTimerWheelOccupied[];
+
+//
+// Event/Timer.c functions that are not declared in the DXE core headers.
+//
+VOID
+EFIAPI
+CoreCheckTimers (
+  IN EFI_EVENT            CheckEvent,
+  IN VOID                 *Context
+  );
+
+UINT64
+CoreCurrentSystemTime (
+  VOID
+  );
+
+//
+// The timer events, and the events signaled since the last check.
+//
+STATIC IEVENT             mEvents[TIMER_COUNT];
+STATIC UINTN              mSignaled[TIMER_COUNT * 4];
+STATIC UINTN              mSignaledCount;
+
+//
+// The reference model of each timer. Timers with the same trigger time fire
+// in the order they were set, which Sequence records.
+//
+typedef struct {
+  BOOLEAN                 Armed;
+  UINT64                  TriggerTime;
+  UINT64                  Period;
+  UINT64                  Sequence;
+} MODEL_TIMER;
+
+STATIC MODEL_TIMER        mModel[TIMER_COUNT];
+STATIC UINT64             mModelSequence;
+STATIC UINT64             mModelTime;
+STATIC UINTN              mExpected[TIMER_COUNT * 4];
+
+STATIC UINT32             mSeed;
+
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL      NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl   = mTestTpl;
+  mTestTpl = NewTpl;
+  return OldTpl;
+}
+
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL NewTpl
+  )
+{
+  mTestTpl = NewTpl;
+}
+
+EFI_STATUS
+EFIAPI
+CoreSignalEvent (
+  IN EFI_EVENT    UserEvent
+  )
+{
+  //
+  // The check timer event is not created, so the tests call CoreCheckTimers()
+  // directly after every tick.
+  //
+  if (UserEvent != NULL) {
+    if (mSignaledCount < ARRAY_SIZE (mSignaled)) {
+      mSignaled[mSignaledCount] = (IEVENT *)UserEvent - mEvents;
+    }
+    mSignaledCount++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+CoreCreateEventInternal (
+  IN  UINT32                   Type,
+  IN  EFI_TPL                  NotifyTpl,
+  IN  EFI_EVENT_NOTIFY         NotifyFunction  OPTIONAL,
+  IN  CONST VOID               *NotifyContext  OPTIONAL,
+  IN  CONST EFI_GUID           *EventGroup     OPTIONAL,
+  OUT EFI_EVENT                *Event
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Returns a pseudo random number. The sequence is the same on every run.
+
+  @param[in]  Limit  The number returned is below Limit.
+
+  @return  The pseudo random number.
+**/
+STATIC
+UINT64
+Random (
+  IN UINT64  Limit
+  )
+{
+  UINT64  Value;
+
+  mSeed = mSeed * 1103515245 + 12345;
+  Value = mSeed >> 8;
+  mSeed = mSeed * 1103515245 + 12345;
+  Value = (Value << 24) | (mSeed >> 8);
+  return Value % Limit;
+}
+
+/**
+  Resets the timer events, the timer wheel and the reference model.
+
+  @param[in]  Context  Unused.
+**/
+VOID
+EFIAPI
+ResetTimers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TIMER_COUNT; Index++) {
+    if (mEvents[Index].Signature == EVENT_SIGNATURE) {
+      CoreSetTimer (&mEvents[Index], TimerCancel, 0);
+    }
+
+    ZeroMem (&mEvents[Index], sizeof (mEvents[Index]));
+    mEvents[Index].Signature = EVENT_SIGNATURE;
+    mEvents[Index].Type      = EVT_TIMER;
+  }
+
+  ZeroMem (mModel, sizeof (mModel));
+  mModelSequence = 0;
+  mModelTime     = 0;
+  mSignaledCount = 0;
+  mSeed          = 1;
+
+  //
+  // Run the timer database up to the current system time.
+  //
+  CoreCheckTimers (NULL, NULL);
+  mModelTime = CoreCurrentSystemTime ();
+}
+
+/**
+  Sets a timer of the reference model, as CoreSetTimer() does.
+
+  @param[in]  Index        The timer to set.
+  @param[in]  Type         The type of the timer.
+  @param[in]  TriggerTime  The number of 100ns units until the timer expires.
+**/
+STATIC
+VOID
+ModelSetTimer (
+  IN UINTN            Index,
+  IN EFI_TIMER_DELAY  Type,
+  IN UINT64           TriggerTime
+  )
+{
+  mModel[Index].Armed = (BOOLEAN)(Type != TimerCancel);
+  mModel[Index].Period = (Type == TimerPeriodic) ? TriggerTime : 0;
+  mModel[Index].TriggerTime = mModelTime + TriggerTime;
+  mModel[Index].Sequence = mModelSequence++;
+}
+
+/**
+  Fires the expired timers of the reference model in trigger time order, as
+  the sorted timer list did.
+
+  @return  The number of timers fired, recorded in mExpected.
+**/
+STATIC
+UINTN
+ModelCheckTimers (
+  VOID
+  )
+{
+  UINTN        Count;
+  UINTN        Index;
+  MODEL_TIMER  *Timer;
+  MODEL_TIMER  *Earliest;
+
+  Count = 0;
+  while (TRUE) {
+    Earliest = NULL;
+    for (Index = 0; Index < TIMER_COUNT; Index++) {
+      Timer = &mModel[Index];
+      if (!Timer->Armed || (Timer->TriggerTime > mModelTime)) {
+        continue;
+      }
+      if ((Earliest == NULL) ||
+          (Timer->TriggerTime < Earliest->TriggerTime) ||
+          ((Timer->TriggerTime == Earliest->TriggerTime) && (Timer->Sequence < Earliest->Sequence))) {
+        Earliest = Timer;
+      }
+    }
+
+    if (Earliest == NULL) {
+      return Count;
+    }
+
+    if (Count < ARRAY_SIZE (mExpected)) {
+      mExpected[Count] = Earliest - mModel;
+    }
+    Count++;
+
+    Earliest->Armed = FALSE;
+    if (Earliest->Period != 0) {
+      Earliest->Armed = TRUE;
+      Earliest->TriggerTime += Earliest->Period;
+      if (Earliest->TriggerTime <= mModelTime) {
+        Earliest->TriggerTime = mModelTime;
+      }
+      Earliest->Sequence = mModelSequence++;
+    }
+  }
+}
+
+/**
+  Returns the earliest trigger time of the reference model.
+
+  @return  The earliest trigger time, or MAX_UINT64 if no timer is armed.
+**/
+STATIC
+UINT64
+ModelEarliestTriggerTime (
+  VOID
+  )
+{
+  UINTN   Index;
+  UINT64  TriggerTime;
+
+  TriggerTime = MAX_UINT64;
+  for (Index = 0; Index < TIMER_COUNT; Index++) {
+    if (mModel[Index].Armed && (mModel[Index].TriggerTime < TriggerTime)) {
+      TriggerTime = mModel[Index].TriggerTime;
+    }
+  }
+
+  return TriggerTime;
+}
+
+/**
+  Advances the system time and checks the timers, then compares the events
+  signaled with the timers the reference model fires.
+
+  @param[in]  Duration  The number of 100ns units to advance the time by.
+
+  @retval  TRUE   The same timers fired in the same order.
+  @retval  FALSE  The timers fired differ from the reference model.
+**/
+STATIC
+BOOLEAN
+TickAndCompare (
+  IN UINT64  Duration
+  )
+{
+  UINTN  Count;
+
+  mSignaledCount = 0;
+  CoreTimerTick (Duration);
+  CoreCheckTimers (NULL, NULL);
+
+  mModelTime += Duration;
+  Count = ModelCheckTimers ();
+
+  if ((Count != mSignaledCount) || (Count > ARRAY_SIZE (mExpected))) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(CompareMem (mSignaled, mExpected, Count * sizeof (mExpected[0])) == 0);
+}
+
+/**
+  Timers armed, re-armed and cancelled in random order, with ticks of random
+  length, should fire in the same order as from a sorted list.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TimersShouldFireInTriggerTimeOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN            Iteration;
+  UINTN            Index;
+  UINT64           Choice;
+  UINT64           TriggerTime;
+  UINT64           Duration;
+  EFI_TIMER_DELAY  Type;
+  EFI_STATUS       Status;
+
+  for (Iteration = 0; Iteration < STRESS_ITERATIONS; Iteration++) {
+    Choice = Random (100);
+    if (Choice < 80) {
+      //
+      // Set or cancel a random timer. Most timers expire within two turns of
+      // the wheel, and some at the current time or after a long time.
+      //
+      Index = (UINTN)Random (TIMER_COUNT);
+      Choice = Random (100);
+      if (Choice < 15) {
+        Type = TimerCancel;
+        TriggerTime = 0;
+      } else if (Choice < 25) {
+        Type = TimerPeriodic;
+        TriggerTime = 1 + Random (TIMER_WHEEL_TURN / 4);
+      } else {
+        Type = TimerRelative;
+        Choice = Random (100);
+        if (Choice < 5) {
+          TriggerTime = 0;
+        } else if (Choice < 10) {
+          TriggerTime = Random (TIMER_WHEEL_TURN * 64);
+        } else {
+          TriggerTime = Random (TIMER_WHEEL_TURN * 2);
+        }
+      }
+
+      Status = CoreSetTimer (&mEvents[Index], Type, TriggerTime);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      ModelSetTimer (Index, Type, TriggerTime);
+      UT_ASSERT_TRUE (mEfiTimerNextTriggerTime <= ModelEarliestTriggerTime ());
+    } else {
+      //
+      // Advance the time, mostly by less than one slot of the wheel, and
+      // sometimes by more than one turn.
+      //
+      Choice = Random (100);
+      if (Choice < 90) {
+        Duration = Random (1 << 17);
+      } else if (Choice < 98) {
+        Duration = Random (TIMER_WHEEL_TURN);
+      } else {
+        Duration = TIMER_WHEEL_TURN + Random (TIMER_WHEEL_TURN * 2);
+      }
+
+      UT_ASSERT_TRUE (TickAndCompare (Duration));
+      UT_ASSERT_EQUAL (mEfiTimerNextTriggerTime, ModelEarliestTriggerTime ());
+    }
+  }
+
+  //
+  // Fire all remaining timers
+  //
+  UT_ASSERT_TRUE (TickAndCompare (TIMER_WHEEL_TURN * 64));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Cancelling all timers should leave the timer wheel empty.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CancelledTimersShouldNotFire (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  for (Index = 0; Index < TIMER_COUNT; Index++) {
+    Status = CoreSetTimer (&mEvents[Index], TimerRelative, Random (TIMER_WHEEL_TURN * 4));
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  for (Index = 0; Index < TIMER_COUNT; Index++) {
+    Status = CoreSetTimer (&mEvents[TIMER_COUNT - 1 - Index], TimerCancel, 0);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  for (Index = 0; Index < 512 / 64; Index++) {
+    UT_ASSERT_EQUAL (mEfiTimerWheelOccupied[Index], 0);
+  }
+
+  mSignaledCount = 0;
+  CoreTimerTick (TIMER_WHEEL_TURN * 8);
+  CoreCheckTimers (NULL, NULL);
+  UT_ASSERT_EQUAL (mSignaledCount, 0);
+  UT_ASSERT_EQUAL (mEfiTimerNextTriggerTime, MAX_UINT64);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the timer
+  wheel and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TimerTests;
+
+  Framework = NULL;
+
+  DEBUG(( DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+      goto EXIT;
+  }
+
+  //
+  // Populate the timer wheel Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&TimerTests, Framework, "DXE Core Timer Wheel Tests", "DxeCore.Timer", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TimerTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (TimerTests, "Timers should fire in trigger time order", "Order", TimersShouldFireInTriggerTimeOrder, NULL, ResetTimers, NULL);
+  AddTestCase (TimerTests, "Cancelled timers should not fire", "Cancel", CancelledTimersShouldNotFire, NULL, ResetTimers, NULL);
+
+  //
+  // Execute the tests.
+  //
+  ResetTimers (NULL);
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return EFI_ERROR (UnitTestingEntry ()) ? 1 : 0;
+}
@@ -622,12 +622,18 @@ CustomGuidedSectionExtract (
     DEBUG ((DEBUG_INFO, "Customized Guided section Memory Size required is 0x%x and address is 0x%p\n", OutputBufferSize, *OutputBuffer));
   }
 
+  //
+  // Decoding the compressed DXE FV is a large share of the PEI phase, so
+  // record it separately in the performance log.
+  //
+  PERF_INMODULE_BEGIN ("DecodeGuidedSection");
   Status = ExtractGuidedSectionDecode (
              InputSection,
              OutputBuffer,
              ScratchBuffer,
              AuthenticationStatus
              );
+  PERF_INMODULE_END ("DecodeGuidedSection");
   if (EFI_ERROR (Status)) {
     //
     // Decode failed
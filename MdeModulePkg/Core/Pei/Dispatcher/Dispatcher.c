@@ -38,6 +38,8 @@ DiscoverPeimsAndOrderWithApriori (
   EFI_GUID                            *TempFileGuid;
   EFI_PEI_FIRMWARE_VOLUME_PPI         *FvPpi;
   EFI_FV_FILE_INFO                    FileInfo;
+  PEI_FV_FILE_INDEX_RECORD            FileIndex;
+  BOOLEAN                             RecordFileIndex;
 
   FvPpi = CoreFileHandle->FvPpi;
 
@@ -61,11 +63,17 @@ DiscoverPeimsAndOrderWithApriori (
 
   //
   // Go ahead to scan this FV, get PeimCount and cache FileHandles within it to TempFileHandles.
+  // The same walk records the FFS files of the FV for the DXE Core.
   //
+  RecordFileIndex = PeiStartFvFileIndex (Private, CoreFileHandle, &FileIndex);
   PeimCount = 0;
   FileHandle = NULL;
   do {
-    Status = FvPpi->FindFileByType (FvPpi, PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE, CoreFileHandle->FvHandle, &FileHandle);
+    if (RecordFileIndex) {
+      Status = PeiFindDispatchFileAndRecordIndex (CoreFileHandle, &FileHandle, &FileIndex);
+    } else {
+      Status = FvPpi->FindFileByType (FvPpi, PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE, CoreFileHandle->FvHandle, &FileHandle);
+    }
     if (!EFI_ERROR (Status)) {
       if (PeimCount >= Private->TempPeimCount) {
         //
@@ -96,6 +104,10 @@ DiscoverPeimsAndOrderWithApriori (
     }
   } while (!EFI_ERROR (Status));
 
+  if (RecordFileIndex) {
+    PeiBuildFvFileIndexHob (CoreFileHandle, &FileIndex);
+  }
+
   DEBUG ((
     DEBUG_INFO,
     "%a(): Found 0x%x PEI FFS files in the %dth FV\n",
@@ -242,6 +242,76 @@ FileHandleToVolume (
   return NULL;
 }
 
+/**
+  Record an FFS file passed by FindFileEx() in the file index of its firmware
+  volume, with the rules the DXE Core uses to build its file list.
+
+  @param FileIndex       The file index being recorded.
+  @param FwVolHeader     Pointer to the memory-mapped firmware volume.
+  @param FfsFileHeader   Pointer to the FFS file header.
+  @param FileLength      Size of the FFS file, including its header.
+**/
+STATIC
+VOID
+RecordFvFileIndexEntry (
+  IN OUT PEI_FV_FILE_INDEX_RECORD     *FileIndex,
+  IN     EFI_FIRMWARE_VOLUME_HEADER   *FwVolHeader,
+  IN     EFI_FFS_FILE_HEADER          *FfsFileHeader,
+  IN     UINT32                       FileLength
+  )
+{
+  EDKII_FV_FILE_INDEX_ENTRY           *Entry;
+
+  if (!FileIndex->Valid) {
+    return;
+  }
+
+  if ((FileLength < (IS_FFS_FILE2 (FfsFileHeader) ? sizeof (EFI_FFS_FILE_HEADER2) : sizeof (EFI_FFS_FILE_HEADER))) ||
+      (FileLength > FwVolHeader->FvLength - ((UINT8 *) FfsFileHeader - (UINT8 *) FwVolHeader)) ||
+      (FileIndex->FileCount == FileIndex->MaxEntries)) {
+    FileIndex->Valid = FALSE;
+    return;
+  }
+
+  Entry = &FileIndex->Entries[FileIndex->FileCount];
+  CopyGuid (&Entry->Name, &FfsFileHeader->Name);
+  Entry->Offset      = (UINT32) ((UINT8 *) FfsFileHeader - (UINT8 *) FwVolHeader);
+  Entry->Size        = FileLength;
+  Entry->Type        = FfsFileHeader->Type;
+  Entry->Attributes  = FfsFileHeader->Attributes;
+  Entry->Reserved[0] = 0;
+  Entry->Reserved[1] = 0;
+  FileIndex->FileCount++;
+}
+
+/**
+  Check whether an FFS file header lies in the free space of a firmware
+  volume, which ends its file list.
+
+  @param ErasePolarity   Erase polarity of the firmware volume.
+  @param FfsFileHeader   Pointer to the FFS file header.
+
+  @retval TRUE           The header is erased.
+  @retval FALSE          The header is not erased.
+**/
+STATIC
+BOOLEAN
+IsFfsFileHeaderErased (
+  IN UINT8                            ErasePolarity,
+  IN EFI_FFS_FILE_HEADER              *FfsFileHeader
+  )
+{
+  UINTN                               Index;
+
+  for (Index = 0; Index < sizeof (EFI_FFS_FILE_HEADER); Index++) {
+    if (((UINT8 *) FfsFileHeader)[Index] != (UINT8) (ErasePolarity != 0 ? 0xFF : 0)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -256,6 +326,8 @@ FileHandleToVolume (
                          Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
   @param FileHandle      This parameter must point to a valid FFS volume.
   @param AprioriFile     Pointer to AprioriFile image in this FV if has
+  @param FileIndex       If not NULL, the non-deleted files passed by the search
+                         are recorded in this file index. FileName must be NULL.
 
   @return EFI_NOT_FOUND  No files matching the search criteria were found
   @retval EFI_SUCCESS    Success to search given file
@@ -267,7 +339,8 @@ FindFileEx (
   IN  CONST EFI_GUID                 *FileName,   OPTIONAL
   IN        EFI_FV_FILETYPE          SearchType,
   IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
-  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile,  OPTIONAL
+  IN OUT    PEI_FV_FILE_INDEX_RECORD *FileIndex     OPTIONAL
   )
 {
   EFI_FIRMWARE_VOLUME_HEADER            *FwVolHeader;
@@ -359,6 +432,9 @@ FindFileEx (
     case EFI_FILE_MARKED_FOR_UPDATE:
       if (CalculateHeaderChecksum (FfsFileHeader) != 0) {
         ASSERT (FALSE);
+        if (FileIndex != NULL) {
+          FileIndex->Valid = FALSE;
+        }
         *FileHeader = NULL;
         return EFI_NOT_FOUND;
       }
@@ -388,10 +464,17 @@ FindFileEx (
       }
       if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
         ASSERT (FALSE);
+        if (FileIndex != NULL) {
+          FileIndex->Valid = FALSE;
+        }
         *FileHeader = NULL;
         return EFI_NOT_FOUND;
       }
 
+      if (FileIndex != NULL) {
+        RecordFvFileIndexEntry (FileIndex, FwVolHeader, FfsFileHeader, FileLength);
+      }
+
       if (FileName != NULL) {
         if (CompareGuid (&FfsFileHeader->Name, (EFI_GUID*)FileName)) {
           *FileHeader = FfsFileHeader;
@@ -437,6 +520,12 @@ FindFileEx (
       break;
 
     default:
+      //
+      // The free space ends the file list, anything else is corrupted.
+      //
+      if ((FileIndex != NULL) && !IsFfsFileHeaderErased (ErasePolarity, FfsFileHeader)) {
+        FileIndex->Valid = FALSE;
+      }
       *FileHeader = NULL;
       return EFI_NOT_FOUND;
     }
@@ -446,6 +535,128 @@ FindFileEx (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Start recording the file index of a firmware volume while the PEI Core
+  looks for its PEIMs.
+
+  Only the memory-mapped FFS2 and FFS3 firmware volumes of the PEI Core that
+  are found after permanent memory is installed get an index. The DXE Core
+  walks the others, as well as any firmware volume whose index turns out to
+  be unusable, as usual.
+
+  @param PrivateData     Pointer to PEI_CORE_INSTANCE.
+  @param CoreFvHandle    The firmware volume about to be walked.
+  @param FileIndex       Returns the file index to record.
+
+  @retval TRUE           The file index is to be recorded.
+  @retval FALSE          The firmware volume gets no file index.
+**/
+BOOLEAN
+PeiStartFvFileIndex (
+  IN  PEI_CORE_INSTANCE           *PrivateData,
+  IN  PEI_CORE_FV_HANDLE          *CoreFvHandle,
+  OUT PEI_FV_FILE_INDEX_RECORD    *FileIndex
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER      *FwVolHeader;
+
+  FileIndex->Entries    = NULL;
+  FileIndex->MaxEntries = 0;
+  FileIndex->FileCount  = 0;
+  FileIndex->Valid      = FALSE;
+
+  if (!PrivateData->PeiMemoryInstalled ||
+      (PrivateData->HobList.HandoffInformationTable->BootMode == BOOT_ON_S3_RESUME)) {
+    return FALSE;
+  }
+
+  FwVolHeader = CoreFvHandle->FvHeader;
+  if ((FwVolHeader == NULL) ||
+      ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)) ||
+      (FwVolHeader->FvLength > MAX_UINT32)) {
+    return FALSE;
+  }
+
+  //
+  // The HOB length is a UINT16 that includes the GUID HOB header.
+  //
+  FileIndex->MaxEntries = (MAX_UINT16 - sizeof (EFI_HOB_GUID_TYPE) - sizeof (EDKII_FV_FILE_INDEX)) / sizeof (EDKII_FV_FILE_INDEX_ENTRY);
+  FileIndex->Entries    = AllocatePages (EFI_SIZE_TO_PAGES (FileIndex->MaxEntries * sizeof (EDKII_FV_FILE_INDEX_ENTRY)));
+  if (FileIndex->Entries == NULL) {
+    return FALSE;
+  }
+
+  FileIndex->Valid = TRUE;
+  return TRUE;
+}
+
+/**
+  Find the next PEIM, combined PEIM/driver or firmware volume image file of a
+  firmware volume, as FindFileByType () with
+  PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE does, and record the FFS files
+  passed on the way in its file index.
+
+  @param CoreFvHandle    The firmware volume to search.
+  @param FileHandle      The file to start after, or NULL to start at the
+                         beginning of the firmware volume. Updated upon return
+                         to reflect the file found.
+  @param FileIndex       The file index started by PeiStartFvFileIndex ().
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  The file was not found. FileHandle contains NULL.
+**/
+EFI_STATUS
+PeiFindDispatchFileAndRecordIndex (
+  IN     PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN OUT EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT PEI_FV_FILE_INDEX_RECORD *FileIndex
+  )
+{
+  return FindFileEx (CoreFvHandle->FvHandle, NULL, PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE, FileHandle, NULL, FileIndex);
+}
+
+/**
+  Publish the file index recorded while the PEIMs of a firmware volume were
+  looked for in a HOB, so that the DXE Core does not have to walk the FFS
+  file headers of the firmware volume again, and free the recording buffer.
+
+  @param CoreFvHandle    The firmware volume that was walked.
+  @param FileIndex       The file index started by PeiStartFvFileIndex ().
+**/
+VOID
+PeiBuildFvFileIndexHob (
+  IN     PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN OUT PEI_FV_FILE_INDEX_RECORD *FileIndex
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER      *FwVolHeader;
+  EDKII_FV_FILE_INDEX             *FvFileIndex;
+
+  FwVolHeader = CoreFvHandle->FvHeader;
+  if (!FileIndex->Valid) {
+    DEBUG ((DEBUG_INFO, "FV at 0x%p gets no file index HOB\n", FwVolHeader));
+  } else {
+    FvFileIndex = BuildGuidHob (
+                    &gEdkiiFvFileIndexHobGuid,
+                    sizeof (EDKII_FV_FILE_INDEX) + FileIndex->FileCount * sizeof (EDKII_FV_FILE_INDEX_ENTRY)
+                    );
+    if (FvFileIndex != NULL) {
+      FvFileIndex->FvBase     = (EFI_PHYSICAL_ADDRESS) (UINTN) FwVolHeader;
+      FvFileIndex->FvLength   = FwVolHeader->FvLength;
+      FvFileIndex->FvChecksum = FwVolHeader->Checksum;
+      FvFileIndex->Reserved   = 0;
+      FvFileIndex->FileCount  = (UINT32) FileIndex->FileCount;
+      CopyMem (FvFileIndex + 1, FileIndex->Entries, FileIndex->FileCount * sizeof (EDKII_FV_FILE_INDEX_ENTRY));
+
+      DEBUG ((DEBUG_INFO, "FV at 0x%lx: %u files in the file index HOB\n", FvFileIndex->FvBase, FvFileIndex->FileCount));
+    }
+  }
+
+  FreePages (FileIndex->Entries, EFI_SIZE_TO_PAGES (FileIndex->MaxEntries * sizeof (EDKII_FV_FILE_INDEX_ENTRY)));
+  FileIndex->Entries = NULL;
+  FileIndex->Valid   = FALSE;
+}
+
 /**
   Initialize PeiCore FV List.
 
@@ -1666,7 +1877,7 @@ PeiFfsFvPpiFindFileByType (
   IN OUT    EFI_PEI_FILE_HANDLE         *FileHandle
   )
 {
-  return FindFileEx (FvHandle, NULL, SearchType, FileHandle, NULL);
+  return FindFileEx (FvHandle, NULL, SearchType, FileHandle, NULL, NULL);
 }
 
 /**
@@ -1712,7 +1923,7 @@ PeiFfsFvPpiFindFileByName (
   }
 
   if (*FvHandle != NULL) {
-    Status = FindFileEx (*FvHandle, FileName, 0, FileHandle, NULL);
+    Status = FindFileEx (*FvHandle, FileName, 0, FileHandle, NULL, NULL);
     if (Status == EFI_NOT_FOUND) {
       *FileHandle = NULL;
     }
@@ -1728,7 +1939,7 @@ PeiFfsFvPpiFindFileByName (
       // Only search the FV which is associated with a EFI_PEI_FIRMWARE_VOLUME_PPI instance.
       //
       if (PrivateData->Fv[Index].FvPpi != NULL) {
-        Status = FindFileEx (PrivateData->Fv[Index].FvHandle, FileName, 0, FileHandle, NULL);
+        Status = FindFileEx (PrivateData->Fv[Index].FvHandle, FileName, 0, FileHandle, NULL, NULL);
         if (!EFI_ERROR (Status)) {
           *FvHandle = PrivateData->Fv[Index].FvHandle;
           break;
@@ -288,6 +288,8 @@ FvHandleToCoreHandle (
                          Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
   @param FileHandle      This parameter must point to a valid FFS volume.
   @param AprioriFile     Pointer to AprioriFile image in this FV if has
+  @param FileIndex       If not NULL, the non-deleted files passed by the search
+                         are recorded in this file index. FileName must be NULL.
 
   @return EFI_NOT_FOUND  No files matching the search criteria were found
   @retval EFI_SUCCESS    Success to search given file
@@ -299,7 +301,8 @@ FindFileEx (
   IN  CONST EFI_GUID                 *FileName,   OPTIONAL
   IN        EFI_FV_FILETYPE          SearchType,
   IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
-  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile,  OPTIONAL
+  IN OUT    PEI_FV_FILE_INDEX_RECORD *FileIndex     OPTIONAL
   );
 
 /**
@@ -45,6 +45,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
+#include <Guid/FvFileIndexHob.h>
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -148,6 +149,17 @@ typedef struct {
   UINT32                              AuthenticationStatus;
 } PEI_CORE_FV_HANDLE;
 
+///
+/// The FFS files of a firmware volume, recorded while the PEI Core looks for
+/// its PEIMs and handed over to the DXE Core in a file index HOB.
+///
+typedef struct {
+  EDKII_FV_FILE_INDEX_ENTRY           *Entries;
+  UINTN                               MaxEntries;
+  UINTN                               FileCount;
+  BOOLEAN                             Valid;
+} PEI_FV_FILE_INDEX_RECORD;
+
 typedef struct {
   EFI_GUID                            FvFormat;
   VOID                                *FvInfo;
@@ -1262,6 +1274,61 @@ PeiInitializeFv (
   IN CONST EFI_SEC_PEI_HAND_OFF   *SecCoreData
   );
 
+/**
+  Start recording the file index of a firmware volume while the PEI Core
+  looks for its PEIMs.
+
+  @param PrivateData     Pointer to PEI_CORE_INSTANCE.
+  @param CoreFvHandle    The firmware volume about to be walked.
+  @param FileIndex       Returns the file index to record.
+
+  @retval TRUE           The file index is to be recorded.
+  @retval FALSE          The firmware volume gets no file index.
+
+**/
+BOOLEAN
+PeiStartFvFileIndex (
+  IN  PEI_CORE_INSTANCE           *PrivateData,
+  IN  PEI_CORE_FV_HANDLE          *CoreFvHandle,
+  OUT PEI_FV_FILE_INDEX_RECORD    *FileIndex
+  );
+
+/**
+  Find the next PEIM, combined PEIM/driver or firmware volume image file of a
+  firmware volume, and record the FFS files passed on the way in its file
+  index.
+
+  @param CoreFvHandle    The firmware volume to search.
+  @param FileHandle      The file to start after, or NULL to start at the
+                         beginning of the firmware volume. Updated upon return
+                         to reflect the file found.
+  @param FileIndex       The file index started by PeiStartFvFileIndex ().
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  The file was not found. FileHandle contains NULL.
+
+**/
+EFI_STATUS
+PeiFindDispatchFileAndRecordIndex (
+  IN     PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN OUT EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT PEI_FV_FILE_INDEX_RECORD *FileIndex
+  );
+
+/**
+  Publish the file index recorded while the PEIMs of a firmware volume were
+  looked for in a HOB, and free the recording buffer.
+
+  @param CoreFvHandle    The firmware volume that was walked.
+  @param FileIndex       The file index started by PeiStartFvFileIndex ().
+
+**/
+VOID
+PeiBuildFvFileIndexHob (
+  IN     PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN OUT PEI_FV_FILE_INDEX_RECORD *FileIndex
+  );
+
 /**
   Process Firmware Volume Information once FvInfoPPI install.
 
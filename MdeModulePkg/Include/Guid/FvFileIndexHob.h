@@ -0,0 +1,46 @@
+/** @file
+  FV file index HOB.
+
+  The PEI Core publishes one such HOB for every FFS2 and FFS3 firmware volume
+  it looks for PEIMs in after permanent memory is installed, from that same
+  walk. The HOB lists the FFS files of the firmware volume in the order they
+  appear, so the DXE Core can build its file list without walking the FFS
+  file headers of the firmware volume again.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_FV_FILE_INDEX_HOB_H__
+#define __EDKII_FV_FILE_INDEX_HOB_H__
+
+#define EDKII_FV_FILE_INDEX_HOB_GUID \
+  { \
+    0x4fad4396, 0xfd3d, 0x4592, { 0xb0, 0x91, 0xcd, 0xb8, 0xe1, 0xcc, 0x94, 0xb1 } \
+  }
+
+///
+/// One FFS file of the firmware volume. Deleted files are not listed.
+///
+typedef struct {
+  EFI_GUID                  Name;         // FFS file name
+  UINT32                    Offset;       // Offset of the FFS file header from the FV base
+  UINT32                    Size;         // FFS file size, including the FFS file header
+  EFI_FV_FILETYPE           Type;         // FFS file type
+  EFI_FFS_FILE_ATTRIBUTES   Attributes;   // FFS file attributes
+  UINT8                     Reserved[2];
+} EDKII_FV_FILE_INDEX_ENTRY;
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS      FvBase;       // Base address of the firmware volume
+  UINT64                    FvLength;     // Length of the firmware volume
+  UINT16                    FvChecksum;   // Checksum field of the firmware volume header
+  UINT16                    Reserved;
+  UINT32                    FileCount;    // Number of EDKII_FV_FILE_INDEX_ENTRY that follow
+//EDKII_FV_FILE_INDEX_ENTRY File[FileCount];
+} EDKII_FV_FILE_INDEX;
+
+extern EFI_GUID gEdkiiFvFileIndexHobGuid;
+
+#endif // #ifndef __EDKII_FV_FILE_INDEX_HOB_H__
@@ -23,7 +23,35 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into chunks that
+/// are compressed independently using LZMA, so they can be decompressed in parallel.
+///
+#define LZMA_MULTI_CHUNK_CUSTOM_DECOMPRESS_GUID  \
+  { 0xFD11FD4F, 0xBE9F, 0x4E7B, { 0xA5, 0x09, 0xC1, 0xF4, 0xB1, 0xC4, 0x90, 0x92 } }
+
+#define LZMA_MULTI_CHUNK_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'M', 'C')
+
+///
+/// Header of the data of an LZMA multi-chunk GUIDed section.
+///
+/// The header is followed by ChunkCount + 1 UINT32 offsets, relative to the
+/// start of the header, in ascending order. Chunk N spans from offset N up to
+/// offset N + 1 and is a complete LZMA stream, including its own 13 byte
+/// header. Every chunk decodes to ChunkSize bytes, except the last one which
+/// decodes to the rest of DecodedSize.
+///
+typedef struct {
+  UINT32  Signature;
+  UINT32  ChunkCount;
+  UINT32  ChunkSize;
+  UINT32  Reserved;
+  UINT64  DecodedSize;
+} LZMA_MULTI_CHUNK_HEADER;
+
 extern GUID gLzmaCustomDecompressGuid;
 extern GUID gLzmaF86CustomDecompressGuid;
+extern GUID gLzmaMultiChunkCustomDecompressGuid;
 
 #endif
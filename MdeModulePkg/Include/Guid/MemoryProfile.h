@@ -179,6 +179,20 @@ typedef struct {
   //MEMORY_PROFILE_DESCRIPTOR     MemoryDescriptor[MemoryRangeCount];
 } MEMORY_PROFILE_MEMORY_RANGE;
 
+//
+// Pool slab occupancy of the DXE core, by the same memory type index as
+// CurrentTotalUsageByType. SlabSizeByType is the size of the pages backing
+// the pool slabs, and SlabUsageByType the size of the slab blocks in use.
+//
+#define MEMORY_PROFILE_POOL_SLAB_SIGNATURE SIGNATURE_32 ('M','P','P','S')
+#define MEMORY_PROFILE_POOL_SLAB_REVISION 0x0001
+
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER  Header;
+  UINT64                        SlabSizeByType[EfiMaxMemoryType + 2];
+  UINT64                        SlabUsageByType[EfiMaxMemoryType + 2];
+} MEMORY_PROFILE_POOL_SLAB;
+
 //
 // UEFI memory profile layout:
 // +--------------------------------+
@@ -196,6 +210,8 @@ typedef struct {
 // +--------------------------------+
 // | ALLOC_INFO(n, mn)              |
 // +--------------------------------+
+// | POOL_SLAB                      |
+// +--------------------------------+
 //
 
 typedef struct _EDKII_MEMORY_PROFILE_PROTOCOL EDKII_MEMORY_PROFILE_PROTOCOL;
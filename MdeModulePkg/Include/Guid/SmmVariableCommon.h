@@ -72,11 +72,20 @@ typedef struct {
 //
 #define SMM_VARIABLE_FUNCTION_INIT_RUNTIME_VARIABLE_CACHE_CONTEXT   12
 
+//
+// The payload for this function is optional. If it is large enough for
+// SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT, the flush count is
+// returned in it.
+//
 #define SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE                    13
 //
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO                14
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS
+//
+#define SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS                15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -147,4 +156,31 @@ typedef struct {
   BOOLEAN                 AuthenticatedVariableUsage;
 } SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO;
 
+#define SMM_VARIABLE_RUNTIME_CACHE_FLUSH_COUNT_VERSION  1
+
+///
+/// This structure is returned by SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE.
+///
+/// FlushCount is the number of flushes that moved variables within the
+/// runtime caches, e.g. after a reclaim. Such updates are only flushed
+/// on request of SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE, so the caller
+/// learns about every move of the cache contents. The caller zeroes the
+/// structure, Version stays 0 if the handler does not return the count.
+///
+typedef struct {
+  UINT32                  Version;
+  UINT32                  FlushCount;
+} SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT;
+
+///
+/// This structure is used to communicate with SMI handler by GetReclaimStatistics.
+/// It reports the flash usage of the reclaims of the non-volatile variable store.
+///
+typedef struct {
+  UINT32                  ReclaimCount;
+  UINT32                  Reserved;
+  UINT64                  LastRewrittenSize;    // Size in bytes of the FVB blocks rewritten by the last reclaim
+  UINT64                  TotalRewrittenSize;   // Size in bytes of the FVB blocks rewritten by all reclaims
+} SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS;
+
 #endif // _SMM_VARIABLE_COMMON_H_
@@ -0,0 +1,147 @@
+/** @file
+  LZMA multi-chunk Decompress GUIDed Section Extraction Library, DXE part.
+
+  The chunks are spread over the processors with EFI_MP_SERVICES_PROTOCOL once
+  it is installed. The application processors are run in non-blocking mode,
+  so the BSP decodes a share of the chunks alongside them. Sections extracted
+  before the protocol is installed are decoded on the BSP alone.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaMultiChunkDecompressLibInternal.h"
+
+#include <Protocol/MpService.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+/**
+  Closes the event passed to StartupAllAPs() once the MP services signal it.
+
+  @param  Event    The event to close.
+  @param  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+LzmaMultiChunkCloseEvent (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  gBS->CloseEvent (Event);
+}
+
+/**
+  Runs Procedure on all enabled application processors.
+
+  The application processors are started in non-blocking mode, so this
+  returns as soon as they have been started, and ApCount is the number of
+  them that will run Procedure. The caller must wait for Procedure to return
+  on all of them before it releases ProcedureArgument. If the MP services do
+  not support non-blocking mode, this returns once Procedure has returned on
+  all of them, and ApCount is 0.
+
+  Procedure must be safe to run on application processors, so it may only
+  touch memory and must not call any PEI or boot service, DEBUG() or ASSERT().
+
+  @param  Procedure         The procedure to run.
+  @param  ProcedureArgument The argument passed to Procedure.
+  @param  ApCount           Returns the number of application processors still
+                            running Procedure in the background.
+
+  @retval EFI_SUCCESS       Procedure has been run or started on all enabled
+                            application processors.
+  @retval Others            Procedure is not run on application processors. This
+                            includes the case where no MP services are available
+                            yet, or where there is no enabled application processor.
+**/
+EFI_STATUS
+LzmaMultiChunkStartupAllAps (
+  IN  EFI_AP_PROCEDURE  Procedure,
+  IN  VOID              *ProcedureArgument,
+  OUT UINTN             *ApCount
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+  EFI_EVENT                 WaitEvent;
+
+  *ApCount = 0;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **) &MpServices);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  if (NumberOfEnabledProcessors < 2) {
+    return EFI_NOT_STARTED;
+  }
+
+  //
+  // Sections are extracted at TPL_NOTIFY, where the MP services can not signal
+  // the event, so the caller waits for the application processors through
+  // ProcedureArgument instead, and the event closes itself once it is
+  // signaled later.
+  //
+  Status = gBS->CreateEvent (EVT_NOTIFY_SIGNAL, TPL_CALLBACK, LzmaMultiChunkCloseEvent, NULL, &WaitEvent);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = MpServices->StartupAllAPs (
+                         MpServices,
+                         Procedure,
+                         FALSE,
+                         WaitEvent,
+                         0,
+                         ProcedureArgument,
+                         NULL
+                         );
+  if (!EFI_ERROR (Status)) {
+    *ApCount = NumberOfEnabledProcessors - 1;
+    return EFI_SUCCESS;
+  }
+
+  gBS->CloseEvent (WaitEvent);
+  if (Status != EFI_UNSUPPORTED) {
+    return Status;
+  }
+
+  return MpServices->StartupAllAPs (
+                       MpServices,
+                       Procedure,
+                       FALSE,
+                       NULL,
+                       0,
+                       ProcedureArgument,
+                       NULL
+                       );
+}
+
+/**
+  Register the LZMA multi-chunk decompress handlers with
+  gLzmaMultiChunkCustomDecompressGuid.
+
+  @param  ImageHandle  The firmware allocated handle for the EFI image.
+  @param  SystemTable  A pointer to the EFI System Table.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+DxeLzmaMultiChunkDecompressLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return LzmaMultiChunkRegisterHandlers ();
+}
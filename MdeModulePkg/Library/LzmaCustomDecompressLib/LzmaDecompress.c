@@ -192,6 +192,10 @@ LzmaUefiDecompress (
   SizeT             EncodedDataSize;
   ISzAllocWithData  AllocFuncs;
 
+  if (SourceSize < LZMA_HEADER_SIZE) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
   AllocFuncs.Functions.Alloc  = SzAlloc;
   AllocFuncs.Functions.Free   = SzFree;
   AllocFuncs.Buffer           = Scratch;
@@ -219,3 +223,40 @@ LzmaUefiDecompress (
   }
 }
 
+/**
+  Checks the LZMA properties at the start of a Lzma compressed source buffer.
+
+  The properties are valid if the SDK accepts them and their probability
+  model fits a scratch buffer of the size returned by
+  LzmaUefiDecompressGetInfo(). The model is built in Scratch, which is
+  otherwise left for the caller to use.
+
+  @param  Header      The first LZMA_PROPS_SIZE bytes of the compressed data.
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS           The properties are valid.
+  @retval  RETURN_INVALID_PARAMETER The properties are not valid.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaUefiDecompressCheckProperties (
+  IN CONST VOID  *Header,
+  IN OUT VOID    *Scratch
+  )
+{
+  CLzmaDec          Decoder;
+  ISzAllocWithData  AllocFuncs;
+
+  AllocFuncs.Functions.Alloc  = SzAlloc;
+  AllocFuncs.Functions.Free   = SzFree;
+  AllocFuncs.Buffer           = Scratch;
+  AllocFuncs.BufferSize       = SCRATCH_BUFFER_REQUEST_SIZE;
+
+  LzmaDec_Construct (&Decoder);
+  if (LzmaDec_AllocateProbs (&Decoder, Header, LZMA_PROPS_SIZE, &AllocFuncs.Functions) != SZ_OK) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
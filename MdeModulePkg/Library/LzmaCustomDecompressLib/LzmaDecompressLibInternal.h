@@ -91,5 +91,27 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Checks the LZMA properties at the start of a Lzma compressed source buffer.
+
+  The properties are valid if the SDK accepts them and their probability
+  model fits a scratch buffer of the size returned by
+  LzmaUefiDecompressGetInfo(). The model is built in Scratch, which is
+  otherwise left for the caller to use.
+
+  @param  Header      The first LZMA_PROPS_SIZE bytes of the compressed data.
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS           The properties are valid.
+  @retval  RETURN_INVALID_PARAMETER The properties are not valid.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaUefiDecompressCheckProperties (
+  IN CONST VOID  *Header,
+  IN OUT VOID    *Scratch
+  );
+
 #endif
 
@@ -0,0 +1,511 @@
+/** @file
+  LZMA multi-chunk Decompress GUIDed Section Extraction Library.
+
+  The data of an LZMA multi-chunk GUIDed section is a set of LZMA streams that
+  each decode to a fixed size part of the output, see LZMA_MULTI_CHUNK_HEADER.
+  The chunks are independent, so the BSP and the application processors take
+  the next chunk from a shared counter until all of them have been decoded.
+  The BSP decodes all of them when no MP services are available.
+
+  The chunk headers are checked on the BSP before the application processors
+  are started, so the code they run cannot fail an ASSERT() or need DEBUG().
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaMultiChunkDecompressLibInternal.h"
+
+//
+// State shared by all processors decoding one section.
+//
+typedef struct {
+  CONST UINT8       *Data;
+  CONST UINT32      *ChunkOffset;
+  UINT32            ChunkCount;
+  UINT32            ChunkSize;
+  UINT32            DecodedSize;
+  UINT8             *Destination;
+  UINT8             *Scratch;
+  UINT32            ScratchSize;
+  UINT32            WorkerCount;
+  volatile UINT32   NextWorker;
+  volatile UINT32   NextChunk;
+  volatile UINT32   DoneChunks;
+  volatile UINT32   FinishedAps;
+  volatile BOOLEAN  Failed;
+} LZMA_MULTI_CHUNK_CONTEXT;
+
+/**
+  Locates the data of an LZMA multi-chunk GUIDed section.
+
+  @param  InputSection      A pointer to a GUIDed section of an FFS formatted file.
+  @param  Data              Returns a pointer to the data of the section.
+  @param  DataSize          Returns the size, in bytes, of the data of the section.
+  @param  SectionAttribute  Returns the attributes of the section. Optional.
+
+  @retval RETURN_SUCCESS            The data of the section was returned.
+  @retval RETURN_INVALID_PARAMETER  InputSection is not an LZMA multi-chunk GUIDed section.
+**/
+STATIC
+RETURN_STATUS
+LzmaMultiChunkGetSectionData (
+  IN  CONST VOID   *InputSection,
+  OUT CONST UINT8  **Data,
+  OUT UINT32       *DataSize,
+  OUT UINT16       *SectionAttribute  OPTIONAL
+  )
+{
+  UINT32  SectionSize;
+  UINT16  DataOffset;
+  UINT16  Attributes;
+
+  if (IS_SECTION2 (InputSection)) {
+    if (!CompareGuid (
+        &gLzmaMultiChunkCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    SectionSize = SECTION2_SIZE (InputSection);
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+    Attributes  = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->Attributes;
+  } else {
+    if (!CompareGuid (
+        &gLzmaMultiChunkCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    SectionSize = SECTION_SIZE (InputSection);
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+    Attributes  = ((EFI_GUID_DEFINED_SECTION *) InputSection)->Attributes;
+  }
+
+  if (DataOffset > SectionSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Data     = (CONST UINT8 *) InputSection + DataOffset;
+  *DataSize = SectionSize - DataOffset;
+  if (SectionAttribute != NULL) {
+    *SectionAttribute = Attributes;
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  Checks the header and chunk offset table of LZMA multi-chunk data.
+
+  @param  Data      The data of an LZMA multi-chunk GUIDed section.
+  @param  DataSize  The size, in bytes, of Data.
+
+  @retval RETURN_SUCCESS            The header and all chunk offsets are consistent.
+  @retval RETURN_INVALID_PARAMETER  Data is not valid LZMA multi-chunk data.
+  @retval RETURN_UNSUPPORTED        The decoded size does not fit in a UINT32.
+**/
+STATIC
+RETURN_STATUS
+LzmaMultiChunkCheckHeader (
+  IN CONST UINT8  *Data,
+  IN UINT32       DataSize
+  )
+{
+  CONST LZMA_MULTI_CHUNK_HEADER  *Header;
+  CONST UINT32                   *ChunkOffset;
+  UINT64                         DecodedSize;
+  UINT32                         Index;
+
+  Header = (CONST LZMA_MULTI_CHUNK_HEADER *) Data;
+  if (DataSize < sizeof (*Header) + 2 * sizeof (UINT32) ||
+      Header->Signature != LZMA_MULTI_CHUNK_SIGNATURE) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  DecodedSize = ReadUnaligned64 (&Header->DecodedSize);
+  if (DecodedSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if (Header->ChunkCount == 0 ||
+      Header->ChunkSize == 0 ||
+      Header->ChunkCount != (UINT32) DivU64x32 (DecodedSize + Header->ChunkSize - 1, Header->ChunkSize) ||
+      Header->ChunkCount > (DataSize - sizeof (*Header)) / sizeof (UINT32) - 1) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Every chunk has to be at least an LZMA stream header long, and the chunks
+  // have to follow the offset table in order without leaving the section.
+  //
+  ChunkOffset = (CONST UINT32 *) (Header + 1);
+  if (ChunkOffset[0] < sizeof (*Header) + (Header->ChunkCount + 1) * sizeof (UINT32) ||
+      ChunkOffset[Header->ChunkCount] > DataSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if (ChunkOffset[Index + 1] < ChunkOffset[Index] ||
+        ChunkOffset[Index + 1] - ChunkOffset[Index] < LZMA_CHUNK_HEADER_SIZE) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Checks the LZMA stream header of every chunk of an LZMA multi-chunk section.
+
+  Every chunk must decode to exactly its share of the output, so that it
+  cannot overwrite its neighbours, and must use the LZMA properties of the
+  first chunk, so that its probability model fits the scratch buffer.
+
+  @param  Context  The context of the section.
+
+  @retval RETURN_SUCCESS            All chunk headers are consistent.
+  @retval RETURN_INVALID_PARAMETER  A chunk header is not.
+**/
+STATIC
+RETURN_STATUS
+LzmaMultiChunkCheckChunks (
+  IN CONST LZMA_MULTI_CHUNK_CONTEXT  *Context
+  )
+{
+  CONST UINT8  *Chunk;
+  UINT32       Index;
+  UINT32       ExpectedSize;
+
+  for (Index = 0; Index < Context->ChunkCount; Index++) {
+    Chunk        = Context->Data + Context->ChunkOffset[Index];
+    ExpectedSize = MIN (Context->ChunkSize, Context->DecodedSize - Index * Context->ChunkSize);
+    if (CompareMem (Chunk, Context->Data + Context->ChunkOffset[0], LZMA_CHUNK_PROPERTIES_SIZE) != 0 ||
+        ReadUnaligned64 ((CONST UINT64 *) (Chunk + LZMA_CHUNK_PROPERTIES_SIZE)) != ExpectedSize) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decodes chunks of an LZMA multi-chunk section until none is left.
+
+  This runs on the BSP and on the application processors at the same time, so
+  it only touches the shared context and its own part of the scratch buffer.
+  The chunk headers have been checked by LzmaMultiChunkCheckChunks().
+
+  @param  Context  The context of the section.
+  @param  Worker   The index of the scratch buffer to use.
+**/
+STATIC
+VOID
+LzmaMultiChunkDecodeChunks (
+  IN OUT LZMA_MULTI_CHUNK_CONTEXT  *Context,
+  IN     UINT32                    Worker
+  )
+{
+  UINT32         Chunk;
+  UINT32         Offset;
+  UINT32         Length;
+  RETURN_STATUS  Status;
+
+  while (!Context->Failed) {
+    Chunk = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Chunk >= Context->ChunkCount) {
+      break;
+    }
+
+    Offset = Context->ChunkOffset[Chunk];
+    Length = Context->ChunkOffset[Chunk + 1] - Offset;
+    Status = LzmaUefiDecompress (
+               Context->Data + Offset,
+               Length,
+               Context->Destination + Chunk * Context->ChunkSize,
+               Context->Scratch + Worker * Context->ScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      Context->Failed = TRUE;
+      break;
+    }
+
+    InterlockedIncrement (&Context->DoneChunks);
+  }
+}
+
+/**
+  Application processor procedure decoding chunks of an LZMA multi-chunk section.
+
+  Scratch buffer 0 belongs to the BSP, the application processors take the
+  others in the order they arrive. Processors beyond the number of scratch
+  buffers have nothing to do. Each processor counts itself out of the context
+  last, as the BSP may release the context as soon as all have done so.
+
+  @param  Buffer  The LZMA_MULTI_CHUNK_CONTEXT of the section.
+**/
+STATIC
+VOID
+EFIAPI
+LzmaMultiChunkApProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_MULTI_CHUNK_CONTEXT  *Context;
+  UINT32                    Worker;
+
+  Context = (LZMA_MULTI_CHUNK_CONTEXT *) Buffer;
+  Worker  = InterlockedIncrement (&Context->NextWorker);
+  if (Worker < Context->WorkerCount) {
+    LzmaMultiChunkDecodeChunks (Context, Worker);
+  }
+
+  InterlockedIncrement (&Context->FinishedAps);
+}
+
+/**
+  Returns the number of scratch buffers used to decode LZMA multi-chunk data.
+
+  @param  Header  The header of the LZMA multi-chunk data.
+
+  @return The number of scratch buffers, which bounds the number of processors
+          decoding the section at the same time.
+**/
+STATIC
+UINT32
+LzmaMultiChunkGetWorkerCount (
+  IN CONST LZMA_MULTI_CHUNK_HEADER  *Header
+  )
+{
+  return MIN (Header->ChunkCount, LZMA_MULTI_CHUNK_MAX_WORKERS);
+}
+
+/**
+  Examines a GUIDed section and returns the size of the decoded buffer and the
+  size of an scratch buffer required to actually decode the data in a GUIDed section.
+
+  Examines a GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports,
+  then RETURN_UNSUPPORTED is returned.
+  If the required information can not be retrieved from InputSection,
+  then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports,
+  then the size required to hold the decoded buffer is returned in OututBufferSize,
+  the size of an optional scratch buffer is returned in ScratchSize, and the Attributes field
+  from EFI_GUID_DEFINED_SECTION header of InputSection is returned in SectionAttribute.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBufferSize is NULL, then ASSERT().
+  If ScratchBufferSize is NULL, then ASSERT().
+  If SectionAttribute is NULL, then ASSERT().
+
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiChunkGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  RETURN_STATUS                  Status;
+  CONST UINT8                    *Data;
+  UINT32                         DataSize;
+  CONST LZMA_MULTI_CHUNK_HEADER  *Header;
+  CONST UINT32                   *ChunkOffset;
+  UINT32                         DecodedSize;
+  UINT32                         ScratchSize;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  Status = LzmaMultiChunkGetSectionData (InputSection, &Data, &DataSize, SectionAttribute);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaMultiChunkCheckHeader (Data, DataSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // All chunks are LZMA streams with the same properties, so the first one
+  // tells the scratch buffer size each worker needs.
+  //
+  Header      = (CONST LZMA_MULTI_CHUNK_HEADER *) Data;
+  ChunkOffset = (CONST UINT32 *) (Header + 1);
+  Status = LzmaUefiDecompressGetInfo (
+             Data + ChunkOffset[0],
+             ChunkOffset[1] - ChunkOffset[0],
+             &DecodedSize,
+             &ScratchSize
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  *OutputBufferSize  = (UINT32) ReadUnaligned64 (&Header->DecodedSize);
+  *ScratchBufferSize = ScratchSize * LzmaMultiChunkGetWorkerCount (Header);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress an LZMA multi-chunk GUIDed section into a caller allocated output buffer.
+
+  Decodes the GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports, then RETURN_UNSUPPORTED is returned.
+  If the data in InputSection can not be decoded, then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports, then InputSection
+  is decoded into the buffer specified by OutputBuffer and the authentication status of this
+  decode operation is returned in AuthenticationStatus.  If the decoded buffer is identical to the
+  data in InputSection, then OutputBuffer is set to point at the data in InputSection.  Otherwise,
+  the decoded data will be placed in caller allocated buffer specified by OutputBuffer.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBuffer is NULL, then ASSERT().
+  If ScratchBuffer is NULL and this decode operation requires a scratch buffer, then ASSERT().
+  If AuthenticationStatus is NULL, then ASSERT().
+
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+                            See the definition of authentication status in the EFI_PEI_GUIDED_SECTION_EXTRACTION_PPI
+                            section of the PI Specification. EFI_AUTH_STATUS_PLATFORM_OVERRIDE must
+                            never be set by this handler.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiChunkGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer,        OPTIONAL
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  RETURN_STATUS                  Status;
+  CONST UINT8                    *Data;
+  UINT32                         DataSize;
+  CONST LZMA_MULTI_CHUNK_HEADER  *Header;
+  LZMA_MULTI_CHUNK_CONTEXT       Context;
+  UINT32                         DecodedSize;
+  UINTN                          ApCount;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  Status = LzmaMultiChunkGetSectionData (InputSection, &Data, &DataSize, NULL);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaMultiChunkCheckHeader (Data, DataSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Header = (CONST LZMA_MULTI_CHUNK_HEADER *) Data;
+  ZeroMem (&Context, sizeof (Context));
+  Context.Data        = Data;
+  Context.ChunkOffset = (CONST UINT32 *) (Header + 1);
+  Context.ChunkCount  = Header->ChunkCount;
+  Context.ChunkSize   = Header->ChunkSize;
+  Context.DecodedSize = (UINT32) ReadUnaligned64 (&Header->DecodedSize);
+  Context.Destination = *OutputBuffer;
+  Context.Scratch     = ScratchBuffer;
+  Context.WorkerCount = LzmaMultiChunkGetWorkerCount (Header);
+
+  Status = LzmaUefiDecompressGetInfo (
+             Data + Context.ChunkOffset[0],
+             Context.ChunkOffset[1] - Context.ChunkOffset[0],
+             &DecodedSize,
+             &Context.ScratchSize
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaMultiChunkCheckChunks (&Context);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Check that the LZMA properties of the first chunk are valid and that their
+  // probability model fits the scratch buffer. All chunks share them.
+  //
+  Status = LzmaUefiDecompressCheckProperties (Data + Context.ChunkOffset[0], Context.Scratch);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Start the application processors and decode chunks on the BSP alongside
+  // them. A single chunk is not worth waking them up.
+  //
+  ApCount = 0;
+  if (Context.WorkerCount > 1 &&
+      EFI_ERROR (LzmaMultiChunkStartupAllAps (LzmaMultiChunkApProcedure, &Context, &ApCount))) {
+    ApCount = 0;
+  }
+  LzmaMultiChunkDecodeChunks (&Context, 0);
+
+  //
+  // The context is on this stack, so the application processors still running
+  // in the background must be done with it before this returns.
+  //
+  while (Context.FinishedAps < ApCount) {
+    CpuPause ();
+  }
+
+  if (Context.Failed || Context.DoneChunks != Context.ChunkCount) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Authentication is set to Zero, which may be ignored.
+  //
+  *AuthenticationStatus = 0;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Register the LZMA multi-chunk GetInfo and Decode handlers with
+  gLzmaMultiChunkCustomDecompressGuid.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+RETURN_STATUS
+LzmaMultiChunkRegisterHandlers (
+  VOID
+  )
+{
+  return ExtractGuidedSectionRegisterHandlers (
+           &gLzmaMultiChunkCustomDecompressGuid,
+           LzmaMultiChunkGuidedSectionGetInfo,
+           LzmaMultiChunkGuidedSectionExtraction
+           );
+}
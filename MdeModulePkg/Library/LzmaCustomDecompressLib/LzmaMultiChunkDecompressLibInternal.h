@@ -0,0 +1,121 @@
+/** @file
+  LZMA multi-chunk Decompress GUIDed Section Extraction Library internal header.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __LZMA_MULTI_CHUNK_DECOMPRESS_LIB_INTERNAL_H__
+#define __LZMA_MULTI_CHUNK_DECOMPRESS_LIB_INTERNAL_H__
+
+#include "LzmaDecompressLibInternal.h"
+
+#include <Library/SynchronizationLib.h>
+
+//
+// Upper bound of the number of processors decoding one section. Each of them
+// needs its own scratch buffer.
+//
+#define LZMA_MULTI_CHUNK_MAX_WORKERS  64
+
+//
+// Every chunk is an LZMA stream, which starts with the 5 bytes of LZMA
+// properties followed by the 64-bit decoded size.
+//
+#define LZMA_CHUNK_PROPERTIES_SIZE    5
+#define LZMA_CHUNK_HEADER_SIZE        (LZMA_CHUNK_PROPERTIES_SIZE + 8)
+
+/**
+  Runs Procedure on all enabled application processors.
+
+  When the MP services can run the application processors in the background,
+  this returns as soon as they have been started, and ApCount is the number
+  of application processors that will run Procedure. The caller must wait
+  for Procedure to return on all of them before it releases
+  ProcedureArgument. Otherwise this returns once Procedure has returned on
+  all of them, and ApCount is 0.
+
+  Procedure must be safe to run on application processors, so it may only
+  touch memory and must not call any PEI or boot service, DEBUG() or ASSERT().
+
+  @param  Procedure         The procedure to run.
+  @param  ProcedureArgument The argument passed to Procedure.
+  @param  ApCount           Returns the number of application processors still
+                            running Procedure in the background.
+
+  @retval EFI_SUCCESS       Procedure has been run or started on all enabled
+                            application processors.
+  @retval Others            Procedure is not run on application processors. This
+                            includes the case where no MP services are available
+                            yet, or where there is no enabled application processor.
+**/
+EFI_STATUS
+LzmaMultiChunkStartupAllAps (
+  IN  EFI_AP_PROCEDURE  Procedure,
+  IN  VOID              *ProcedureArgument,
+  OUT UINTN             *ApCount
+  );
+
+/**
+  Examines a GUIDed section and returns the size of the decoded buffer and the
+  size of an scratch buffer required to actually decode the data in a GUIDed section.
+
+  @param  InputSection      A pointer to a GUIDed section of an FFS formatted file.
+  @param  OutputBufferSize  A pointer to the size, in bytes, of an output buffer required
+                            if the buffer specified by InputSection were decoded.
+  @param  ScratchBufferSize A pointer to the size, in bytes, required as scratch space
+                            if the buffer specified by InputSection were decoded.
+  @param  SectionAttribute  A pointer to the attributes of the GUIDed section. See the Attributes
+                            field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiChunkGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  );
+
+/**
+  Decompress an LZMA multi-chunk GUIDed section into a caller allocated output
+  buffer, spreading the chunks over all processors.
+
+  @param  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param  OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param  ScratchBuffer A caller allocated buffer that may be required by this function
+                        as a scratch buffer to perform the decode operation.
+  @param  AuthenticationStatus
+                        A pointer to the authentication status of the decoded output buffer.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiChunkGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer,        OPTIONAL
+  OUT       UINT32  *AuthenticationStatus
+  );
+
+/**
+  Register the LZMA multi-chunk GetInfo and Decode handlers with
+  gLzmaMultiChunkCustomDecompressGuid.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+RETURN_STATUS
+LzmaMultiChunkRegisterHandlers (
+  VOID
+  );
+
+#endif
@@ -0,0 +1,88 @@
+/** @file
+  LZMA multi-chunk Decompress GUIDed Section Extraction Library, PEI part.
+
+  The chunks are spread over the processors with EFI_PEI_MP_SERVICES_PPI.
+  That PPI only runs the application processors in blocking mode, so the BSP
+  waits for them to decode the chunks instead of decoding a share of them.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaMultiChunkDecompressLibInternal.h"
+
+#include <Ppi/MpServices.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+
+/**
+  Runs Procedure on all enabled application processors.
+
+  EFI_PEI_MP_SERVICES_PPI has no non-blocking mode, so this returns once
+  Procedure has returned on all of them, and ApCount is always 0.
+
+  Procedure must be safe to run on application processors, so it may only
+  touch memory and must not call any PEI or boot service, DEBUG() or ASSERT().
+
+  @param  Procedure         The procedure to run.
+  @param  ProcedureArgument The argument passed to Procedure.
+  @param  ApCount           Returns the number of application processors still
+                            running Procedure in the background.
+
+  @retval EFI_SUCCESS       Procedure has been run or started on all enabled
+                            application processors.
+  @retval Others            Procedure is not run on application processors. This
+                            includes the case where no MP services are available
+                            yet, or where there is no enabled application processor.
+**/
+EFI_STATUS
+LzmaMultiChunkStartupAllAps (
+  IN  EFI_AP_PROCEDURE  Procedure,
+  IN  VOID              *ProcedureArgument,
+  OUT UINTN             *ApCount
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  *ApCount = 0;
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiMpServicesPpiGuid,
+             0,
+             NULL,
+             (VOID **) &MpServices
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return MpServices->StartupAllAPs (
+                       GetPeiServicesTablePointer (),
+                       MpServices,
+                       Procedure,
+                       FALSE,
+                       0,
+                       ProcedureArgument
+                       );
+}
+
+/**
+  Register the LZMA multi-chunk decompress handlers with
+  gLzmaMultiChunkCustomDecompressGuid.
+
+  @param  FileHandle   The handle of FFS header the loaded driver.
+  @param  PeiServices  The pointer to the PEI services.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+PeiLzmaMultiChunkDecompressLibConstructor (
+  IN EFI_PEI_FILE_HANDLE     FileHandle,
+  IN CONST EFI_PEI_SERVICES  **PeiServices
+  )
+{
+  return LzmaMultiChunkRegisterHandlers ();
+}
@@ -0,0 +1,536 @@
+/** @file
+  Unit tests and decode throughput benchmark of LzmaCustomDecompressLib.
+
+  The unit tests decode a small embedded LZMA stream.  When the host
+  application is given file names on the command line, each file is scanned
+  for LZMA custom decompress GUIDed sections (for example an OVMF FV image
+  such as FVMAIN_COMPACT.Fv).  Every section found is decoded repeatedly and
+  its decode throughput is reported.  A file without such sections is decoded
+  as a raw LZMA stream, as produced by BaseTools LzmaCompress.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "LzmaDecompressLibInternal.h"
+
+#define UNIT_TEST_APP_NAME        "LzmaCustomDecompressLib Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+//
+// Each benchmarked section is decoded at least this many times, and for at
+// least BENCHMARK_MIN_CLOCKS of processor time.
+//
+#define BENCHMARK_MIN_ITERATIONS  3
+#define BENCHMARK_MIN_CLOCKS      (CLOCKS_PER_SEC / 2)
+
+//
+// Size of the plain text encoded in mLzmaTestStream.
+//
+#define TEST_DATA_SIZE            8192
+
+//
+// LZMA properties followed by the 64-bit decoded size.
+//
+#define LZMA_STREAM_HEADER_SIZE   13
+
+//
+// LZMA encoding of the data produced by GenerateTestData (), with the
+// 13 byte header (5 bytes of properties and the 64-bit decoded size).
+//
+STATIC CONST UINT8  mLzmaTestStream[] = {
+  0x5d, 0x00, 0x00, 0x00, 0x02, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x22, 0x91, 0x85, 0x52, 0x96, 0x51, 0x01, 0xc2, 0x78, 0x6a,
+  0x39, 0x13, 0x27, 0x21, 0xb3, 0x43, 0x28, 0xaf, 0x5b, 0x50, 0xc2, 0x44,
+  0x89, 0x08, 0xfd, 0x68, 0xe0, 0x13, 0xfe, 0x4d, 0x26, 0xad, 0xdc, 0xd3,
+  0xf0, 0xed, 0x4a, 0xfc, 0x23, 0x16, 0x15, 0x98, 0xdb, 0x76, 0xfc, 0xb5,
+  0x1c, 0x15, 0xbc, 0xab, 0x8e, 0x84, 0x6e, 0xdc, 0xe8, 0x6e, 0xed, 0x99,
+  0x12, 0x70, 0x50, 0x7c, 0x93, 0xcc, 0xab, 0x2e, 0xe4, 0xbd, 0x0b, 0x6c,
+  0xe2, 0x34, 0xa3, 0x89, 0x56, 0x0e, 0x00, 0xdc, 0x9a, 0x8c, 0x71, 0x5a,
+  0xb4, 0xb7, 0xc7, 0xa3, 0x6f, 0x3c, 0x7e, 0x05, 0x47, 0x39, 0x06, 0x8e,
+  0x11, 0x4f, 0x52, 0xba, 0x44, 0xf0, 0xb2, 0xd5, 0x06, 0x7e, 0x8e, 0xf3,
+  0xdb, 0x97, 0x48, 0x9c, 0x44, 0x81, 0xe5, 0xc5, 0x12, 0xbb, 0xd0, 0xa8,
+  0x6e, 0xd9, 0xb2, 0x3e, 0xd8, 0xa5, 0x34, 0x32, 0x14, 0x06, 0x12, 0x54,
+  0xe6, 0x73, 0x80, 0x23, 0x4e, 0x7a, 0x28, 0x64, 0x85, 0xb8, 0x9d, 0x8f,
+  0x2e, 0x59, 0x6c, 0x69, 0x00, 0xfc, 0xb9, 0x3c, 0xed, 0xa0, 0x59, 0xa9,
+  0xe2, 0x8d, 0xc4, 0x20, 0x1e, 0xd1, 0x82, 0xe3, 0x05, 0x9b, 0x6a, 0x6e,
+  0x04, 0x6e, 0xb2, 0x00, 0x2d, 0x87, 0x9a, 0xd9, 0xc0, 0xb2, 0xbd, 0x01,
+  0x63, 0x84, 0x53, 0xba, 0xc1, 0x39, 0x22, 0x09, 0x0b, 0x1f, 0xb8, 0x3f,
+  0xa1, 0x23, 0x98, 0x05, 0x11, 0xf7, 0x32, 0x4d, 0x4d, 0xef, 0xbd, 0x7e,
+  0xa0, 0xea, 0x1e, 0x1a, 0xa8, 0x98, 0x98, 0xb3, 0x92, 0xfe, 0xcb, 0xef,
+  0xa0, 0x68, 0x0f, 0xab, 0x24, 0x8c, 0xeb, 0xef, 0xb8, 0x8e, 0xc4, 0x83,
+  0x99, 0x35, 0x21, 0xda, 0xeb, 0xcb, 0x3b, 0xff, 0x7b, 0x36, 0xda, 0xe4,
+  0xb0, 0x72, 0x41, 0x63, 0x7c, 0x75, 0xa3, 0x30, 0x26, 0x97, 0x3b, 0x94,
+  0xc6, 0x57, 0x5b, 0x72, 0x92, 0x50, 0xac, 0xba, 0x67, 0x20, 0xc1, 0x4d,
+  0x6f, 0x5b, 0x15, 0x07, 0x8e, 0x5d, 0xf9, 0xa2, 0x81, 0xa5, 0xa0, 0x93,
+  0x39, 0xf1, 0x25, 0xee, 0xc9, 0xc7, 0x0d, 0xb3, 0x74, 0x30, 0x8d, 0xe1,
+  0xbf, 0x6e, 0xe4, 0x13, 0x97, 0x1d, 0xd6, 0x3b, 0x2b, 0xf1, 0x2a, 0x1c,
+  0x11, 0x8e, 0x7a, 0x09, 0x55, 0x9e, 0xc1, 0x59, 0xe7, 0xa1, 0xe8, 0x1f,
+  0xc3, 0xc5, 0x28, 0x65, 0x92, 0xa1, 0x86, 0x4d, 0x32, 0xb9, 0xdb, 0xd6,
+  0xf3, 0xc3, 0x1a, 0x47, 0xe8, 0xb1, 0x29, 0x17, 0x68, 0x12, 0x84, 0x54,
+  0xe2, 0x1e, 0xf0, 0x68, 0xa4, 0x47, 0x3a, 0x45, 0x65, 0xc1, 0xb6, 0x76,
+  0x26, 0xf5, 0x7f, 0x5d, 0xa7, 0x8d, 0x8d, 0xb9, 0xb7, 0x25, 0xe9, 0x0d,
+  0x4f, 0x8e, 0xcf, 0x3b, 0x64, 0xc7, 0x08, 0xde, 0x2c, 0x22, 0x12, 0x1c,
+  0xed, 0x1f, 0x40, 0xa6, 0x8d, 0xa3, 0xa0, 0xbf, 0xc2, 0xb7, 0x75, 0xd9,
+  0x01, 0x1f, 0x69, 0x1e, 0x40, 0x16, 0x65, 0xd3, 0x1c, 0xab, 0x78, 0xb6,
+  0xf6, 0xd8, 0x4f, 0x3e, 0x20, 0xb7, 0xa4, 0x60, 0xe8, 0xde, 0xfb, 0xc5,
+  0xd5, 0xf0, 0xc0, 0x25, 0x04, 0x09, 0x8f, 0xd0, 0xfe, 0xff, 0x23, 0x67,
+  0x17, 0x02, 0xd8, 0xed, 0xb1, 0x57, 0xca, 0xde, 0x0a, 0xae, 0x5d, 0x4b,
+  0xb5, 0xf3, 0x87, 0x9c, 0x53, 0xeb, 0xf8, 0xb2, 0x28, 0x92, 0xd2, 0xe8,
+  0x3a, 0x0e, 0xdc, 0x87, 0x6a, 0xe8, 0xae, 0x96, 0xa2, 0x96, 0x19, 0x26,
+  0x6d, 0xdc, 0xac, 0x6f, 0xdb, 0x92, 0xe2, 0x53, 0xdb, 0x77, 0xcc, 0xa4,
+  0x89, 0xc7, 0x8e, 0x65, 0x61, 0x01, 0x88, 0xb5, 0x38, 0x7a, 0x58, 0x65,
+  0xb9, 0xc7, 0x80, 0xff, 0x1a, 0x13, 0xb5, 0xbc, 0x44, 0x8e, 0x4a, 0x00
+};
+
+/**
+  Fill a buffer with the plain text encoded in mLzmaTestStream.
+
+  @param[out]  Buffer  The buffer of TEST_DATA_SIZE bytes to fill.
+**/
+STATIC
+VOID
+GenerateTestData (
+  OUT UINT8  *Buffer
+  )
+{
+  CHAR8  Record[33];
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_DATA_SIZE / 32; Index++) {
+    snprintf (Record, sizeof (Record), "EFI_FIRMWARE_VOLUME_HEADER %04x ", (unsigned)((Index * 37) & 0xFFFF));
+    CopyMem (Buffer + Index * 32, Record, 32);
+  }
+}
+
+/**
+  LzmaUefiDecompressGetInfo should report the size recorded in the header
+  and a non-zero scratch buffer size.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetInfoShouldReturnHeaderSizes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+
+  Status = LzmaUefiDecompressGetInfo (mLzmaTestStream, sizeof (mLzmaTestStream), &DestinationSize, &ScratchSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (DestinationSize, TEST_DATA_SIZE);
+  UT_ASSERT_NOT_EQUAL (ScratchSize, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  LzmaUefiDecompress should reproduce the original data.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DecompressShouldReproduceTheData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  UINT8          *Destination;
+  UINT8          *Scratch;
+  UINT8          Expected[TEST_DATA_SIZE];
+
+  Status = LzmaUefiDecompressGetInfo (mLzmaTestStream, sizeof (mLzmaTestStream), &DestinationSize, &ScratchSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Destination = AllocatePool (DestinationSize);
+  Scratch     = AllocatePool (ScratchSize);
+  UT_ASSERT_NOT_NULL (Destination);
+  UT_ASSERT_NOT_NULL (Scratch);
+
+  Status = LzmaUefiDecompress (mLzmaTestStream, sizeof (mLzmaTestStream), Destination, Scratch);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  GenerateTestData (Expected);
+  UT_ASSERT_MEM_EQUAL (Destination, Expected, TEST_DATA_SIZE);
+
+  FreePool (Scratch);
+  FreePool (Destination);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  LzmaUefiDecompress should fail on a truncated stream.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DecompressShouldRejectTruncatedData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  UINT8          *Destination;
+  UINT8          *Scratch;
+
+  Status = LzmaUefiDecompressGetInfo (mLzmaTestStream, sizeof (mLzmaTestStream), &DestinationSize, &ScratchSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Destination = AllocatePool (DestinationSize);
+  Scratch     = AllocatePool (ScratchSize);
+  UT_ASSERT_NOT_NULL (Destination);
+  UT_ASSERT_NOT_NULL (Scratch);
+
+  Status = LzmaUefiDecompress (mLzmaTestStream, sizeof (mLzmaTestStream) / 2, Destination, Scratch);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_INVALID_PARAMETER);
+
+  FreePool (Scratch);
+  FreePool (Destination);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  LzmaUefiDecompress should reject a header with invalid properties.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DecompressShouldRejectInvalidProperties (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  UINT8          *Destination;
+  UINT8          *Scratch;
+  UINT8          *Source;
+
+  Status = LzmaUefiDecompressGetInfo (mLzmaTestStream, sizeof (mLzmaTestStream), &DestinationSize, &ScratchSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Destination = AllocatePool (DestinationSize);
+  Scratch     = AllocatePool (ScratchSize);
+  Source      = AllocateCopyPool (sizeof (mLzmaTestStream), mLzmaTestStream);
+  UT_ASSERT_NOT_NULL (Destination);
+  UT_ASSERT_NOT_NULL (Scratch);
+  UT_ASSERT_NOT_NULL (Source);
+
+  Status = LzmaUefiDecompressCheckProperties (Source, Scratch);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  //
+  // lc, lp and pb are encoded as (pb * 5 + lp) * 9 + lc, so 225 and above
+  // are invalid.
+  //
+  Source[0] = 225;
+  Status = LzmaUefiDecompressCheckProperties (Source, Scratch);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_INVALID_PARAMETER);
+  Status = LzmaUefiDecompress (Source, sizeof (mLzmaTestStream), Destination, Scratch);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_INVALID_PARAMETER);
+
+  FreePool (Source);
+  FreePool (Scratch);
+  FreePool (Destination);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Decode one LZMA stream repeatedly and print its decode throughput.
+
+  @param[in]  Name        Name printed for the stream.
+  @param[in]  Source      The LZMA stream, starting with its 13 byte header.
+  @param[in]  SourceSize  The size of the LZMA stream in bytes.
+
+  @retval  TRUE   The stream was decoded.
+  @retval  FALSE  The stream could not be decoded.
+**/
+STATIC
+BOOLEAN
+BenchmarkStream (
+  IN CONST CHAR8  *Name,
+  IN CONST UINT8  *Source,
+  IN UINTN        SourceSize
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  UINT8          *Destination;
+  UINT8          *Scratch;
+  UINTN          Iterations;
+  clock_t        Start;
+  clock_t        Elapsed;
+  double         Seconds;
+
+  if (SourceSize < LZMA_STREAM_HEADER_SIZE || SourceSize > MAX_UINT32) {
+    return FALSE;
+  }
+
+  Status = LzmaUefiDecompressGetInfo (Source, (UINT32)SourceSize, &DestinationSize, &ScratchSize);
+  if (RETURN_ERROR (Status) || DestinationSize == 0) {
+    return FALSE;
+  }
+
+  Destination = AllocatePool (DestinationSize);
+  Scratch     = AllocatePool (ScratchSize);
+  if (Destination == NULL || Scratch == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  Iterations = 0;
+  Start      = clock ();
+  do {
+    Status = LzmaUefiDecompress (Source, SourceSize, Destination, Scratch);
+    if (RETURN_ERROR (Status)) {
+      goto Done;
+    }
+    Iterations++;
+    Elapsed = clock () - Start;
+  } while (Iterations < BENCHMARK_MIN_ITERATIONS || Elapsed < BENCHMARK_MIN_CLOCKS);
+
+  Seconds = (double)Elapsed / CLOCKS_PER_SEC / Iterations;
+  printf (
+    "%s: %u -> %u bytes, %.2f ms, %.1f MB/s\n",
+    Name,
+    (unsigned)SourceSize,
+    (unsigned)DestinationSize,
+    Seconds * 1000.0,
+    DestinationSize / Seconds / 1000000.0
+    );
+
+Done:
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+  if (Destination != NULL) {
+    FreePool (Destination);
+  }
+  return (BOOLEAN)!RETURN_ERROR (Status);
+}
+
+/**
+  Benchmark every LZMA custom decompress GUIDed section of a file, or the
+  whole file as a raw LZMA stream if it contains no such section.
+
+  @param[in]  FileName  The file to benchmark.
+
+  @retval  EFI_SUCCESS           At least one stream was decoded.
+  @retval  EFI_NOT_FOUND         The file could not be read.
+  @retval  EFI_OUT_OF_RESOURCES  The file could not be buffered.
+  @retval  EFI_VOLUME_CORRUPTED  No stream of the file could be decoded.
+**/
+STATIC
+EFI_STATUS
+BenchmarkFile (
+  IN CONST CHAR8  *FileName
+  )
+{
+  FILE                     *File;
+  UINT8                    *Buffer;
+  long                     FileSize;
+  UINTN                    Offset;
+  UINTN                    SectionSize;
+  UINTN                    Decoded;
+  UINT8                    *Section;
+  EFI_GUID_DEFINED_SECTION *GuidSection;
+  CHAR8                    Name[256];
+
+  File = fopen (FileName, "rb");
+  if (File == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Buffer = NULL;
+  if (fseek (File, 0, SEEK_END) != 0 || (FileSize = ftell (File)) <= 0 || fseek (File, 0, SEEK_SET) != 0) {
+    fclose (File);
+    return EFI_NOT_FOUND;
+  }
+
+  Buffer = AllocatePool ((UINTN)FileSize);
+  if (Buffer == NULL) {
+    fclose (File);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (fread (Buffer, 1, (size_t)FileSize, File) != (size_t)FileSize) {
+    fclose (File);
+    FreePool (Buffer);
+    return EFI_NOT_FOUND;
+  }
+  fclose (File);
+
+  //
+  // GUIDed sections are 4 byte aligned within their FFS file, so only aligned
+  // candidates need to be considered.  A section whose size does not fit in
+  // the 24-bit Size field uses EFI_COMMON_SECTION_HEADER2 instead.
+  //
+  Decoded = 0;
+  for (Offset = 0; Offset + sizeof (EFI_GUID_DEFINED_SECTION2) <= (UINTN)FileSize; Offset += 4) {
+    Section = Buffer + Offset;
+    if (((EFI_COMMON_SECTION_HEADER *)Section)->Type != EFI_SECTION_GUID_DEFINED) {
+      continue;
+    }
+
+    if (IS_SECTION2 (Section)) {
+      SectionSize = SECTION2_SIZE (Section);
+      if (!CompareGuid (&((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid, &gLzmaCustomDecompressGuid)) {
+        continue;
+      }
+    } else {
+      SectionSize = SECTION_SIZE (Section);
+      if (!CompareGuid (&((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid, &gLzmaCustomDecompressGuid)) {
+        continue;
+      }
+    }
+
+    //
+    // DataOffset and Attributes sit at the same offset from the GUID in both
+    // header layouts.
+    //
+    GuidSection = (EFI_GUID_DEFINED_SECTION *)(Section + (IS_SECTION2 (Section) ? sizeof (UINT32) : 0));
+    if (SectionSize > (UINTN)FileSize - Offset || GuidSection->DataOffset >= SectionSize) {
+      continue;
+    }
+
+    snprintf (Name, sizeof (Name), "%s+0x%x", FileName, (unsigned)Offset);
+    if (BenchmarkStream (Name, Section + GuidSection->DataOffset, SectionSize - GuidSection->DataOffset)) {
+      Decoded++;
+      Offset += ALIGN_VALUE (SectionSize, 4) - 4;
+    }
+  }
+
+  if (Decoded == 0 && BenchmarkStream (FileName, Buffer, (UINTN)FileSize)) {
+    Decoded++;
+  }
+
+  FreePool (Buffer);
+  return (Decoded != 0) ? EFI_SUCCESS : EFI_VOLUME_CORRUPTED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for
+  LzmaCustomDecompressLib and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DecompressTests;
+
+  Framework = NULL;
+
+  DEBUG(( DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+      goto EXIT;
+  }
+
+  //
+  // Populate the LzmaCustomDecompressLib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&DecompressTests, Framework, "LzmaCustomDecompressLib Decompress Tests", "LzmaCustomDecompressLib.Decompress", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DecompressTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (DecompressTests, "GetInfo should return the sizes from the header", "GetInfo", GetInfoShouldReturnHeaderSizes, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "Decompress should reproduce the original data", "Decompress", DecompressShouldReproduceTheData, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "Decompress should reject a truncated stream", "Truncated", DecompressShouldRejectTruncatedData, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "Decompress should reject invalid properties", "InvalidProperties", DecompressShouldRejectInvalidProperties, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  Any arguments are files to benchmark after the unit tests have run.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  EFI_STATUS  Status;
+  int         Index;
+
+  Status = UnitTestingEntry ();
+  for (Index = 1; Index < argc && !EFI_ERROR (Status); Index++) {
+    Status = BenchmarkFile (argv[Index]);
+    if (EFI_ERROR (Status)) {
+      printf ("%s: %s\n", argv[Index], (Status == EFI_NOT_FOUND) ? "cannot be read" : "no LZMA stream could be decoded");
+    }
+  }
+
+  return EFI_ERROR (Status) ? 1 : 0;
+}
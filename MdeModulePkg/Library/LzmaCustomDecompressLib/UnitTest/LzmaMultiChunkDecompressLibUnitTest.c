@@ -0,0 +1,635 @@
+/** @file
+  Unit tests of the LZMA multi-chunk GUIDed section extraction library.
+
+  The embedded section data was produced by BaseTools LzmaCompress with
+  --multi-chunk and decodes to the text made by GenerateTestData (). It is
+  decoded with the library on the BSP alone, and with application
+  processors, which are simulated by running the AP procedure before
+  LzmaMultiChunkStartupAllAps () returns. When the host application is given
+  a file compressed with LzmaCompress --multi-chunk and the original file on
+  the command line, the compressed file is decoded and compared as well.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "LzmaMultiChunkDecompressLibInternal.h"
+
+#define UNIT_TEST_APP_NAME        "LzmaMultiChunkDecompressLib Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+//
+// Size of the plain text encoded in mLzmaMultiChunkTestData.
+//
+#define TEST_DATA_SIZE            8192
+
+//
+// mLzmaMultiChunkTestData holds 4 chunks of 2048 bytes, which start at
+// these offsets.
+//
+#define TEST_CHUNK_COUNT          4
+#define TEST_CHUNK1_OFFSET        260
+#define TEST_CHUNK2_OFFSET        485
+
+//
+// Output of LzmaCompress -e --multi-chunk --chunk-size 2048 for the data
+// produced by GenerateTestData ().
+//
+STATIC CONST UINT8  mLzmaMultiChunkTestData[] = {
+  0x4c, 0x5a, 0x4d, 0x43, 0x04, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x2c, 0x00, 0x00, 0x00, 0x04, 0x01, 0x00, 0x00, 0xe5, 0x01, 0x00, 0x00,
+  0xc2, 0x02, 0x00, 0x00, 0xa4, 0x03, 0x00, 0x00, 0x5d, 0x00, 0x00, 0x00,
+  0x01, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x91,
+  0x85, 0x52, 0x96, 0x51, 0x01, 0xc2, 0x78, 0x6a, 0x39, 0x13, 0x27, 0x21,
+  0xb3, 0x43, 0x28, 0xaf, 0x5b, 0x50, 0xc2, 0x44, 0x89, 0x08, 0xfd, 0x68,
+  0xe0, 0x13, 0xfe, 0x4d, 0x26, 0xad, 0xdc, 0xd3, 0xf0, 0xed, 0x4a, 0xfc,
+  0x23, 0x16, 0x15, 0x98, 0xdb, 0x76, 0xfc, 0xb5, 0x1c, 0x15, 0xbc, 0xab,
+  0x8e, 0x84, 0x6e, 0xdc, 0xe8, 0x6e, 0xed, 0x99, 0x12, 0x70, 0x50, 0x7c,
+  0x93, 0xcc, 0xab, 0x2e, 0xe4, 0xbd, 0x0b, 0x6c, 0xe2, 0x34, 0xa3, 0x89,
+  0x56, 0x0e, 0x00, 0xdc, 0x9a, 0x8c, 0x71, 0x5a, 0xb4, 0xb7, 0xc7, 0xa3,
+  0x6f, 0x3c, 0x7e, 0x05, 0x47, 0x39, 0x06, 0x8e, 0x11, 0x4f, 0x52, 0xba,
+  0x44, 0xf0, 0xb2, 0xd5, 0x06, 0x7e, 0x8e, 0xf3, 0xdb, 0x97, 0x48, 0x9c,
+  0x44, 0x81, 0xe5, 0xc5, 0x12, 0xbb, 0xd0, 0xa8, 0x6e, 0xd9, 0xb2, 0x3e,
+  0xd8, 0xa5, 0x34, 0x32, 0x14, 0x06, 0x12, 0x54, 0xe6, 0x73, 0x80, 0x23,
+  0x4e, 0x7a, 0x28, 0x64, 0x85, 0xb8, 0x9d, 0x8f, 0x2e, 0x59, 0x6c, 0x69,
+  0x00, 0xfc, 0xb9, 0x3c, 0xed, 0xa0, 0x59, 0xa9, 0xe2, 0x8d, 0xc4, 0x20,
+  0x1e, 0xd1, 0x82, 0xe3, 0x05, 0x9b, 0x6a, 0x6e, 0x04, 0x6e, 0xb2, 0x00,
+  0x2d, 0x87, 0x9a, 0xd9, 0xc0, 0xb2, 0xbd, 0x01, 0x63, 0x84, 0x53, 0xba,
+  0xc1, 0x39, 0x22, 0x09, 0x0b, 0x1f, 0xb8, 0x3f, 0xa1, 0x23, 0x98, 0x05,
+  0x11, 0xf7, 0x32, 0x4b, 0xc6, 0xaa, 0x9e, 0x1f, 0x5d, 0x00, 0x00, 0x00,
+  0x01, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x91,
+  0x85, 0x52, 0x96, 0x51, 0x01, 0xc2, 0x78, 0x6a, 0x39, 0x13, 0x27, 0x21,
+  0xb3, 0x43, 0x28, 0xaf, 0x5b, 0x50, 0xc2, 0x44, 0x89, 0x08, 0xfd, 0x68,
+  0xe0, 0x12, 0x80, 0x86, 0x40, 0x99, 0xa7, 0x1b, 0xfd, 0xaf, 0x15, 0x55,
+  0xe4, 0xc1, 0xdf, 0xbd, 0xed, 0x3f, 0x1e, 0xc7, 0xff, 0x19, 0x4b, 0xb1,
+  0x2d, 0x26, 0x34, 0x31, 0xfb, 0x00, 0x53, 0x44, 0xec, 0x3d, 0xac, 0xc7,
+  0x4c, 0x4c, 0xe9, 0xe6, 0x92, 0x6a, 0x58, 0x8d, 0x8d, 0xbb, 0xc3, 0x7b,
+  0x18, 0x94, 0xeb, 0x93, 0x84, 0x7d, 0xd0, 0x76, 0x82, 0x77, 0xc5, 0x6c,
+  0xdc, 0x41, 0x5c, 0xe8, 0x46, 0x73, 0x82, 0x4e, 0x82, 0x9a, 0xbf, 0xd6,
+  0xfd, 0xc1, 0xb4, 0x18, 0xaa, 0x19, 0x0b, 0x4a, 0x99, 0x9c, 0x82, 0xd9,
+  0x81, 0x87, 0x90, 0x2e, 0xb4, 0x2e, 0x5c, 0xce, 0x11, 0x17, 0xf1, 0x0d,
+  0x4e, 0x63, 0x69, 0xe3, 0xd3, 0xcf, 0x19, 0xa4, 0x29, 0xa0, 0x98, 0xe0,
+  0x81, 0xa2, 0xb6, 0xaf, 0xe4, 0x00, 0x0b, 0x9c, 0xe7, 0x79, 0xdf, 0x2b,
+  0x29, 0xdc, 0xd8, 0x29, 0x51, 0x02, 0x3e, 0xfd, 0x5d, 0x6f, 0xfe, 0x02,
+  0xc4, 0xa1, 0x9d, 0xc0, 0x5d, 0xaa, 0x96, 0xc8, 0xb0, 0xf7, 0xc0, 0xcb,
+  0xbf, 0x79, 0x54, 0x54, 0x35, 0x5e, 0x0f, 0x5b, 0x3d, 0x0a, 0xe7, 0x8b,
+  0x44, 0x14, 0xbe, 0x92, 0xbe, 0x2e, 0x18, 0x19, 0xe4, 0x7e, 0x63, 0xcc,
+  0x1f, 0x3e, 0x5c, 0x65, 0xf5, 0x63, 0xb0, 0x7f, 0x4c, 0xbd, 0x3f, 0x0d,
+  0x1e, 0xcb, 0x6b, 0xd1, 0x00, 0x5d, 0x00, 0x00, 0x00, 0x01, 0x00, 0x08,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x91, 0x85, 0x52, 0x96,
+  0x51, 0x01, 0xc2, 0x78, 0x6a, 0x39, 0x13, 0x27, 0x21, 0xb3, 0x43, 0x28,
+  0xaf, 0x5b, 0x50, 0xc2, 0x44, 0x89, 0x08, 0xfd, 0x68, 0xe0, 0x14, 0x4a,
+  0x83, 0x36, 0x63, 0xe5, 0x3c, 0x53, 0x28, 0x71, 0xd1, 0x58, 0x56, 0xdd,
+  0x15, 0xcd, 0x55, 0xfc, 0x7d, 0xf1, 0x40, 0xf2, 0x4f, 0x84, 0x25, 0xcd,
+  0xc5, 0xa4, 0xb6, 0xeb, 0xa9, 0xad, 0xdc, 0x95, 0x7b, 0xc8, 0x52, 0x74,
+  0x00, 0xfb, 0xbd, 0x50, 0x35, 0x57, 0xaf, 0x31, 0x64, 0xbb, 0x9a, 0xa6,
+  0x47, 0x24, 0xd9, 0x10, 0xae, 0x0a, 0x7a, 0x61, 0x06, 0x2e, 0x15, 0xff,
+  0x82, 0x58, 0x87, 0xcb, 0x1d, 0x50, 0x88, 0xf9, 0x38, 0x6b, 0xa2, 0xf7,
+  0x74, 0x5a, 0xd1, 0x06, 0x56, 0xa7, 0x22, 0xa4, 0xa1, 0xc3, 0xa3, 0x4b,
+  0x48, 0x13, 0x6e, 0x21, 0xdd, 0x06, 0x33, 0x73, 0x8d, 0xb8, 0x27, 0x42,
+  0x7e, 0xde, 0xfb, 0xbe, 0x23, 0x57, 0x0c, 0x66, 0x1a, 0x14, 0x3e, 0xfa,
+  0x69, 0x73, 0x8d, 0x90, 0x1e, 0x7a, 0xe0, 0x2b, 0x73, 0x14, 0x7e, 0xcd,
+  0x54, 0x26, 0x6f, 0xf9, 0x04, 0x99, 0xa4, 0xc6, 0xcc, 0xac, 0xd7, 0x34,
+  0x96, 0x7a, 0xd0, 0x4c, 0xf6, 0xaa, 0xdd, 0x06, 0xa8, 0xf5, 0xdd, 0xb6,
+  0xf3, 0x46, 0xe4, 0xa8, 0xab, 0x5f, 0xc2, 0x84, 0xea, 0x12, 0xae, 0xbd,
+  0x93, 0x33, 0x95, 0x36, 0x49, 0x44, 0xee, 0x75, 0x43, 0x65, 0x89, 0x47,
+  0x79, 0x05, 0x51, 0x96, 0x39, 0x06, 0xda, 0xc4, 0x2e, 0xb9, 0x5d, 0x00,
+  0x00, 0x00, 0x01, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x22, 0x91, 0x85, 0x52, 0x96, 0x51, 0x01, 0xc2, 0x78, 0x6a, 0x39, 0x13,
+  0x27, 0x21, 0xb3, 0x43, 0x28, 0xaf, 0x5b, 0x50, 0xc2, 0x44, 0x89, 0x08,
+  0xfd, 0x68, 0xe0, 0x14, 0x7b, 0xbc, 0x3a, 0x5e, 0x7a, 0xcc, 0xc7, 0x17,
+  0x2d, 0x4d, 0xb9, 0x16, 0x42, 0x91, 0x3b, 0x88, 0x68, 0x93, 0x7d, 0xae,
+  0x97, 0x19, 0x28, 0xbc, 0x68, 0xb7, 0x37, 0x64, 0x7c, 0x17, 0x79, 0x57,
+  0x57, 0x7c, 0xc4, 0x49, 0x04, 0x35, 0x57, 0xea, 0x41, 0x99, 0x51, 0x18,
+  0xde, 0xf4, 0x85, 0x4e, 0xba, 0xfd, 0x83, 0xc3, 0xbe, 0x3e, 0x18, 0x6f,
+  0x65, 0x81, 0xa6, 0x5e, 0xe3, 0xf3, 0xa5, 0x71, 0x4c, 0xae, 0xdf, 0xd3,
+  0xe3, 0x5d, 0x07, 0x8b, 0xf8, 0x81, 0x75, 0xe8, 0xd3, 0x16, 0x6e, 0xac,
+  0x87, 0xfb, 0x34, 0x8e, 0xa9, 0x07, 0xb9, 0x95, 0x01, 0xe2, 0xf3, 0xeb,
+  0x5d, 0x58, 0xe7, 0xa0, 0x0a, 0xa2, 0xca, 0xa2, 0xd4, 0x6a, 0x78, 0x45,
+  0x1b, 0x0b, 0x27, 0xb0, 0x47, 0xc7, 0x7f, 0x6a, 0x7e, 0xb1, 0xf1, 0xdf,
+  0x40, 0xa7, 0x3d, 0x28, 0x7d, 0xf8, 0xcf, 0x93, 0x7b, 0xce, 0x55, 0x6f,
+  0xa4, 0x64, 0x7a, 0x3f, 0xec, 0x81, 0x61, 0xaf, 0x0f, 0xc5, 0x27, 0x9f,
+  0x3d, 0xd4, 0x17, 0x6f, 0x39, 0xe5, 0xea, 0x2b, 0x9f, 0xde, 0x26, 0x30,
+  0xa3, 0x07, 0x21, 0xf7, 0x19, 0x6b, 0xa5, 0xeb, 0x27, 0xce, 0x76, 0x76,
+  0xda, 0x71, 0x2a, 0x49, 0x48, 0xb9, 0x28, 0xc5, 0x69, 0x84, 0x93, 0x10,
+  0x79, 0x69, 0x86, 0x29, 0x60, 0x26, 0x20, 0x68
+};
+
+//
+// Number of application processors LzmaMultiChunkStartupAllAps () simulates,
+// 0 for no MP services, and the number of times it has been called.
+//
+STATIC UINTN  mSimulatedApCount;
+STATIC UINTN  mStartupAllApsCalls;
+
+/**
+  Runs Procedure once for each simulated application processor, and reports
+  them as still running in the background.
+
+  @param  Procedure         The procedure to run.
+  @param  ProcedureArgument The argument passed to Procedure.
+  @param  ApCount           Returns the number of simulated application processors.
+
+  @retval EFI_SUCCESS       Procedure has run on the simulated application processors.
+  @retval EFI_NOT_STARTED   No application processor is simulated.
+**/
+EFI_STATUS
+LzmaMultiChunkStartupAllAps (
+  IN  EFI_AP_PROCEDURE  Procedure,
+  IN  VOID              *ProcedureArgument,
+  OUT UINTN             *ApCount
+  )
+{
+  UINTN  Index;
+
+  mStartupAllApsCalls++;
+  *ApCount = 0;
+  if (mSimulatedApCount == 0) {
+    return EFI_NOT_STARTED;
+  }
+
+  for (Index = 0; Index < mSimulatedApCount; Index++) {
+    Procedure (ProcedureArgument);
+  }
+
+  *ApCount = mSimulatedApCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  The handlers are called directly by the tests, so registering them does
+  nothing.
+**/
+RETURN_STATUS
+EFIAPI
+ExtractGuidedSectionRegisterHandlers (
+  IN CONST  GUID                                     *SectionGuid,
+  IN        EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER  GetInfoHandler,
+  IN        EXTRACT_GUIDED_SECTION_DECODE_HANDLER    DecodeHandler
+  )
+{
+  return RETURN_SUCCESS;
+}
+
+/**
+  Fill a buffer with the plain text encoded in mLzmaMultiChunkTestData.
+
+  @param[out]  Buffer  The buffer of TEST_DATA_SIZE bytes to fill.
+**/
+STATIC
+VOID
+GenerateTestData (
+  OUT UINT8  *Buffer
+  )
+{
+  CHAR8  Record[33];
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_DATA_SIZE / 32; Index++) {
+    snprintf (Record, sizeof (Record), "EFI_FIRMWARE_VOLUME_HEADER %04x ", (unsigned)((Index * 37) & 0xFFFF));
+    CopyMem (Buffer + Index * 32, Record, 32);
+  }
+}
+
+/**
+  Wrap LZMA multi-chunk data in an LZMA multi-chunk GUIDed section.
+
+  @param[in]  Data      The LZMA multi-chunk data.
+  @param[in]  DataSize  The size of Data in bytes.
+
+  @return  The section, to be freed with FreePool (), or NULL if it could not
+           be allocated.
+**/
+STATIC
+VOID *
+CreateSection (
+  IN CONST UINT8  *Data,
+  IN UINTN        DataSize
+  )
+{
+  EFI_GUID_DEFINED_SECTION2  *Section;
+  UINTN                      HeaderSize;
+
+  //
+  // A section of 0xFFFFFF bytes or more needs the extended size field.
+  //
+  HeaderSize = (sizeof (EFI_GUID_DEFINED_SECTION) + DataSize < 0xFFFFFF) ?
+               sizeof (EFI_GUID_DEFINED_SECTION) : sizeof (EFI_GUID_DEFINED_SECTION2);
+  Section = AllocateZeroPool (HeaderSize + DataSize);
+  if (Section == NULL) {
+    return NULL;
+  }
+
+  if (HeaderSize == sizeof (EFI_GUID_DEFINED_SECTION)) {
+    ((EFI_GUID_DEFINED_SECTION *)Section)->CommonHeader.Type = EFI_SECTION_GUID_DEFINED;
+    ((EFI_GUID_DEFINED_SECTION *)Section)->CommonHeader.Size[0] = (UINT8)(HeaderSize + DataSize);
+    ((EFI_GUID_DEFINED_SECTION *)Section)->CommonHeader.Size[1] = (UINT8)((HeaderSize + DataSize) >> 8);
+    ((EFI_GUID_DEFINED_SECTION *)Section)->CommonHeader.Size[2] = (UINT8)((HeaderSize + DataSize) >> 16);
+    CopyGuid (&((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid, &gLzmaMultiChunkCustomDecompressGuid);
+    ((EFI_GUID_DEFINED_SECTION *)Section)->DataOffset = (UINT16)HeaderSize;
+    ((EFI_GUID_DEFINED_SECTION *)Section)->Attributes = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+  } else {
+    Section->CommonHeader.Type = EFI_SECTION_GUID_DEFINED;
+    SetMem (Section->CommonHeader.Size, sizeof (Section->CommonHeader.Size), 0xFF);
+    Section->CommonHeader.ExtendedSize = (UINT32)(HeaderSize + DataSize);
+    CopyGuid (&Section->SectionDefinitionGuid, &gLzmaMultiChunkCustomDecompressGuid);
+    Section->DataOffset = (UINT16)HeaderSize;
+    Section->Attributes = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+  }
+
+  CopyMem ((UINT8 *)Section + HeaderSize, Data, DataSize);
+  return Section;
+}
+
+/**
+  Decode an LZMA multi-chunk GUIDed section with the library.
+
+  @param[in]   Section          The section.
+  @param[out]  Destination      Returns the decoded data, to be freed with
+                                FreePool ().
+  @param[out]  DestinationSize  Returns the size of the decoded data.
+
+  @return  The status returned by the library.
+**/
+STATIC
+RETURN_STATUS
+DecodeSection (
+  IN  CONST VOID  *Section,
+  OUT UINT8       **Destination,
+  OUT UINT32      *DestinationSize
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         ScratchSize;
+  UINT16         Attributes;
+  UINT32         AuthenticationStatus;
+  VOID           *Scratch;
+
+  *Destination = NULL;
+  Status = LzmaMultiChunkGuidedSectionGetInfo (Section, DestinationSize, &ScratchSize, &Attributes);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  *Destination = AllocatePool (*DestinationSize);
+  Scratch      = AllocatePool (ScratchSize);
+  if (*Destination == NULL || Scratch == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+  } else {
+    Status = LzmaMultiChunkGuidedSectionExtraction (Section, (VOID **)Destination, Scratch, &AuthenticationStatus);
+  }
+
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+  return Status;
+}
+
+/**
+  Decode the embedded section with Context simulated application processors
+  and check the result.
+
+  @param[in]  Context  The number of simulated application processors.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DecodeShouldReproduceTheData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  VOID           *Section;
+  UINT8          *Destination;
+  UINT32         DestinationSize;
+  UINT8          Expected[TEST_DATA_SIZE];
+
+  mSimulatedApCount   = (UINTN)Context;
+  mStartupAllApsCalls = 0;
+
+  Section = CreateSection (mLzmaMultiChunkTestData, sizeof (mLzmaMultiChunkTestData));
+  UT_ASSERT_NOT_NULL (Section);
+
+  Status = DecodeSection (Section, &Destination, &DestinationSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (DestinationSize, TEST_DATA_SIZE);
+  UT_ASSERT_EQUAL (mStartupAllApsCalls, 1);
+
+  GenerateTestData (Expected);
+  UT_ASSERT_MEM_EQUAL (Destination, Expected, TEST_DATA_SIZE);
+
+  FreePool (Destination);
+  FreePool (Section);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  GetInfo should report one scratch buffer per chunk, up to the number of
+  processors decoding a section at the same time.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetInfoShouldReturnScratchPerWorker (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  VOID           *Section;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  UINT32         ChunkDestinationSize;
+  UINT32         ChunkScratchSize;
+  UINT16         Attributes;
+
+  Section = CreateSection (mLzmaMultiChunkTestData, sizeof (mLzmaMultiChunkTestData));
+  UT_ASSERT_NOT_NULL (Section);
+
+  Status = LzmaMultiChunkGuidedSectionGetInfo (Section, &DestinationSize, &ScratchSize, &Attributes);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (DestinationSize, TEST_DATA_SIZE);
+  UT_ASSERT_EQUAL (Attributes, EFI_GUIDED_SECTION_PROCESSING_REQUIRED);
+
+  Status = LzmaUefiDecompressGetInfo (
+             mLzmaMultiChunkTestData + TEST_CHUNK1_OFFSET,
+             TEST_CHUNK2_OFFSET - TEST_CHUNK1_OFFSET,
+             &ChunkDestinationSize,
+             &ChunkScratchSize
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ScratchSize, ChunkScratchSize * TEST_CHUNK_COUNT);
+
+  FreePool (Section);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A chunk header that does not match its share of the output, or the LZMA
+  properties of the first chunk, should be rejected before any application
+  processor is started.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DecodeShouldRejectInconsistentChunks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  CorruptOffsets[] = {
+    TEST_CHUNK2_OFFSET + LZMA_CHUNK_PROPERTIES_SIZE,
+    TEST_CHUNK1_OFFSET
+  };
+  RETURN_STATUS       Status;
+  UINT8               Data[sizeof (mLzmaMultiChunkTestData)];
+  VOID                *Section;
+  UINT8               *Destination;
+  UINT32              DestinationSize;
+  UINTN               Index;
+
+  mSimulatedApCount = 2;
+  for (Index = 0; Index < ARRAY_SIZE (CorruptOffsets); Index++) {
+    mStartupAllApsCalls = 0;
+    CopyMem (Data, mLzmaMultiChunkTestData, sizeof (Data));
+    Data[CorruptOffsets[Index]]++;
+
+    Section = CreateSection (Data, sizeof (Data));
+    UT_ASSERT_NOT_NULL (Section);
+
+    Status = DecodeSection (Section, &Destination, &DestinationSize);
+    UT_ASSERT_STATUS_EQUAL (Status, RETURN_INVALID_PARAMETER);
+    UT_ASSERT_EQUAL (mStartupAllApsCalls, 0);
+
+    if (Destination != NULL) {
+      FreePool (Destination);
+    }
+    FreePool (Section);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Read a whole file.
+
+  @param[in]   FileName  The file to read.
+  @param[out]  Size      Returns the size of the file.
+
+  @return  The content of the file, to be freed with FreePool (), or NULL if
+           the file could not be read.
+**/
+STATIC
+UINT8 *
+ReadFile (
+  IN  CONST CHAR8  *FileName,
+  OUT UINTN        *Size
+  )
+{
+  FILE   *File;
+  UINT8  *Buffer;
+  long   FileSize;
+
+  File = fopen (FileName, "rb");
+  if (File == NULL) {
+    return NULL;
+  }
+
+  Buffer = NULL;
+  if (fseek (File, 0, SEEK_END) == 0 && (FileSize = ftell (File)) > 0 && fseek (File, 0, SEEK_SET) == 0) {
+    Buffer = AllocatePool ((UINTN)FileSize);
+    if (Buffer != NULL && fread (Buffer, 1, (size_t)FileSize, File) != (size_t)FileSize) {
+      FreePool (Buffer);
+      Buffer = NULL;
+    }
+    *Size = (UINTN)FileSize;
+  }
+
+  fclose (File);
+  return Buffer;
+}
+
+/**
+  Decode a file compressed with LzmaCompress --multi-chunk and compare it
+  with the original file.
+
+  @param[in]  CompressedFileName  The compressed file.
+  @param[in]  OriginalFileName    The original file.
+
+  @retval  EFI_SUCCESS           The decoded data matches the original file.
+  @retval  EFI_NOT_FOUND         A file could not be read.
+  @retval  EFI_OUT_OF_RESOURCES  The section could not be built.
+  @retval  EFI_VOLUME_CORRUPTED  The decoded data does not match.
+**/
+STATIC
+EFI_STATUS
+RoundTripFile (
+  IN CONST CHAR8  *CompressedFileName,
+  IN CONST CHAR8  *OriginalFileName
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Compressed;
+  UINT8       *Original;
+  UINTN       CompressedSize;
+  UINTN       OriginalSize;
+  VOID        *Section;
+  UINT8       *Destination;
+  UINT32      DestinationSize;
+
+  Compressed = ReadFile (CompressedFileName, &CompressedSize);
+  Original   = ReadFile (OriginalFileName, &OriginalSize);
+  Section    = NULL;
+  Destination = NULL;
+  if (Compressed == NULL || Original == NULL) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
+
+  Section = CreateSection (Compressed, CompressedSize);
+  if (Section == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  mSimulatedApCount = 3;
+  Status = DecodeSection (Section, &Destination, &DestinationSize);
+  if (EFI_ERROR (Status) || DestinationSize != OriginalSize || CompareMem (Destination, Original, OriginalSize) != 0) {
+    Status = EFI_VOLUME_CORRUPTED;
+  }
+
+  printf (
+    "%s: %u bytes, %s %s\n",
+    CompressedFileName,
+    (unsigned)CompressedSize,
+    EFI_ERROR (Status) ? "does not match" : "matches",
+    OriginalFileName
+    );
+
+Done:
+  if (Destination != NULL) {
+    FreePool (Destination);
+  }
+  if (Section != NULL) {
+    FreePool (Section);
+  }
+  if (Original != NULL) {
+    FreePool (Original);
+  }
+  if (Compressed != NULL) {
+    FreePool (Compressed);
+  }
+  return Status;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the LZMA
+  multi-chunk library and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DecodeTests;
+
+  Framework = NULL;
+
+  DEBUG(( DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+      goto EXIT;
+  }
+
+  //
+  // Populate the LZMA multi-chunk Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&DecodeTests, Framework, "LzmaMultiChunkDecompressLib Decode Tests", "LzmaMultiChunkDecompressLib.Decode", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DecodeTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (DecodeTests, "GetInfo should return one scratch buffer per chunk", "GetInfo", GetInfoShouldReturnScratchPerWorker, NULL, NULL, NULL);
+  AddTestCase (DecodeTests, "Decode on the BSP alone should reproduce the data", "BspOnly", DecodeShouldReproduceTheData, NULL, NULL, (UNIT_TEST_CONTEXT)0);
+  AddTestCase (DecodeTests, "Decode with 2 APs should reproduce the data", "TwoAps", DecodeShouldReproduceTheData, NULL, NULL, (UNIT_TEST_CONTEXT)2);
+  AddTestCase (DecodeTests, "Decode with more APs than chunks should reproduce the data", "ManyAps", DecodeShouldReproduceTheData, NULL, NULL, (UNIT_TEST_CONTEXT)(LZMA_MULTI_CHUNK_MAX_WORKERS + 1));
+  AddTestCase (DecodeTests, "Decode should reject inconsistent chunk headers", "BadChunk", DecodeShouldRejectInconsistentChunks, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  The arguments, if any, are a file compressed with LzmaCompress
+  --multi-chunk and the original file, which are checked after the unit tests
+  have run.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  if (!EFI_ERROR (Status) && argc == 3) {
+    Status = RoundTripFile (argv[1], argv[2]);
+  }
+
+  return EFI_ERROR (Status) ? 1 : 0;
+}
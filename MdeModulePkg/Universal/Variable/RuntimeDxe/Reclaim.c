@@ -88,12 +88,19 @@ GetLbaAndOffsetByAddress (
 /**
   Writes a buffer to variable storage space, in the working block.
 
-  This function writes a buffer to variable storage space into a firmware
-  volume block device. The destination is specified by parameter
-  VariableBase. Fault Tolerant Write protocol is used for writing.
+  This function writes a range of a buffer to variable storage space into a
+  firmware volume block device. The destination is specified by parameter
+  VariableBase. Fault Tolerant Write protocol is used for writing, so the
+  range is updated atomically. Only the FVB blocks covered by the range are
+  erased and rewritten.
 
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset in bytes of the range to write, from the
+                         start of the variable store.
+  @param  Length         Length in bytes of the range to write.
+  @param  RewrittenSize  Returns the size in bytes of the FVB blocks that
+                         were rewritten.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -102,17 +109,32 @@ GetLbaAndOffsetByAddress (
 **/
 EFI_STATUS
 FtwVariableSpace (
-  IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN  UINTN                  Offset,
+  IN  UINTN                  Length,
+  OUT UINTN                  *RewrittenSize
   )
 {
   EFI_STATUS                         Status;
   EFI_HANDLE                         FvbHandle;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *Fvb;
   EFI_LBA                            VarLba;
   UINTN                              VarOffset;
+  EFI_LBA                            LastLba;
+  UINTN                              LastOffset;
+  EFI_LBA                            Lba;
+  UINTN                              BlockSize;
+  UINTN                              NumberOfBlocks;
+  UINTN                              BlockMapSize;
   UINTN                              FtwBufferSize;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
 
+  *RewrittenSize = 0;
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Locate fault tolerant write protocol.
   //
@@ -123,20 +145,40 @@ FtwVariableSpace (
   //
   // Locate Fvb handle by address.
   //
-  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, NULL);
+  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, &Fvb);
   if (EFI_ERROR (Status)) {
     return Status;
   }
+
+  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
+  ASSERT (FtwBufferSize == VariableBuffer->Size);
+  ASSERT (Offset + Length <= FtwBufferSize);
+
   //
-  // Get LBA and Offset by address.
+  // Get LBA and Offset of the first and the last byte of the range.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + Offset, &VarLba, &VarOffset);
+  if (EFI_ERROR (Status)) {
+    return EFI_ABORTED;
+  }
+  Status = GetLbaAndOffsetByAddress (VariableBase + Offset + Length - 1, &LastLba, &LastOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
-  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
-  ASSERT (FtwBufferSize == VariableBuffer->Size);
+  //
+  // Add up the sizes of the blocks covered by the range from the block map,
+  // as the blocks of an FVB are not necessarily all of the same size.
+  //
+  BlockMapSize = 0;
+  for (Lba = VarLba; Lba <= LastLba; Lba += NumberOfBlocks) {
+    Status = Fvb->GetBlockSize (Fvb, Lba, &BlockSize, &NumberOfBlocks);
+    if (EFI_ERROR (Status) || NumberOfBlocks == 0) {
+      return EFI_ABORTED;
+    }
+    NumberOfBlocks = (UINTN) MIN ((EFI_LBA) NumberOfBlocks, LastLba - Lba + 1);
+    BlockMapSize  += NumberOfBlocks * BlockSize;
+  }
 
   //
   // FTW write record.
@@ -145,11 +187,14 @@ FtwVariableSpace (
                           FtwProtocol,
                           VarLba,         // LBA
                           VarOffset,      // Offset
-                          FtwBufferSize,  // NumBytes
+                          Length,         // NumBytes
                           NULL,           // PrivateData NULL
                           FvbHandle,      // Fvb Handle
-                          (VOID *) VariableBuffer // write buffer
+                          (UINT8 *) VariableBuffer + Offset // write buffer
                           );
+  if (!EFI_ERROR (Status)) {
+    *RewrittenSize = BlockMapSize;
+  }
 
   return Status;
 }
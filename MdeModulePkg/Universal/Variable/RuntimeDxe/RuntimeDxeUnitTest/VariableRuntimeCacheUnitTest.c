@@ -0,0 +1,354 @@
+/** @file
+  Host based unit tests of the flushes of the variable runtime caches.
+
+  VariableRuntimeCache.c is built into this application unchanged. The SMM
+  variable stores and the runtime caches are plain buffers. The tests check
+  that updates which move variables within the caches are left pending until
+  the consumer requests them, and that the flush count returned to the
+  consumer changes exactly when such an update is flushed.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+
+#include "VariableRuntimeCache.h"
+
+#include <Guid/SmmVariableCommon.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME        "Variable Runtime Cache Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+#define TEST_STORE_SIZE           0x1000
+
+//
+// The variable driver globals used by VariableRuntimeCache.c.
+//
+VARIABLE_MODULE_GLOBAL    *mVariableModuleGlobal;
+VARIABLE_STORE_HEADER     *mNvVariableCache;
+
+STATIC VARIABLE_MODULE_GLOBAL  mTestModuleGlobal;
+STATIC UINT8                   mSmmNvStore[TEST_STORE_SIZE];
+STATIC UINT8                   mSmmVolatileStore[TEST_STORE_SIZE];
+STATIC UINT8                   mRuntimeNvCache[TEST_STORE_SIZE];
+STATIC UINT8                   mRuntimeVolatileCache[TEST_STORE_SIZE];
+STATIC BOOLEAN                 mReadLock;
+STATIC BOOLEAN                 mPendingUpdate;
+STATIC BOOLEAN                 mHobFlushComplete;
+
+/**
+  Fill a buffer with a byte pattern.
+
+  @param[out] Buffer  The buffer to fill.
+  @param[in]  Size    The size of the buffer in bytes.
+  @param[in]  Seed    The first byte of the pattern.
+**/
+STATIC
+VOID
+FillPattern (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size,
+  IN  UINT8  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)(Seed + Index * 7);
+  }
+}
+
+/**
+  Set up the SMM stores and empty runtime caches, as after the runtime cache
+  context was sent to SMM and the initial updates were flushed.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  Always.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetRuntimeCaches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+
+  ZeroMem (&mTestModuleGlobal, sizeof (mTestModuleGlobal));
+  FillPattern (mSmmNvStore, sizeof (mSmmNvStore), 0x11);
+  FillPattern (mSmmVolatileStore, sizeof (mSmmVolatileStore), 0x55);
+  ZeroMem (mRuntimeNvCache, sizeof (mRuntimeNvCache));
+  ZeroMem (mRuntimeVolatileCache, sizeof (mRuntimeVolatileCache));
+
+  mVariableModuleGlobal = &mTestModuleGlobal;
+  mNvVariableCache      = (VARIABLE_STORE_HEADER *)mSmmNvStore;
+  mTestModuleGlobal.VariableGlobal.VolatileVariableBase = (EFI_PHYSICAL_ADDRESS)(UINTN)mSmmVolatileStore;
+
+  mReadLock         = FALSE;
+  mPendingUpdate    = FALSE;
+  mHobFlushComplete = FALSE;
+
+  CacheContext = &mTestModuleGlobal.VariableGlobal.VariableRuntimeCacheContext;
+  CacheContext->ReadLock                           = &mReadLock;
+  CacheContext->PendingUpdate                      = &mPendingUpdate;
+  CacheContext->HobFlushComplete                   = &mHobFlushComplete;
+  CacheContext->VariableRuntimeNvCache.Store       = (VARIABLE_STORE_HEADER *)mRuntimeNvCache;
+  CacheContext->VariableRuntimeVolatileCache.Store = (VARIABLE_STORE_HEADER *)mRuntimeVolatileCache;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Return the flush count as the SMM handler of
+  SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE does.
+
+  @param[out] RuntimeCacheFlushCount  The structure returned to the consumer.
+**/
+STATIC
+VOID
+GetFlushCount (
+  OUT SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT  *RuntimeCacheFlushCount
+  )
+{
+  RuntimeCacheFlushCount->Version    = SMM_VARIABLE_RUNTIME_CACHE_FLUSH_COUNT_VERSION;
+  RuntimeCacheFlushCount->FlushCount = mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.FlushCount;
+}
+
+/**
+  The structures exchanged with SMM hold no pointers to the flush count.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The layout is as expected.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FlushCountShouldBeReturnedByValue (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_EQUAL (sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT), 6 * sizeof (VOID *));
+  UT_ASSERT_EQUAL (sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT), 2 * sizeof (UINT32));
+  UT_ASSERT_EQUAL (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT, Version), 0);
+  UT_ASSERT_EQUAL (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT, FlushCount), sizeof (UINT32));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Updates in place are flushed right away and keep the flush count.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The update was flushed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+UpdatesInPlaceShouldBeFlushedRightAway (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                                          Status;
+  SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT  FlushCount;
+
+  Status = SynchronizeRuntimeVariableCache (
+             &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
+             0x100,
+             0x80
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (mPendingUpdate);
+  UT_ASSERT_MEM_EQUAL (&mRuntimeNvCache[0x100], &mSmmNvStore[0x100], 0x80);
+  UT_ASSERT_EQUAL (mRuntimeNvCache[0x180], 0);
+
+  GetFlushCount (&FlushCount);
+  UT_ASSERT_EQUAL (FlushCount.Version, SMM_VARIABLE_RUNTIME_CACHE_FLUSH_COUNT_VERSION);
+  UT_ASSERT_EQUAL (FlushCount.FlushCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Updates that move variables stay pending until the consumer requests them,
+  and the flush count changes once they are flushed.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The moves were left pending and counted.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MovesShouldBeFlushedOnRequest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                                          Status;
+  VARIABLE_RUNTIME_CACHE_CONTEXT                      *CacheContext;
+  SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT  FlushCount;
+
+  CacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+
+  //
+  // A reclaim of the volatile store marks the update as a move.
+  //
+  CacheContext->PendingMove = TRUE;
+  Status = SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeVolatileCache, 0, TEST_STORE_SIZE);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (mPendingUpdate);
+  UT_ASSERT_EQUAL (mRuntimeVolatileCache[0], 0);
+
+  //
+  // Later updates in place are merged into the pending move.
+  //
+  Status = SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, 0x200, 0x20);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (mPendingUpdate);
+  UT_ASSERT_EQUAL (mRuntimeNvCache[0x200], 0);
+
+  GetFlushCount (&FlushCount);
+  UT_ASSERT_EQUAL (FlushCount.FlushCount, 0);
+
+  //
+  // The consumer sees the pending update and requests the flush.
+  //
+  Status = FlushPendingRuntimeVariableCacheUpdates ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (mPendingUpdate);
+  UT_ASSERT_FALSE (CacheContext->PendingMove);
+  UT_ASSERT_MEM_EQUAL (mRuntimeVolatileCache, mSmmVolatileStore, TEST_STORE_SIZE);
+  UT_ASSERT_MEM_EQUAL (&mRuntimeNvCache[0x200], &mSmmNvStore[0x200], 0x20);
+
+  GetFlushCount (&FlushCount);
+  UT_ASSERT_EQUAL (FlushCount.FlushCount, 1);
+
+  //
+  // Flushing again without a move keeps the count.
+  //
+  Status = SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, 0x300, 0x20);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (mPendingUpdate);
+  GetFlushCount (&FlushCount);
+  UT_ASSERT_EQUAL (FlushCount.FlushCount, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Updates made while the consumer holds the read lock stay pending.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED  The update was left pending.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+UpdatesUnderReadLockShouldStayPending (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                                          Status;
+  SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT  FlushCount;
+
+  mReadLock = TRUE;
+  Status = SynchronizeRuntimeVariableCache (
+             &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
+             0x40,
+             0x10
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (mPendingUpdate);
+  UT_ASSERT_EQUAL (mRuntimeNvCache[0x40], 0);
+
+  mReadLock = FALSE;
+  Status = FlushPendingRuntimeVariableCacheUpdates ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (mPendingUpdate);
+  UT_ASSERT_MEM_EQUAL (&mRuntimeNvCache[0x40], &mSmmNvStore[0x40], 0x10);
+
+  GetFlushCount (&FlushCount);
+  UT_ASSERT_EQUAL (FlushCount.FlushCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the variable
+  runtime cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG(( DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+      goto EXIT;
+  }
+
+  //
+  // Populate the runtime cache Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "Variable Runtime Cache Tests", "Variable.RuntimeCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CacheTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (CacheTests, "Flush count should be returned by value", "ByValue", FlushCountShouldBeReturnedByValue, NULL, NULL, NULL);
+  AddTestCase (CacheTests, "Updates in place should be flushed right away", "InPlace", UpdatesInPlaceShouldBeFlushedRightAway, ResetRuntimeCaches, NULL, NULL);
+  AddTestCase (CacheTests, "Moves should be flushed on request", "Move", MovesShouldBeFlushedOnRequest, ResetRuntimeCaches, NULL, NULL);
+  AddTestCase (CacheTests, "Updates under the read lock should stay pending", "ReadLock", UpdatesUnderReadLockShouldStayPending, ResetRuntimeCaches, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return EFI_ERROR (UnitTestingEntry ()) ? 1 : 0;
+}
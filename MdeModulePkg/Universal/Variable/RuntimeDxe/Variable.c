@@ -538,6 +538,10 @@ Reclaim (
   VARIABLE_HEADER       *UpdatingVariable;
   VARIABLE_HEADER       *UpdatingInDeletedTransition;
   BOOLEAN               AuthFormat;
+  UINTN                 UnchangedSize;
+  UINTN                 UsedSize;
+  UINTN                 WriteEnd;
+  UINTN                 RewrittenSize;
 
   AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable = NULL;
@@ -605,6 +609,7 @@ Reclaim (
   //
   CopyMem (ValidBuffer, VariableStoreHeader, sizeof (VARIABLE_STORE_HEADER));
   CurrPtr = (UINT8 *) GetStartPointer ((VARIABLE_STORE_HEADER *) ValidBuffer);
+  UnchangedSize = (UINTN) CurrPtr - (UINTN) ValidBuffer;
 
   //
   // Reinstall all ADDED variables as long as they are not identical to Updating Variable.
@@ -614,6 +619,12 @@ Reclaim (
     NextVariable = GetNextVariablePtr (Variable, AuthFormat);
     if (Variable != UpdatingVariable && Variable->State == VAR_ADDED) {
       VariableSize = (UINTN) NextVariable - (UINTN) Variable;
+      if ((UINTN) Variable - (UINTN) VariableStoreHeader == (UINTN) CurrPtr - (UINTN) ValidBuffer) {
+        //
+        // No dead byte precedes this variable, it stays in place.
+        //
+        UnchangedSize = (UINTN) NextVariable - (UINTN) VariableStoreHeader;
+      }
       CopyMem (CurrPtr, (UINT8 *) Variable, VariableSize);
       CurrPtr += VariableSize;
       if ((!IsVolatile) && ((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD)) {
@@ -627,6 +638,7 @@ Reclaim (
     }
     Variable = NextVariable;
   }
+  UsedSize = (UINTN) Variable - (UINTN) VariableStoreHeader;
 
   //
   // Reinstall all in delete transition variables.
@@ -742,11 +754,36 @@ Reclaim (
     //
     // If non-volatile variable store, perform FTW here.
     //
+    // The variables before the first dead byte keep their offset, so the FVB
+    // blocks holding only those are left alone. The write ends after both the
+    // old and the new variables, and after any bytes an interrupted write left
+    // in the free space.
+    //
+    UsedSize = MAX (UsedSize, (UINTN) CurrPtr - (UINTN) ValidBuffer);
+    WriteEnd = VariableStoreHeader->Size;
+    while (WriteEnd > UsedSize && ((UINT8 *) VariableStoreHeader)[WriteEnd - 1] == 0xff) {
+      WriteEnd--;
+    }
+
     Status = FtwVariableSpace (
               VariableBase,
-              (VARIABLE_STORE_HEADER *) ValidBuffer
+              (VARIABLE_STORE_HEADER *) ValidBuffer,
+              UnchangedSize,
+              WriteEnd - UnchangedSize,
+              &RewrittenSize
               );
     if (!EFI_ERROR (Status)) {
+      mVariableModuleGlobal->ReclaimStatistics.ReclaimCount++;
+      mVariableModuleGlobal->ReclaimStatistics.LastRewrittenSize   = RewrittenSize;
+      mVariableModuleGlobal->ReclaimStatistics.TotalRewrittenSize += RewrittenSize;
+      DEBUG ((
+        DEBUG_INFO,
+        "Variable driver: reclaim #%u rewrote 0x%lx of 0x%x bytes, 0x%lx bytes in total\n",
+        mVariableModuleGlobal->ReclaimStatistics.ReclaimCount,
+        (UINT64) RewrittenSize,
+        VariableStoreHeader->Size,
+        mVariableModuleGlobal->ReclaimStatistics.TotalRewrittenSize
+        ));
       *LastVariableOffset = (UINTN) CurrPtr - (UINTN) ValidBuffer;
       mVariableModuleGlobal->HwErrVariableTotalSize = HwErrVariableTotalSize;
       mVariableModuleGlobal->CommonVariableTotalSize = CommonVariableTotalSize;
@@ -776,7 +813,9 @@ Reclaim (
 
 Done:
   DoneStatus = EFI_SUCCESS;
+  mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingMove = TRUE;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    InvalidateVariableStoreIndex ((VARIABLE_STORE_HEADER *) (UINTN) VariableBase);
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache,
                    0,
@@ -789,6 +828,7 @@ Done:
     // For NV variable reclaim, we use mNvVariableCache as the buffer, so copy the data back.
     //
     CopyMem (mNvVariableCache, (UINT8 *) (UINTN) VariableBase, VariableStoreHeader->Size);
+    InvalidateVariableStoreIndex (mNvVariableCache);
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
                    0,
@@ -3658,6 +3698,20 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved    = 0;
   VolatileVariableStore->Reserved1   = 0;
 
+  //
+  // Index the variable stores for FindVariableEx (). A store without index
+  // is still searched by walking it, so a failure here is not fatal.
+  //
+  if (mVariableModuleGlobal->VariableGlobal.HobVariableBase != 0) {
+    CreateVariableStoreIndex (
+      VariableStoreTypeHob,
+      (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.HobVariableBase,
+      mVariableModuleGlobal->VariableGlobal.AuthFormat
+      );
+  }
+  CreateVariableStoreIndex (VariableStoreTypeNv, mNvVariableCache, mVariableModuleGlobal->VariableGlobal.AuthFormat);
+  CreateVariableStoreIndex (VariableStoreTypeVolatile, VolatileVariableStore, mVariableModuleGlobal->VariableGlobal.AuthFormat);
+
   return EFI_SUCCESS;
 }
 
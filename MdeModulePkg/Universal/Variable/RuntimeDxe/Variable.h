@@ -74,6 +74,15 @@ typedef struct {
   BOOLEAN                 *ReadLock;
   BOOLEAN                 *PendingUpdate;
   BOOLEAN                 *HobFlushComplete;
+  //
+  // Number of flushes that moved variables within the runtime caches.
+  //
+  UINT32                  FlushCount;
+  //
+  // TRUE if the pending updates move variables within the runtime caches.
+  // They are then only flushed on request of the runtime cache consumer.
+  //
+  BOOLEAN                 PendingMove;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeVolatileCache;
@@ -93,6 +102,49 @@ typedef struct {
   BOOLEAN         Volatile;
 } VARIABLE_POINTER_TRACK;
 
+///
+/// Terminates a bucket chain of a variable store index.
+///
+#define VARIABLE_INDEX_END  MAX_UINT32
+
+typedef struct {
+  //
+  // Offset of the variable header from the start of the variable store.
+  //
+  UINT32          Offset;
+  //
+  // Next entry in the same bucket, or VARIABLE_INDEX_END.
+  //
+  UINT32          Next;
+} VARIABLE_INDEX_ENTRY;
+
+///
+/// Hash index over (VendorGuid, VariableName) of one variable store.
+///
+/// Every variable header in [StartPtr, StartPtr + IndexedSize) has an entry,
+/// whatever its state; the state is checked at lookup time. Variables appended
+/// to the store are picked up by the next lookup, so only operations that move
+/// existing variables (reclaim) need to invalidate the index.
+///
+/// The bucket heads (UINT32[BucketCount]) and the entries
+/// (VARIABLE_INDEX_ENTRY[MaxEntryCount]) follow the structure in memory.
+///
+typedef struct {
+  VARIABLE_HEADER *StartPtr;
+  UINTN           IndexedSize;
+  UINT32          EntryCount;
+  UINT32          MaxEntryCount;
+  UINT32          BucketCount;
+  //
+  // TRUE if the store could not be fully indexed; lookups walk the store
+  // until the index is invalidated.
+  //
+  BOOLEAN         Overflow;
+} VARIABLE_STORE_INDEX;
+
+#define VARIABLE_INDEX_BUCKETS(StoreIndex)  ((UINT32 *) ((VARIABLE_STORE_INDEX *) (StoreIndex) + 1))
+#define VARIABLE_INDEX_ENTRIES(StoreIndex)  ((VARIABLE_INDEX_ENTRY *) (VARIABLE_INDEX_BUCKETS (StoreIndex) + (StoreIndex)->BucketCount))
+
 typedef struct {
   EFI_PHYSICAL_ADDRESS            HobVariableBase;
   EFI_PHYSICAL_ADDRESS            VolatileVariableBase;
@@ -105,6 +157,21 @@ typedef struct {
   BOOLEAN                         EmuNvMode;
 } VARIABLE_GLOBAL;
 
+///
+/// Flash usage of the reclaims of the non-volatile variable store.
+///
+typedef struct {
+  UINT32          ReclaimCount;
+  //
+  // Size in bytes of the FVB blocks rewritten by the last reclaim.
+  //
+  UINTN           LastRewrittenSize;
+  //
+  // Size in bytes of the FVB blocks rewritten by all reclaims.
+  //
+  UINT64          TotalRewrittenSize;
+} VARIABLE_RECLAIM_STATISTICS;
+
 typedef struct {
   VARIABLE_GLOBAL VariableGlobal;
   UINTN           VolatileLastVariableOffset;
@@ -124,6 +191,7 @@ typedef struct {
   CHAR8           *PlatformLang;
   CHAR8           Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *FvbInstance;
+  VARIABLE_RECLAIM_STATISTICS        ReclaimStatistics;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
@@ -148,6 +216,11 @@ FlushHobVariableToFlash (
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset in bytes of the range to write, from the
+                         start of the variable store.
+  @param  Length         Length in bytes of the range to write.
+  @param  RewrittenSize  Returns the size in bytes of the FVB blocks that
+                         were rewritten.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -156,8 +229,11 @@ FlushHobVariableToFlash (
 **/
 EFI_STATUS
 FtwVariableSpace (
-  IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN  UINTN                  Offset,
+  IN  UINTN                  Length,
+  OUT UINTN                  *RewrittenSize
   );
 
 /**
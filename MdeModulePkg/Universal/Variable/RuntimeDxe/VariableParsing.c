@@ -9,6 +9,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+///
+/// Lookup indexes of the variable stores, see CreateVariableStoreIndex ().
+///
+VARIABLE_STORE_INDEX  *mVariableStoreIndex[VariableStoreTypeMax];
+
 /**
 
   This code checks if variable header is valid or not.
@@ -437,6 +442,338 @@ VariableCompareTimeStampInternal (
   return (BOOLEAN) (FirstTime->Second <= SecondTime->Second);
 }
 
+/**
+  Compute the index hash of a variable from its vendor GUID and name.
+
+  @param[in] VendorGuid      Pointer to the variable vendor GUID.
+  @param[in] VariableName    Pointer to the variable name.
+  @param[in] NameSize        Size of the variable name in bytes, including the
+                             null terminator.
+
+  @return The 32-bit FNV-1a hash of the GUID and the name.
+
+**/
+UINT32
+GetVariableIndexHash (
+  IN  EFI_GUID              *VendorGuid,
+  IN  VOID                  *VariableName,
+  IN  UINTN                 NameSize
+  )
+{
+  UINT32                    Hash;
+  UINT8                     *Buffer;
+  UINTN                     Index;
+
+  Hash   = 0x811C9DC5;
+  Buffer = (UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Buffer[Index]) * 0x01000193;
+  }
+
+  Buffer = (UINT8 *) VariableName;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Buffer[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Get the index of the variable store starting at the given variable.
+
+  @param[in] StartPtr        Pointer to the first variable of the store.
+
+  @return Pointer to the variable store index, or NULL if the store is not indexed.
+
+**/
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN  VARIABLE_HEADER       *StartPtr
+  )
+{
+  UINTN                     Index;
+
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    if (mVariableStoreIndex[Index] != NULL && mVariableStoreIndex[Index]->StartPtr == StartPtr) {
+      return mVariableStoreIndex[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop all entries of a variable store index.
+
+  @param[in, out] StoreIndex Pointer to the variable store index.
+
+**/
+VOID
+ResetVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex
+  )
+{
+  StoreIndex->IndexedSize = 0;
+  StoreIndex->EntryCount  = 0;
+  StoreIndex->Overflow    = FALSE;
+  SetMem (
+    VARIABLE_INDEX_BUCKETS (StoreIndex),
+    StoreIndex->BucketCount * sizeof (UINT32),
+    0xff
+    );
+}
+
+/**
+  Add the variables appended to a store since the last update to its index.
+
+  @param[in, out] StoreIndex Pointer to the variable store index.
+  @param[in]      EndPtr     Pointer to the end of the variable store.
+  @param[in]      AuthFormat TRUE indicates authenticated variables are used.
+                             FALSE indicates authenticated variables are not used.
+
+  @retval TRUE               The index covers every variable of the store.
+  @retval FALSE              The index is not usable, the store must be walked.
+
+**/
+BOOLEAN
+UpdateVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     VARIABLE_HEADER       *EndPtr,
+  IN     BOOLEAN               AuthFormat
+  )
+{
+  VARIABLE_HEADER              *Variable;
+  VARIABLE_INDEX_ENTRY         *Entry;
+  UINT32                       *Bucket;
+  UINTN                        NameSize;
+  UINT8                        *Name;
+  UINT32                       Hash;
+
+  if (StoreIndex->Overflow) {
+    return FALSE;
+  }
+
+  for ( Variable = (VARIABLE_HEADER *) ((UINTN) StoreIndex->StartPtr + StoreIndex->IndexedSize)
+      ; IsValidVariableHeader (Variable, EndPtr)
+      ; Variable = GetNextVariablePtr (Variable, AuthFormat)
+      ) {
+    NameSize = NameSizeOfVariable (Variable, AuthFormat);
+    Name     = (UINT8 *) GetVariableNamePtr (Variable, AuthFormat);
+    if ((StoreIndex->EntryCount >= StoreIndex->MaxEntryCount) ||
+        (NameSize == 0) ||
+        (NameSize > (UINTN) EndPtr - (UINTN) Name)) {
+      StoreIndex->Overflow = TRUE;
+      return FALSE;
+    }
+
+    Hash   = GetVariableIndexHash (GetVendorGuidPtr (Variable, AuthFormat), Name, NameSize);
+    Bucket = &VARIABLE_INDEX_BUCKETS (StoreIndex)[Hash & (StoreIndex->BucketCount - 1)];
+    Entry  = &VARIABLE_INDEX_ENTRIES (StoreIndex)[StoreIndex->EntryCount];
+    Entry->Offset = (UINT32) ((UINTN) Variable - (UINTN) StoreIndex->StartPtr);
+    Entry->Next   = *Bucket;
+    *Bucket       = StoreIndex->EntryCount;
+    StoreIndex->EntryCount++;
+  }
+
+  StoreIndex->IndexedSize = (UINTN) Variable - (UINTN) StoreIndex->StartPtr;
+  return TRUE;
+}
+
+/**
+  Create the lookup index of a variable store.
+
+  The index is used by FindVariableEx () for every search in the store. A
+  previous index created for the same store type is destroyed.
+
+  @param[in] StoreType       Type of the variable store.
+  @param[in] VariableStore   Pointer to the variable store header.
+  @param[in] AuthFormat      TRUE indicates authenticated variables are used.
+                             FALSE indicates authenticated variables are not used.
+
+  @retval EFI_SUCCESS            The index was created.
+  @retval EFI_INVALID_PARAMETER  The variable store is too small.
+  @retval EFI_OUT_OF_RESOURCES   The index could not be allocated.
+
+**/
+EFI_STATUS
+CreateVariableStoreIndex (
+  IN  VARIABLE_STORE_TYPE    StoreType,
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_STORE_INDEX       *StoreIndex;
+  UINT32                     MaxEntryCount;
+  UINT32                     BucketCount;
+
+  ASSERT (StoreType < VariableStoreTypeMax);
+
+  if (mVariableStoreIndex[StoreType] != NULL) {
+    FreePool (mVariableStoreIndex[StoreType]);
+    mVariableStoreIndex[StoreType] = NULL;
+  }
+
+  if (VariableStore->Size <= sizeof (VARIABLE_STORE_HEADER)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The smallest variable is a header followed by a one character name.
+  // Size the index for a store full of those so that it never overflows in
+  // practice, and aim for chains of four entries in that worst case.
+  //
+  MaxEntryCount = (UINT32) ((VariableStore->Size - sizeof (VARIABLE_STORE_HEADER)) /
+                            HEADER_ALIGN (GetVariableHeaderSize (AuthFormat) + 2 * sizeof (CHAR16)));
+  BucketCount   = MAX (GetPowerOfTwo32 (MaxEntryCount / 4), 16);
+
+  StoreIndex = AllocateRuntimePool (
+                 sizeof (VARIABLE_STORE_INDEX) +
+                 BucketCount * sizeof (UINT32) +
+                 MaxEntryCount * sizeof (VARIABLE_INDEX_ENTRY)
+                 );
+  if (StoreIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  StoreIndex->StartPtr      = GetStartPointer (VariableStore);
+  StoreIndex->MaxEntryCount = MaxEntryCount;
+  StoreIndex->BucketCount   = BucketCount;
+  ResetVariableStoreIndex (StoreIndex);
+  UpdateVariableStoreIndex (StoreIndex, GetEndPointer (VariableStore), AuthFormat);
+
+  mVariableStoreIndex[StoreType] = StoreIndex;
+  return EFI_SUCCESS;
+}
+
+/**
+  Invalidate the lookup index of a variable store.
+
+  This must be called whenever variables are moved within the store, e.g. by
+  a reclaim. The index is rebuilt by the next search in the store.
+
+  @param[in] VariableStore   Pointer to the variable store header.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  VARIABLE_STORE_INDEX       *StoreIndex;
+
+  StoreIndex = GetVariableStoreIndex (GetStartPointer (VariableStore));
+  if (StoreIndex != NULL) {
+    ResetVariableStoreIndex (StoreIndex);
+  }
+}
+
+/**
+  Destroy the lookup index of a variable store.
+
+  @param[in] VariableStore   Pointer to the variable store header.
+
+**/
+VOID
+DestroyVariableStoreIndex (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  UINTN                      Index;
+
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    if (mVariableStoreIndex[Index] != NULL &&
+        mVariableStoreIndex[Index]->StartPtr == GetStartPointer (VariableStore)) {
+      if (!AtRuntime ()) {
+        FreePool (mVariableStoreIndex[Index]);
+      }
+      mVariableStoreIndex[Index] = NULL;
+    }
+  }
+}
+
+/**
+  Find the variable in a variable store through the store index.
+
+  The search result is the same as the one of a walk through the store.
+
+  @param[in]       StoreIndex          Pointer to the up-to-date index of the store.
+  @param[in]       VariableName        Name of the variable to be found, not empty.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_INDEX_ENTRY           *Entries;
+  UINT32                         EntryIndex;
+  UINTN                          NameSize;
+  UINT32                         Hash;
+  VARIABLE_HEADER                *Variable;
+  VARIABLE_HEADER                *AddedVariable;
+  VARIABLE_HEADER                *InDeletedVariable;
+
+  NameSize   = StrSize (VariableName);
+  Hash       = GetVariableIndexHash (VendorGuid, VariableName, NameSize);
+  Entries    = VARIABLE_INDEX_ENTRIES (StoreIndex);
+  EntryIndex = VARIABLE_INDEX_BUCKETS (StoreIndex)[Hash & (StoreIndex->BucketCount - 1)];
+
+  //
+  // Entries are pushed at the head of their chain, so a chain lists the
+  // variables from the end of the store towards its start. The last ADDED
+  // match is the one a walk would find first, and the first IN_DELETED_TRANSITION
+  // match after it is the closest one before it in the store.
+  //
+  AddedVariable     = NULL;
+  InDeletedVariable = NULL;
+  while (EntryIndex != VARIABLE_INDEX_END) {
+    Variable   = (VARIABLE_HEADER *) ((UINTN) StoreIndex->StartPtr + Entries[EntryIndex].Offset);
+    EntryIndex = Entries[EntryIndex].Next;
+
+    if (Variable->State != VAR_ADDED &&
+        Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+      continue;
+    }
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+    if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+        (NameSizeOfVariable (Variable, AuthFormat) != NameSize) ||
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSize) != 0)) {
+      continue;
+    }
+
+    if (Variable->State == VAR_ADDED) {
+      AddedVariable     = Variable;
+      InDeletedVariable = NULL;
+    } else if (InDeletedVariable == NULL) {
+      InDeletedVariable = Variable;
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    return EFI_SUCCESS;
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -462,9 +799,17 @@ FindVariableEx (
 {
   VARIABLE_HEADER                *InDeletedVariable;
   VOID                           *Point;
+  VARIABLE_STORE_INDEX           *StoreIndex;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  if (VariableName[0] != 0) {
+    StoreIndex = GetVariableStoreIndex (PtrTrack->StartPtr);
+    if (StoreIndex != NULL && UpdateVariableStoreIndex (StoreIndex, PtrTrack->EndPtr, AuthFormat)) {
+      return FindVariableInStoreIndex (StoreIndex, VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -257,6 +257,144 @@ VariableCompareTimeStampInternal (
   IN EFI_TIME               *SecondTime
   );
 
+extern VARIABLE_STORE_INDEX  *mVariableStoreIndex[VariableStoreTypeMax];
+
+/**
+  Compute the index hash of a variable from its vendor GUID and name.
+
+  @param[in] VendorGuid      Pointer to the variable vendor GUID.
+  @param[in] VariableName    Pointer to the variable name.
+  @param[in] NameSize        Size of the variable name in bytes, including the
+                             null terminator.
+
+  @return The 32-bit FNV-1a hash of the GUID and the name.
+
+**/
+UINT32
+GetVariableIndexHash (
+  IN  EFI_GUID              *VendorGuid,
+  IN  VOID                  *VariableName,
+  IN  UINTN                 NameSize
+  );
+
+/**
+  Get the index of the variable store starting at the given variable.
+
+  @param[in] StartPtr        Pointer to the first variable of the store.
+
+  @return Pointer to the variable store index, or NULL if the store is not indexed.
+
+**/
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN  VARIABLE_HEADER       *StartPtr
+  );
+
+/**
+  Drop all entries of a variable store index.
+
+  @param[in, out] StoreIndex Pointer to the variable store index.
+
+**/
+VOID
+ResetVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex
+  );
+
+/**
+  Add the variables appended to a store since the last update to its index.
+
+  @param[in, out] StoreIndex Pointer to the variable store index.
+  @param[in]      EndPtr     Pointer to the end of the variable store.
+  @param[in]      AuthFormat TRUE indicates authenticated variables are used.
+                             FALSE indicates authenticated variables are not used.
+
+  @retval TRUE               The index covers every variable of the store.
+  @retval FALSE              The index is not usable, the store must be walked.
+
+**/
+BOOLEAN
+UpdateVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     VARIABLE_HEADER       *EndPtr,
+  IN     BOOLEAN               AuthFormat
+  );
+
+/**
+  Create the lookup index of a variable store.
+
+  The index is used by FindVariableEx () for every search in the store. A
+  previous index created for the same store type is destroyed.
+
+  @param[in] StoreType       Type of the variable store.
+  @param[in] VariableStore   Pointer to the variable store header.
+  @param[in] AuthFormat      TRUE indicates authenticated variables are used.
+                             FALSE indicates authenticated variables are not used.
+
+  @retval EFI_SUCCESS            The index was created.
+  @retval EFI_INVALID_PARAMETER  The variable store is too small.
+  @retval EFI_OUT_OF_RESOURCES   The index could not be allocated.
+
+**/
+EFI_STATUS
+CreateVariableStoreIndex (
+  IN  VARIABLE_STORE_TYPE    StoreType,
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  BOOLEAN                AuthFormat
+  );
+
+/**
+  Invalidate the lookup index of a variable store.
+
+  This must be called whenever variables are moved within the store, e.g. by
+  a reclaim. The index is rebuilt by the next search in the store.
+
+  @param[in] VariableStore   Pointer to the variable store header.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  );
+
+/**
+  Destroy the lookup index of a variable store.
+
+  @param[in] VariableStore   Pointer to the variable store header.
+
+**/
+VOID
+DestroyVariableStoreIndex (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  );
+
+/**
+  Find the variable in a variable store through the store index.
+
+  The search result is the same as the one of a walk through the store.
+
+  @param[in]       StoreIndex          Pointer to the up-to-date index of the store.
+  @param[in]       VariableName        Name of the variable to be found, not empty.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
 /**
   Find the variable in the specified variable store.
 
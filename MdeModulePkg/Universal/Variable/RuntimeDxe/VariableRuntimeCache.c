@@ -85,6 +85,11 @@ FlushPendingRuntimeVariableCacheUpdates (
       );
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
+
+    if (VariableRuntimeCacheContext->PendingMove) {
+      VariableRuntimeCacheContext->FlushCount++;
+      VariableRuntimeCacheContext->PendingMove = FALSE;
+    }
     *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
   }
 
@@ -97,7 +102,8 @@ FlushPendingRuntimeVariableCacheUpdates (
   Ensures all conditions are met to maintain coherency for runtime cache updates. This function will attempt
   to write the given update (and any other pending updates) if the ReadLock is available. Otherwise, the
   update is added as a pending update for the given variable store and it will be flushed to the runtime cache
-  at the next opportunity the ReadLock is available.
+  at the next opportunity the ReadLock is available. Updates that move variables within the runtime caches are
+  always left pending, they are flushed on request of the runtime cache consumer.
 
   @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
   @param[in] Offset               Offset in bytes to apply the update.
@@ -145,7 +151,12 @@ SynchronizeRuntimeVariableCache (
   }
   *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) = TRUE;
 
-  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.ReadLock) == FALSE) {
+  //
+  // Updates that move variables are left pending, so the consumer flushes
+  // them and learns the new flush count to rebuild its lookup indexes.
+  //
+  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.ReadLock) == FALSE &&
+      !mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingMove) {
     return FlushPendingRuntimeVariableCacheUpdates ();
   }
 
@@ -469,6 +469,8 @@ SmmVariableHandler (
   SMM_VARIABLE_COMMUNICATE_GET_PAYLOAD_SIZE               *GetPayloadSize;
   SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *RuntimeVariableCacheContext;
   SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO         *GetRuntimeCacheInfo;
+  SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT      *RuntimeCacheFlushCount;
+  SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS         *GetReclaimStatistics;
   SMM_VARIABLE_COMMUNICATE_LOCK_VARIABLE                  *VariableToLock;
   SMM_VARIABLE_COMMUNICATE_VAR_CHECK_VARIABLE_PROPERTY    *CommVariableProperty;
   VARIABLE_INFO_ENTRY                                     *VariableInfo;
@@ -917,6 +919,7 @@ SmmVariableHandler (
       CopyGuid (&(VariableCacheContext->VariableRuntimeNvCache.Store->Signature), &(VariableCache->Signature));
 
       *(VariableCacheContext->PendingUpdate) = TRUE;
+      VariableCacheContext->PendingMove = TRUE;
       *(VariableCacheContext->ReadLock) = FALSE;
       *(VariableCacheContext->HobFlushComplete) = FALSE;
 
@@ -924,6 +927,11 @@ SmmVariableHandler (
       break;
     case SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE:
       Status = FlushPendingRuntimeVariableCacheUpdates ();
+      if (CommBufferPayloadSize >= sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT)) {
+        RuntimeCacheFlushCount = (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT *) SmmVariableFunctionHeader->Data;
+        RuntimeCacheFlushCount->Version    = SMM_VARIABLE_RUNTIME_CACHE_FLUSH_COUNT_VERSION;
+        RuntimeCacheFlushCount->FlushCount = mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.FlushCount;
+      }
       break;
     case SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO:
       if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO)) {
@@ -948,6 +956,21 @@ SmmVariableHandler (
       Status = EFI_SUCCESS;
       break;
 
+    case SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS)) {
+        DEBUG ((DEBUG_ERROR, "GetReclaimStatistics: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+      GetReclaimStatistics = (SMM_VARIABLE_COMMUNICATE_GET_RECLAIM_STATISTICS *) SmmVariableFunctionHeader->Data;
+
+      GetReclaimStatistics->ReclaimCount       = mVariableModuleGlobal->ReclaimStatistics.ReclaimCount;
+      GetReclaimStatistics->Reserved           = 0;
+      GetReclaimStatistics->LastRewrittenSize  = mVariableModuleGlobal->ReclaimStatistics.LastRewrittenSize;
+      GetReclaimStatistics->TotalRewrittenSize = mVariableModuleGlobal->ReclaimStatistics.TotalRewrittenSize;
+
+      Status = EFI_SUCCESS;
+      break;
+
     default:
       Status = EFI_UNSUPPORTED;
   }
@@ -62,6 +62,9 @@ BOOLEAN                          mVariableRuntimeCachePendingUpdate;
 BOOLEAN                          mVariableRuntimeCacheReadLock;
 BOOLEAN                          mVariableAuthFormat;
 BOOLEAN                          mHobFlushComplete;
+BOOLEAN                          mVariableRuntimeCacheFlushCountValid;
+UINT32                           mVariableRuntimeCacheFlushCount;
+UINT32                           mVariableRuntimeCacheIndexFlushCount;
 EFI_LOCK                         mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL     mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL         mVarCheck;
@@ -540,16 +543,40 @@ SyncRuntimeCache (
   VOID
   )
 {
+  EFI_STATUS                                          Status;
+  SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT  *RuntimeCacheFlushCount;
+
   //
   // Init the communicate buffer. The buffer data size is:
-  // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE.
+  // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_CACHE_FLUSH_COUNT).
   //
-  InitCommunicateBuffer (NULL, 0, SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE);
+  Status = InitCommunicateBuffer (
+             (VOID **) &RuntimeCacheFlushCount,
+             sizeof (*RuntimeCacheFlushCount),
+             SMM_VARIABLE_FUNCTION_SYNC_RUNTIME_CACHE
+             );
+  if (EFI_ERROR (Status)) {
+    mVariableRuntimeCacheFlushCountValid = FALSE;
+    return;
+  }
+  ZeroMem (RuntimeCacheFlushCount, sizeof (*RuntimeCacheFlushCount));
 
   //
   // Send data to SMM.
   //
-  SendCommunicateBuffer (0);
+  Status = SendCommunicateBuffer (sizeof (*RuntimeCacheFlushCount));
+
+  //
+  // The flush count tells whether the runtime caches moved. Without it, the
+  // caches are not indexed.
+  //
+  if (!EFI_ERROR (Status) &&
+      RuntimeCacheFlushCount->Version >= SMM_VARIABLE_RUNTIME_CACHE_FLUSH_COUNT_VERSION) {
+    mVariableRuntimeCacheFlushCount      = RuntimeCacheFlushCount->FlushCount;
+    mVariableRuntimeCacheFlushCountValid = TRUE;
+  } else {
+    mVariableRuntimeCacheFlushCountValid = FALSE;
+  }
 }
 
 /**
@@ -573,6 +600,7 @@ CheckForRuntimeCacheSync (
   // The HOB variable data may have finished being flushed in the runtime cache sync update
   //
   if (mHobFlushComplete && mVariableRuntimeHobCacheBuffer != NULL) {
+    DestroyVariableStoreIndex (mVariableRuntimeHobCacheBuffer);
     if (!EfiAtRuntime ()) {
       FreePages (mVariableRuntimeHobCacheBuffer, EFI_SIZE_TO_PAGES (mVariableRuntimeHobCacheBufferSize));
     }
@@ -580,6 +608,38 @@ CheckForRuntimeCacheSync (
   }
 }
 
+/**
+  Invalidate the lookup indexes of the runtime caches if SMM has flushed updates
+  that moved variables within the caches since the indexes were last checked.
+
+  SMM leaves such updates pending until SyncRuntimeCache () requests them, so
+  the flush count returned by the last SyncRuntimeCache () is up to date.
+
+  The runtime cache read lock must be held so that the caches do not change
+  while the indexes are in use.
+
+**/
+VOID
+CheckForRuntimeCacheIndexUpdate (
+  VOID
+  )
+{
+  if (mVariableRuntimeCacheIndexFlushCount == mVariableRuntimeCacheFlushCount) {
+    return;
+  }
+
+  if (mVariableRuntimeHobCacheBuffer != NULL) {
+    InvalidateVariableStoreIndex (mVariableRuntimeHobCacheBuffer);
+  }
+  if (mVariableRuntimeNvCacheBuffer != NULL) {
+    InvalidateVariableStoreIndex (mVariableRuntimeNvCacheBuffer);
+  }
+  if (mVariableRuntimeVolatileCacheBuffer != NULL) {
+    InvalidateVariableStoreIndex (mVariableRuntimeVolatileCacheBuffer);
+  }
+  mVariableRuntimeCacheIndexFlushCount = mVariableRuntimeCacheFlushCount;
+}
+
 /**
   Finds the given variable in a runtime cache variable store.
 
@@ -633,6 +693,8 @@ FindVariableInRuntimeCache (
   CheckForRuntimeCacheSync ();
 
   if (!mVariableRuntimeCachePendingUpdate) {
+    CheckForRuntimeCacheIndexUpdate ();
+
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -893,6 +955,8 @@ GetNextVariableNameInRuntimeCache (
 
   mVariableRuntimeCacheReadLock = TRUE;
   if (!mVariableRuntimeCachePendingUpdate) {
+    CheckForRuntimeCacheIndexUpdate ();
+
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -1336,11 +1400,20 @@ VariableAddressChangeEvent (
   IN VOID                                   *Context
   )
 {
+  UINTN     Index;
+
   EfiConvertPointer (0x0, (VOID **) &mVariableBuffer);
   EfiConvertPointer (0x0, (VOID **) &mMmCommunication2);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeVolatileCacheBuffer);
+
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    if (mVariableStoreIndex[Index] != NULL) {
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index]->StartPtr);
+      EfiConvertPointer (0x0, (VOID **) &mVariableStoreIndex[Index]);
+    }
+  }
 }
 
 /**
@@ -1665,6 +1738,19 @@ SmmVariableReady (
         mVariableRuntimeHobCacheBuffer = NULL;
         mVariableRuntimeNvCacheBuffer = NULL;
         mVariableRuntimeVolatileCacheBuffer = NULL;
+      } else if (mVariableRuntimeCacheFlushCountValid) {
+        //
+        // Index the runtime caches for FindVariableEx (). A cache without index
+        // is still searched by walking it, so a failure here is not fatal.
+        // The caches are only indexed if SMM reports the flush count, as the
+        // indexes must be rebuilt whenever variables move within the caches.
+        //
+        if (mVariableRuntimeHobCacheBuffer != NULL) {
+          CreateVariableStoreIndex (VariableStoreTypeHob, mVariableRuntimeHobCacheBuffer, mVariableAuthFormat);
+        }
+        CreateVariableStoreIndex (VariableStoreTypeNv, mVariableRuntimeNvCacheBuffer, mVariableAuthFormat);
+        CreateVariableStoreIndex (VariableStoreTypeVolatile, mVariableRuntimeVolatileCacheBuffer, mVariableAuthFormat);
+        mVariableRuntimeCacheIndexFlushCount = mVariableRuntimeCacheFlushCount;
       }
     }
     ASSERT_EFI_ERROR (Status);
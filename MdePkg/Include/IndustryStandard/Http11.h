@@ -76,6 +76,13 @@
 ///
 #define HTTP_HEADER_ACCEPT_RANGES      "Accept-Ranges"
 
+///
+/// Range Request Header
+/// The Range request-header field asks the server to send only the
+/// listed byte ranges of the entity, in a 206 (Partial Content) response:
+///
+#define HTTP_HEADER_RANGE              "Range"
+
 
 ///
 /// Accept-Encoding Request Header
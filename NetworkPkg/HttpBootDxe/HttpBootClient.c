@@ -580,21 +580,22 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HTTP child for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo wrapping the new HTTP child.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+HttpBootCreateHttpIoChild (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private,
+     OUT HTTP_IO                      *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA          ConfigData;
-  EFI_STATUS                   Status;
   EFI_HANDLE                   ImageHandle;
 
   ASSERT (Private != NULL);
@@ -613,15 +614,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *) Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *) Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  )
+{
+  EFI_STATUS                   Status;
+
+  Status = HttpBootCreateHttpIoChild (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -630,6 +650,90 @@ HttpBootCreateHttpIo (
   return EFI_SUCCESS;
 }
 
+/**
+  Build the HTTP header used to request the boot file. It contains the Host,
+  Accept and User-Agent fields.
+
+  @param[in]    Private         The pointer to the driver's private data.
+  @param[in]    MaxHeaderCount  The number of header fields to make room for,
+                                at least 3.
+  @param[out]   HttpIoHeader    The new header.
+
+  @retval EFI_SUCCESS           The header was built.
+  @retval EFI_OUT_OF_RESOURCES  Could not allocate needed resources.
+  @retval Others                Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootCreateRequestHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN     UINTN                    MaxHeaderCount,
+     OUT HTTP_IO_HEADER           **HttpIoHeader
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO_HEADER             *Header;
+  CHAR8                      *HostName;
+
+  Header = HttpIoCreateHeader (MaxHeaderCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Add HTTP header field 1: Host
+  //
+  HostName = NULL;
+  Status = HttpUrlGetHostName (
+             Private->BootFileUri,
+             Private->BootFileUriParser,
+             &HostName
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_HOST,
+             HostName
+             );
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 2: Accept
+  //
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_ACCEPT,
+             "*/*"
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Add HTTP header field 3: User-Agent
+  //
+  Status = HttpIoSetHeader (
+             Header,
+             HTTP_HEADER_USER_AGENT,
+             HTTP_USER_AGENT_EFI_HTTP_BOOT
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
 /**
   Release all the resource of a cache item.
 
@@ -840,14 +944,18 @@ HttpBootGetBootFileCallback (
     }
   }
   //
-  // Copy data if caller has provided a buffer.
+  // Copy data if caller has provided a buffer. Data received straight into the
+  // caller's buffer is already in place up to the first chunk boundary, and
+  // only has to be moved down over the chunk framing after it.
   //
   if (CallbackData->BufferSize > CallbackData->CopyedSize) {
-    CopyMem (
-      CallbackData->Buffer + CallbackData->CopyedSize,
-      Data,
-      MIN (Length, CallbackData->BufferSize - CallbackData->CopyedSize)
-      );
+    if ((UINT8 *) Data != CallbackData->Buffer + CallbackData->CopyedSize) {
+      CopyMem (
+        CallbackData->Buffer + CallbackData->CopyedSize,
+        Data,
+        MIN (Length, CallbackData->BufferSize - CallbackData->CopyedSize)
+        );
+    }
     CallbackData->CopyedSize += MIN (Length, CallbackData->BufferSize - CallbackData->CopyedSize);
   }
 
@@ -905,12 +1013,12 @@ HttpBootGetBootFile (
 {
   EFI_STATUS                 Status;
   EFI_HTTP_STATUS_CODE       StatusCode;
-  CHAR8                      *HostName;
   EFI_HTTP_REQUEST_DATA      *RequestData;
   HTTP_IO_RESPONSE_DATA      *ResponseData;
   HTTP_IO_RESPONSE_DATA      ResponseBody;
   HTTP_IO                    *HttpIo;
   HTTP_IO_HEADER             *HttpIoHeader;
+  EFI_HTTP_HEADER            *Header;
   VOID                       *Parser;
   HTTP_BOOT_CALLBACK_DATA    Context;
   UINTN                      ContentLength;
@@ -977,56 +1085,9 @@ HttpBootGetBootFile (
   //       Accept
   //       User-Agent
   //
-  HttpIoHeader = HttpIoCreateHeader (3);
-  if (HttpIoHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR_2;
-  }
-
-  //
-  // Add HTTP header field 1: Host
-  //
-  HostName = NULL;
-  Status = HttpUrlGetHostName (
-             Private->BootFileUri,
-             Private->BootFileUriParser,
-             &HostName
-             );
+  Status = HttpBootCreateRequestHeader (Private, 3, &HttpIoHeader);
   if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_HOST,
-             HostName
-             );
-  FreePool (HostName);
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 2: Accept
-  //
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_ACCEPT,
-             "*/*"
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
-  }
-
-  //
-  // Add HTTP header field 3: User-Agent
-  //
-  Status = HttpIoSetHeader (
-             HttpIoHeader,
-             HTTP_HEADER_USER_AGENT,
-             HTTP_USER_AGENT_EFI_HTTP_BOOT
-             );
-  if (EFI_ERROR (Status)) {
-    goto ERROR_3;
+    goto ERROR_2;
   }
 
   //
@@ -1103,6 +1164,19 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Record whether the server accepts byte range requests for the file, so
+  // that it may later be downloaded over several connections.
+  //
+  if (HeaderOnly) {
+    Header = HttpFindHeader (
+               ResponseData->HeaderCount,
+               ResponseData->Headers,
+               HTTP_HEADER_ACCEPT_RANGES
+               );
+    Private->BootFileAcceptRanges = (BOOLEAN) (Header != NULL && AsciiStriCmp (Header->FieldValue, "bytes") == 0);
+  }
+
   //
   // 3.2 Cache the response header.
   //
@@ -1197,26 +1271,37 @@ HttpBootGetBootFile (
       //
       Block = NULL;
       while (!HttpIsMessageComplete (Parser)) {
-        //
-        // Allocate a buffer in Block to hold the message-body.
-        // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
-        // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
-        // every HttpIoRecvResponse().
-        //
-        if (Block == NULL || Context.BufferSize == 0) {
-          Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
-          if (Block == NULL) {
-            Status = EFI_OUT_OF_RESOURCES;
-            goto ERROR_6;
-          }
-          Context.NewBlock = TRUE;
-          Context.Block = Block;
+        if (Context.BufferSize - Context.CopyedSize >= HTTP_BOOT_BLOCK_SIZE) {
+          //
+          // The caller's buffer still has room for a block: receive straight into it,
+          // right after the entity data parsed so far. HttpBootGetBootFileCallback()
+          // then only moves the data that follows a chunk boundary.
+          //
+          Context.NewBlock        = FALSE;
+          ResponseBody.Body       = (CHAR8*) Buffer + Context.CopyedSize;
+          ResponseBody.BodyLength = Context.BufferSize - Context.CopyedSize;
         } else {
-          Context.NewBlock = FALSE;
-        }
+          //
+          // Allocate a buffer in Block to hold the message-body.
+          // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
+          // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
+          // every HttpIoRecvResponse().
+          //
+          if (Block == NULL || Context.BufferSize == 0) {
+            Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
+            if (Block == NULL) {
+              Status = EFI_OUT_OF_RESOURCES;
+              goto ERROR_6;
+            }
+            Context.NewBlock = TRUE;
+            Context.Block = Block;
+          } else {
+            Context.NewBlock = FALSE;
+          }
 
-        ResponseBody.Body       = (CHAR8*) Block;
-        ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
+          ResponseBody.Body       = (CHAR8*) Block;
+          ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
+        }
         Status = HttpIoRecvResponse (
                    &Private->HttpIo,
                    FALSE,
@@ -1304,3 +1389,496 @@ ERROR_1:
   return Status;
 }
 
+
+/**
+  Get the offset and the size of a range of the boot file.
+
+  @param[in]    Download        The ranged download.
+  @param[in]    Range           The index of the range.
+  @param[out]   Length          The size of the range in bytes.
+
+  @return       The offset of the range in the boot file.
+
+**/
+UINTN
+HttpBootRangeOffset (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD     *Download,
+  IN     UINTN                        Range,
+     OUT UINTN                        *Length
+  )
+{
+  UINTN                        Offset;
+
+  Offset  = Range * HTTP_BOOT_RANGE_SIZE;
+  *Length = MIN (Download->FileSize - Offset, HTTP_BOOT_RANGE_SIZE);
+  return Offset;
+}
+
+/**
+  Close the HTTP child of a ranged download connection. The range it was
+  downloading is left to the caller.
+
+  @param[in]    Connection      The connection to close.
+
+**/
+VOID
+HttpBootRangeCloseConnection (
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection
+  )
+{
+  if (Connection->HttpCreated) {
+    HttpIoDestroyIo (&Connection->HttpIo);
+    //
+    // Run the DPCs queued for any token the HTTP driver aborted while they
+    // can still update the connection.
+    //
+    DispatchDpc ();
+    Connection->HttpCreated = FALSE;
+  }
+  Connection->State = HttpBootConnectionIdle;
+}
+
+/**
+  Queue a receive token for the response of the current range on a connection.
+
+  @param[in]    Download        The ranged download.
+  @param[in]    Connection      The connection.
+  @param[in]    RecvMsgHeader   TRUE to receive the response header, FALSE to
+                                continue receiving the message-body.
+
+  @retval EFI_SUCCESS           The token was queued.
+  @retval Others                Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootRangeReceive (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD     *Download,
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection,
+  IN     BOOLEAN                      RecvMsgHeader
+  )
+{
+  HTTP_IO                      *HttpIo;
+  EFI_HTTP_MESSAGE             *Message;
+  UINTN                        Offset;
+  UINTN                        Length;
+  EFI_STATUS                   Status;
+
+  HttpIo  = &Connection->HttpIo;
+  Message = HttpIo->RspToken.Message;
+
+  HttpIo->RspToken.Status = EFI_NOT_READY;
+  Message->HeaderCount    = 0;
+  Message->Headers        = NULL;
+  if (RecvMsgHeader) {
+    Message->Data.Response = &Connection->Response;
+    Message->BodyLength    = 0;
+    Message->Body          = NULL;
+  } else {
+    Offset = HttpBootRangeOffset (Download, Connection->Range, &Length);
+    Message->Data.Response = NULL;
+    Message->BodyLength    = Length - Connection->ReceivedSize;
+    Message->Body          = Download->Buffer + Offset + Connection->ReceivedSize;
+  }
+
+  HttpIo->IsRxDone = FALSE;
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connection->State = RecvMsgHeader ? HttpBootConnectionReceivingHeader : HttpBootConnectionReceivingBody;
+  return gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+}
+
+/**
+  Send the request for the next pending range on an idle connection, creating
+  its HTTP child first if needed.
+
+  @param[in]    Download        The ranged download.
+  @param[in]    Connection      The idle connection.
+
+  @retval EFI_SUCCESS           The request was queued, or no range is pending.
+  @retval Others                Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootRangeSendRequest (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD     *Download,
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection
+  )
+{
+  HTTP_IO                      *HttpIo;
+  EFI_HTTP_MESSAGE             *Message;
+  CHAR8                        RangeValue[sizeof ("bytes=18446744073709551615-18446744073709551615")];
+  UINTN                        Range;
+  UINTN                        Offset;
+  UINTN                        Length;
+  EFI_STATUS                   Status;
+
+  for (Range = Download->NextPending; Range < Download->RangeCount; Range++) {
+    if (Download->Ranges[Range].State == HttpBootRangePending) {
+      break;
+    }
+  }
+  Download->NextPending = Range;
+  if (Range == Download->RangeCount) {
+    return EFI_SUCCESS;
+  }
+
+  Download->Ranges[Range].State = HttpBootRangeActive;
+  Connection->Range             = Range;
+  Connection->ReceivedSize      = 0;
+
+  if (!Connection->HttpCreated) {
+    Status = HttpBootCreateHttpIoChild (Download->Private, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    Connection->HttpCreated = TRUE;
+  }
+
+  Offset = HttpBootRangeOffset (Download, Range, &Length);
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "bytes=%lu-%lu",
+    (UINT64) Offset,
+    (UINT64) (Offset + Length - 1)
+    );
+  Status = HttpIoSetHeader (Connection->Header, HTTP_HEADER_RANGE, RangeValue);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo  = &Connection->HttpIo;
+  Message = HttpIo->ReqToken.Message;
+
+  HttpIo->ReqToken.Status = EFI_NOT_READY;
+  Message->Data.Request   = &Download->Request;
+  Message->HeaderCount    = Connection->Header->HeaderCount;
+  Message->Headers        = Connection->Header->Headers;
+  Message->BodyLength     = 0;
+  Message->Body           = NULL;
+
+  HttpIo->IsTxDone = FALSE;
+  Status = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connection->State = HttpBootConnectionSending;
+  return gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+}
+
+/**
+  Poll a busy connection and move it on to the next step of its range once the
+  outstanding token has completed.
+
+  @param[in]    Download        The ranged download.
+  @param[in]    Connection      The busy connection.
+
+  @retval EFI_SUCCESS           The connection made progress.
+  @retval EFI_NOT_READY         The outstanding token has not completed yet.
+  @retval EFI_TIMEOUT           The server did not respond in time.
+  @retval EFI_UNSUPPORTED       The server answered with a 200 reply or with a
+                                Content-Length other than the size of the range.
+  @retval Others                The range failed.
+
+**/
+EFI_STATUS
+HttpBootRangePoll (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD     *Download,
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection
+  )
+{
+  HTTP_IO                      *HttpIo;
+  EFI_HTTP_MESSAGE             *Message;
+  EFI_HTTP_STATUS_CODE         StatusCode;
+  EFI_HTTP_BOOT_CALLBACK_PROTOCOL   *HttpBootCallback;
+  BOOLEAN                      IsDone;
+  UINTN                        ContentLength;
+  UINTN                        Offset;
+  UINTN                        Length;
+  EFI_STATUS                   Status;
+
+  HttpIo = &Connection->HttpIo;
+  IsDone = (Connection->State == HttpBootConnectionSending) ? HttpIo->IsTxDone : HttpIo->IsRxDone;
+  if (!IsDone) {
+    HttpIo->Http->Poll (HttpIo->Http);
+    if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+      return EFI_TIMEOUT;
+    }
+    return EFI_NOT_READY;
+  }
+
+  gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+
+  switch (Connection->State) {
+  case HttpBootConnectionSending:
+    if (EFI_ERROR (HttpIo->ReqToken.Status)) {
+      return HttpIo->ReqToken.Status;
+    }
+    return HttpBootRangeReceive (Download, Connection, TRUE);
+
+  case HttpBootConnectionReceivingHeader:
+    Status  = HttpIo->RspToken.Status;
+    Message = HttpIo->RspToken.Message;
+    if (EFI_ERROR (Status) && Status != EFI_HTTP_ERROR) {
+      return Status;
+    }
+
+    StatusCode = Connection->Response.StatusCode;
+    ContentLength = 0;
+    HttpIoGetContentLength (Message->HeaderCount, Message->Headers, &ContentLength);
+    if (Message->Headers != NULL) {
+      HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+      Message->Headers = NULL;
+    }
+
+    //
+    // A server that ignores the Range header answers with the whole file.
+    //
+    if (StatusCode == HTTP_STATUS_200_OK) {
+      return EFI_UNSUPPORTED;
+    }
+    if (StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+      DEBUG ((EFI_D_WARN, "HttpBootRangePoll: range %Lu, HTTP status %d.\n", (UINT64) Connection->Range, StatusCode));
+      return EFI_HTTP_ERROR;
+    }
+    HttpBootRangeOffset (Download, Connection->Range, &Length);
+    if (ContentLength != Length) {
+      return EFI_UNSUPPORTED;
+    }
+
+    //
+    // Progress is only reported for ranges received after a 206 reply, so the
+    // first one decides that the server honours the ranges.
+    //
+    Download->RangesHonoured = TRUE;
+    return HttpBootRangeReceive (Download, Connection, FALSE);
+
+  case HttpBootConnectionReceivingBody:
+    if (EFI_ERROR (HttpIo->RspToken.Status)) {
+      return HttpIo->RspToken.Status;
+    }
+
+    Connection->ReceivedSize += HttpIo->RspToken.Message->BodyLength;
+    Offset = HttpBootRangeOffset (Download, Connection->Range, &Length);
+    if (Connection->ReceivedSize < Length) {
+      return HttpBootRangeReceive (Download, Connection, FALSE);
+    }
+
+    //
+    // Report whole ranges only, so that a range that fails half way is not
+    // counted twice in the download progress.
+    //
+    HttpBootCallback = Download->Private->HttpBootCallback;
+    if (HttpBootCallback != NULL) {
+      Status = HttpBootCallback->Callback (
+                 HttpBootCallback,
+                 HttpBootHttpEntityBody,
+                 TRUE,
+                 (UINT32) Length,
+                 Download->Buffer + Offset
+                 );
+      if (EFI_ERROR (Status)) {
+        Download->Cancelled = TRUE;
+        return Status;
+      }
+    }
+
+    Download->Ranges[Connection->Range].State = HttpBootRangeDone;
+    Download->DoneCount++;
+    Connection->State = HttpBootConnectionIdle;
+    return EFI_SUCCESS;
+
+  default:
+    ASSERT (FALSE);
+    return EFI_SUCCESS;
+  }
+}
+
+/**
+  Handle the failure of the range on a connection: close the connection and put
+  the range back to be requested again, on this or another connection.
+
+  @param[in]    Download        The ranged download.
+  @param[in]    Connection      The connection which failed.
+  @param[in]    Error           The reason of the failure.
+
+  @retval EFI_SUCCESS           The range will be requested again.
+  @retval Others                The range failed too often, Error is returned.
+
+**/
+EFI_STATUS
+HttpBootRangeRetry (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD     *Download,
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection,
+  IN     EFI_STATUS                   Error
+  )
+{
+  HTTP_BOOT_RANGE              *Range;
+
+  HttpBootRangeCloseConnection (Connection);
+
+  Range = &Download->Ranges[Connection->Range];
+  Range->State = HttpBootRangePending;
+  Range->Attempts++;
+  DEBUG ((EFI_D_WARN, "HttpBootRangeRetry: range %Lu failed %Lu times, %r.\n", (UINT64) Connection->Range, (UINT64) Range->Attempts, Error));
+  if (Range->Attempts >= HTTP_BOOT_RANGE_MAX_ATTEMPTS) {
+    return Error;
+  }
+
+  Download->NextPending = MIN (Download->NextPending, Connection->Range);
+  return EFI_SUCCESS;
+}
+
+/**
+  This function downloads the boot file in byte ranges over several HTTP connections
+  at once, straight into the caller's buffer. A range that fails is requested again,
+  on a new connection.
+
+  The ranged download is only used if PcdHttpBootRangeConnections enables it, the
+  file spans more than one range, and the server announced support for byte ranges
+  in its reply to the HEAD request.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The ranged download is disabled or not usable with this file
+                                   or server. No download progress was reported, the caller
+                                   should use HttpBootGetBootFile().
+  @retval EFI_PROTOCOL_ERROR       The server stopped honouring the range requests after it had
+                                   honoured one.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval Others                   A range could not be downloaded.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanged (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN OUT UINTN                    *BufferSize,
+     OUT UINT8                    *Buffer,
+     OUT HTTP_BOOT_IMAGE_TYPE     *ImageType
+  )
+{
+  HTTP_BOOT_RANGE_DOWNLOAD     Download;
+  HTTP_BOOT_RANGE_CONNECTION   *Connection;
+  EFI_HTTP_MESSAGE             RequestMessage;
+  UINTN                        UrlSize;
+  UINTN                        Index;
+  EFI_STATUS                   Status;
+
+  ASSERT (Private != NULL);
+
+  if (BufferSize == NULL || Buffer == NULL || ImageType == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!Private->BootFileAcceptRanges || *BufferSize < Private->BootFileSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (&Download, sizeof (Download));
+  Download.Private         = Private;
+  Download.Buffer          = Buffer;
+  Download.FileSize        = Private->BootFileSize;
+  Download.RangeCount      = (Download.FileSize + HTTP_BOOT_RANGE_SIZE - 1) / HTTP_BOOT_RANGE_SIZE;
+  Download.ConnectionCount = MIN (PcdGet8 (PcdHttpBootRangeConnections), HTTP_BOOT_RANGE_MAX_CONNECTIONS);
+  Download.ConnectionCount = MIN (Download.ConnectionCount, Download.RangeCount);
+  if (Download.ConnectionCount < 2) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Download.Ranges      = AllocateZeroPool (Download.RangeCount * sizeof (HTTP_BOOT_RANGE));
+  Download.Connections = AllocateZeroPool (Download.ConnectionCount * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Download.Request.Method = HttpMethodGet;
+  Download.Request.Url    = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Download.Ranges == NULL || Download.Connections == NULL || Download.Request.Url == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Download.Request.Url, UrlSize);
+
+  //
+  // Every request carries the usual header fields plus its Range field.
+  //
+  for (Index = 0; Index < Download.ConnectionCount; Index++) {
+    Status = HttpBootCreateRequestHeader (Private, 4, &Download.Connections[Index].Header);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Report the download once, as a request for the whole file.
+  //
+  ZeroMem (&RequestMessage, sizeof (RequestMessage));
+  RequestMessage.Data.Request = &Download.Request;
+  RequestMessage.HeaderCount  = Download.Connections[0].Header->HeaderCount;
+  RequestMessage.Headers      = Download.Connections[0].Header->Headers;
+  Status = HttpBootHttpIoCallback (HttpIoRequest, &RequestMessage, Private);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  while (Download.DoneCount < Download.RangeCount) {
+    for (Index = 0; Index < Download.ConnectionCount; Index++) {
+      Connection = &Download.Connections[Index];
+      if (Connection->State == HttpBootConnectionIdle) {
+        Status = HttpBootRangeSendRequest (&Download, Connection);
+      } else {
+        Status = HttpBootRangePoll (&Download, Connection);
+      }
+
+      if (!EFI_ERROR (Status) || Status == EFI_NOT_READY) {
+        continue;
+      }
+      if (Status == EFI_UNSUPPORTED && Download.RangesHonoured) {
+        //
+        // The progress of the ranges already received cannot be taken back,
+        // so the caller must not download the whole file again.
+        //
+        DEBUG ((EFI_D_ERROR, "HttpBootGetBootFileRanged: range %Lu, the server no longer honours byte ranges.\n", (UINT64) Connection->Range));
+        Status = EFI_PROTOCOL_ERROR;
+        goto ON_EXIT;
+      }
+      if (Status == EFI_UNSUPPORTED || Download.Cancelled) {
+        goto ON_EXIT;
+      }
+      Status = HttpBootRangeRetry (&Download, Connection, Status);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  }
+
+  *BufferSize = Download.FileSize;
+  *ImageType  = Private->ImageType;
+  Status      = EFI_SUCCESS;
+
+ON_EXIT:
+  if (Download.Connections != NULL) {
+    for (Index = 0; Index < Download.ConnectionCount; Index++) {
+      HttpBootRangeCloseConnection (&Download.Connections[Index]);
+      if (Download.Connections[Index].Header != NULL) {
+        HttpIoFreeHeader (Download.Connections[Index].Header);
+      }
+    }
+    FreePool (Download.Connections);
+  }
+  if (Download.Ranges != NULL) {
+    FreePool (Download.Ranges);
+  }
+  if (Download.Request.Url != NULL) {
+    FreePool (Download.Request.Url);
+  }
+
+  return Status;
+}
@@ -14,6 +14,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_RESPONSE_TIMEOUT           5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_BLOCK_SIZE                 1500
 
+//
+// Ranged download of the boot file over several HTTP connections.
+//
+#define HTTP_BOOT_RANGE_SIZE                 SIZE_4MB
+#define HTTP_BOOT_RANGE_MAX_CONNECTIONS      8
+#define HTTP_BOOT_RANGE_MAX_ATTEMPTS         3
+
 
 
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT        "UefiHttpBoot/1.0"
@@ -62,6 +69,61 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+typedef enum {
+  HttpBootRangePending,
+  HttpBootRangeActive,
+  HttpBootRangeDone
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// One byte range of the boot file.
+//
+typedef struct {
+  HTTP_BOOT_RANGE_STATE      State;
+  UINTN                      Attempts;        // Failed attempts to download this range.
+} HTTP_BOOT_RANGE;
+
+typedef enum {
+  HttpBootConnectionIdle,
+  HttpBootConnectionSending,
+  HttpBootConnectionReceivingHeader,
+  HttpBootConnectionReceivingBody
+} HTTP_BOOT_CONNECTION_STATE;
+
+//
+// One HTTP child of a ranged download, fetching one range at a time.
+//
+typedef struct {
+  HTTP_IO                    HttpIo;
+  BOOLEAN                    HttpCreated;
+  HTTP_IO_HEADER             *Header;
+  HTTP_BOOT_CONNECTION_STATE State;
+  UINTN                      Range;           // Index of the range being downloaded.
+  UINTN                      ReceivedSize;    // Bytes of the range received so far.
+  EFI_HTTP_RESPONSE_DATA     Response;
+} HTTP_BOOT_RANGE_CONNECTION;
+
+//
+// State of a ranged download of the boot file.
+//
+typedef struct {
+  HTTP_BOOT_PRIVATE_DATA     *Private;
+  EFI_HTTP_REQUEST_DATA      Request;
+  UINT8                      *Buffer;
+  UINTN                      FileSize;
+
+  HTTP_BOOT_RANGE            *Ranges;
+  UINTN                      RangeCount;
+  UINTN                      NextPending;     // No pending range has a lower index.
+  UINTN                      DoneCount;
+
+  HTTP_BOOT_RANGE_CONNECTION *Connections;
+  UINTN                      ConnectionCount;
+
+  BOOLEAN                    RangesHonoured;  // A range got the 206 reply it asked for.
+  BOOLEAN                    Cancelled;       // The HTTP Boot callback aborted the download.
+} HTTP_BOOT_RANGE_DOWNLOAD;
+
 /**
   Discover all the boot information for boot file.
 
@@ -123,6 +185,37 @@ HttpBootGetBootFile (
      OUT HTTP_BOOT_IMAGE_TYPE     *ImageType
   );
 
+/**
+  This function downloads the boot file in byte ranges over several HTTP connections
+  at once, straight into the caller's buffer. A range that fails is requested again,
+  on a new connection.
+
+  The ranged download is only used if PcdHttpBootRangeConnections enables it, the
+  file spans more than one range, and the server announced support for byte ranges
+  in its reply to the HEAD request.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The ranged download is disabled or not usable with this file
+                                   or server. The caller should use HttpBootGetBootFile().
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval Others                   A range could not be downloaded.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanged (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN OUT UINTN                    *BufferSize,
+     OUT UINT8                    *Buffer,
+     OUT HTTP_BOOT_IMAGE_TYPE     *ImageType
+  );
+
 /**
   Clean up all cached data.
 
@@ -211,6 +211,11 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   UINTN                                     BootFileSize;
   BOOLEAN                                   NoGateway;
   HTTP_BOOT_IMAGE_TYPE                      ImageType;
+  //
+  // TRUE if the server announced "Accept-Ranges: bytes" in its reply to the
+  // HEAD request for the boot file.
+  //
+  BOOLEAN                                   BootFileAcceptRanges;
 
   //
   // URI string extracted from the input FilePath parameter.
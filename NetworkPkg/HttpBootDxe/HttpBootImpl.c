@@ -382,15 +382,23 @@ HttpBootLoadFile (
   }
 
   //
-  // Load the boot file into Buffer
+  // Load the boot file into Buffer, over several connections if possible.
   //
-  Status = HttpBootGetBootFile (
+  Status = HttpBootGetBootFileRanged (
              Private,
-             FALSE,
              BufferSize,
              Buffer,
              ImageType
              );
+  if (Status == EFI_UNSUPPORTED) {
+    Status = HttpBootGetBootFile (
+               Private,
+               FALSE,
+               BufferSize,
+               Buffer,
+               ImageType
+               );
+  }
 
 ON_EXIT:
   HttpBootUninstallCallback (Private);
@@ -455,6 +463,7 @@ HttpBootStop (
   Private->BootFileUri = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize = 0;
+  Private->BootFileAcceptRanges = FALSE;
   Private->SelectIndex = 0;
   Private->SelectProxyType = HttpOfferTypeMax;
 
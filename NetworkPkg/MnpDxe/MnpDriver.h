@@ -69,6 +69,12 @@ typedef struct {
 
   EFI_EVENT                     PollTimer;
   BOOLEAN                       EnableSystemPoll;
+  //
+  // The current period of PollTimer and the number of polls since the
+  // last frame was received.
+  //
+  UINT64                        PollInterval;
+  UINT32                        PollIdleCount;
 
   EFI_EVENT                     TimeoutCheckTimer;
   EFI_EVENT                     MediaDetectTimer;
@@ -13,7 +13,20 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define NET_ETHER_FCS_SIZE            4
 
+//
+// Timer events cannot fire more often than the platform timer interrupt,
+// whose period is set by the Timer Architectural Protocol. The active
+// interval only shortens the poll period on platforms that tick faster
+// than MNP_SYS_POLL_INTERVAL. With the default 10 millisecond tick, such as
+// that of the OVMF 8254 timer, both intervals poll once per tick, and only
+// MNP_RX_BUDGET and the MNP_RX_SPIN_TIME wait help a busy link.
+//
 #define MNP_SYS_POLL_INTERVAL         (10 * TICKS_PER_MS)   // 10 milliseconds
+#define MNP_SYS_POLL_ACTIVE_INTERVAL  (1 * TICKS_PER_MS)    // 1 millisecond
+#define MNP_SYS_POLL_IDLE_COUNT       16    // Idle polls before falling back to MNP_SYS_POLL_INTERVAL.
+#define MNP_RX_BUDGET                 32    // Frames received per poll at most.
+#define MNP_RX_SPIN_TIME              50    // 50 microseconds
+#define MNP_RX_SPIN_STALL             5     // 5 microseconds
 #define MNP_TIMEOUT_CHECK_INTERVAL    (50 * TICKS_PER_MS)   // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL     (500 * TICKS_PER_MS)  // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME           (500 * TICKS_PER_MS)  // 500 milliseconds
@@ -430,6 +443,28 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA   *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets pending in Snp, up to MNP_RX_BUDGET frames.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Spin                 If TRUE, wait up to MNP_RX_SPIN_TIME
+                                        microseconds for the next frame once
+                                        one has been received.
+  @param[out]      Received             The number of frames received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData,
+  IN     BOOLEAN           Spin,
+     OUT UINTN             *Received
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
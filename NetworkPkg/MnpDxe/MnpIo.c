@@ -1000,6 +1000,63 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets pending in Snp, up to MNP_RX_BUDGET frames.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Spin                 If TRUE, wait up to MNP_RX_SPIN_TIME
+                                        microseconds for the next frame once
+                                        one has been received.
+  @param[out]      Received             The number of frames received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA   *MnpDeviceData,
+  IN     BOOLEAN           Spin,
+     OUT UINTN             *Received
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       SpinTime;
+
+  *Received = 0;
+  SpinTime  = 0;
+
+  while (*Received < MNP_RX_BUDGET) {
+    Status = MnpReceivePacket (MnpDeviceData);
+
+    if (Status == EFI_NOT_READY) {
+      //
+      // The frames of a burst arrive a few microseconds apart. Waiting
+      // briefly for the next one is much cheaper than leaving it to the
+      // next timer tick.
+      //
+      if (!Spin || (*Received == 0) || (SpinTime >= MNP_RX_SPIN_TIME)) {
+        break;
+      }
+
+      gBS->Stall (MNP_RX_SPIN_STALL);
+      SpinTime += MNP_RX_SPIN_STALL;
+      continue;
+    }
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    (*Received)++;
+    SpinTime = 0;
+  }
+
+  return (*Received != 0) ? EFI_SUCCESS : Status;
+}
+
 
 /**
   Remove the received packets if timeout occurs.
@@ -1117,6 +1174,8 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINTN            Received;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
@@ -1124,10 +1183,30 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  MnpReceivePackets (MnpDeviceData, TRUE, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  //
+  // Poll faster while packets are arriving, and fall back to the slow
+  // interval after MNP_SYS_POLL_IDLE_COUNT polls without any.
+  //
+  if (Received != 0) {
+    MnpDeviceData->PollIdleCount = 0;
+    Interval                     = MNP_SYS_POLL_ACTIVE_INTERVAL;
+  } else if (MnpDeviceData->PollIdleCount < MNP_SYS_POLL_IDLE_COUNT) {
+    MnpDeviceData->PollIdleCount++;
+    Interval                     = MnpDeviceData->PollInterval;
+  } else {
+    Interval                     = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if (MnpDeviceData->EnableSystemPoll && (Interval != MnpDeviceData->PollInterval)) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
 }
@@ -758,6 +758,7 @@ MnpPoll (
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
   EFI_TPL            OldTpl;
+  UINTN              Received;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -773,9 +774,10 @@ MnpPoll (
   }
 
   //
-  // Try to receive packets.
+  // Try to receive the pending packets. The caller polls again soon
+  // anyway, so don't wait for more.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePackets (Instance->MnpServiceData->MnpDeviceData, FALSE, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -0,0 +1,185 @@
+/** @file
+  CUBIC congestion control defined in RFC8312.
+
+  The window is a cubic function of the time since the last congestion
+  event, whose plateau is the window at which the loss happened. Time is
+  counted in TCP ticks and the window in bytes, so the function is
+  W (t) = C * (t - K) ^ 3 * SMSS / TCP_TICK_HZ ^ 3 + W_max.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// C / TCP_TICK_HZ ^ 3 as a fraction.
+//
+#define TCP_CUBIC_SCALE_NUM  TCP_CUBIC_C_NUM
+#define TCP_CUBIC_SCALE_DEN  (TCP_CUBIC_C_DEN * TCP_TICK_HZ * TCP_TICK_HZ * TCP_TICK_HZ)
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value  The value to compute the cube root of.
+
+  @return The largest integer whose cube is not above Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64 Value
+  )
+{
+  UINT32  Root;
+  UINT32  Bit;
+  UINT32  Try;
+
+  Root = 0;
+
+  //
+  // The cube root of a 63 bit value has at most 21 bits.
+  //
+  for (Bit = 1 << 20; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+
+    if (MultU64x32 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Record a congestion event and compute the new slow start threshold.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCubicOnLoss (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  //
+  // Fast convergence: if the window didn't grow back to the
+  // last W_max, another flow is taking bandwidth. Lower W_max
+  // further to release bandwidth for it.
+  //
+  if (Tcb->CWnd < Tcb->CubicWMax) {
+    Tcb->CubicWMax = (UINT32) DivU64x32 (MultU64x32 (Tcb->CWnd, 10 + TCP_CUBIC_BETA), 20);
+  } else {
+    Tcb->CubicWMax = Tcb->CWnd;
+  }
+
+  Tcb->CubicEpoch = 0;
+
+  return MAX (
+           (UINT32) DivU64x32 (MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA), 10),
+           (UINT32) (2 * Tcb->SndMss)
+           );
+}
+
+/**
+  Grow the congestion window on an ACK of new data in congestion
+  avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicCongestionAvoid (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  UINT32  Mss;
+  UINT32  Time;
+  UINT32  Delta;
+  UINT64  Offset;
+  UINT64  Target;
+  UINT32  Increase;
+
+  Mss = Tcb->SndMss;
+
+  //
+  // Start a new epoch on the first ACK after a congestion event.
+  //
+  if (Tcb->CubicEpoch == 0) {
+    Tcb->CubicEpoch = mTcpTick;
+    Tcb->CubicWEst  = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+      Tcb->CubicK      = TcpCubicRoot (
+                           DivU64x32 (
+                             MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, TCP_CUBIC_SCALE_DEN),
+                             TCP_CUBIC_SCALE_NUM * Mss
+                             )
+                           );
+    } else {
+      Tcb->CubicOrigin = Tcb->CWnd;
+      Tcb->CubicK      = 0;
+    }
+  }
+
+  //
+  // Compute the target window W (t + RTT).
+  //
+  Time = TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT);
+
+  if (Time >= Tcb->CubicK) {
+    Delta = Time - Tcb->CubicK;
+  } else {
+    Delta = Tcb->CubicK - Time;
+  }
+
+  Delta  = MIN (Delta, TCP_CUBIC_MAX_TIME);
+  Offset = DivU64x32 (
+             MultU64x32 (MultU64x32 (MultU64x32 (Delta, Delta), Delta), TCP_CUBIC_SCALE_NUM * Mss),
+             TCP_CUBIC_SCALE_DEN
+             );
+
+  if (Time >= Tcb->CubicK) {
+    Target = Tcb->CubicOrigin + Offset;
+  } else if (Offset < Tcb->CubicOrigin) {
+    Target = Tcb->CubicOrigin - Offset;
+  } else {
+    Target = 0;
+  }
+
+  //
+  // Grow by (Target - CWnd) / CWnd segments per ACK, but not
+  // over 1.5 times the window in one round trip.
+  //
+  Target = MIN (Target, (UINT64) Tcb->CWnd + (Tcb->CWnd >> 1));
+
+  if (Target > Tcb->CWnd) {
+    Increase = (UINT32) DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Mss), Tcb->CWnd);
+  } else {
+    Increase = 0;
+  }
+
+  //
+  // TCP friendly region: the estimated NewReno window grows
+  // 3 * (1 - BETA) / (1 + BETA) segments per round trip. CUBIC
+  // never grows slower than that.
+  //
+  Tcb->CubicWEst += (UINT32) DivU64x32 (
+                               DivU64x32 (
+                                 MultU64x32 (MultU64x32 (Mss, Mss), 3 * (10 - TCP_CUBIC_BETA)),
+                                 10 + TCP_CUBIC_BETA
+                                 ),
+                               Tcb->CWnd
+                               );
+
+  if (Tcb->CubicWEst > Tcb->CWnd + Increase) {
+    Tcb->CWnd = Tcb->CubicWEst;
+  } else {
+    Tcb->CWnd += Increase;
+  }
+}
@@ -120,7 +120,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -198,7 +198,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -564,11 +564,17 @@ TcpConfigurePcb (
   Tcb->SRtt             = 0;
   Tcb->Rto              = 3 * TCP_TICK_HZ;
 
-  Tcb->CWnd             = Tcb->SndMss;
+  Tcb->CWnd             = TCP_INIT_CWND (Tcb->SndMss);
   Tcb->Ssthresh         = 0xffffffff;
 
   Tcb->CongestState     = TCP_CONGEST_OPEN;
 
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CONGEST_CTRL_CUBIC) {
+    Tcb->CongestCtrl    = TCP_CONGEST_CTRL_CUBIC;
+  } else {
+    Tcb->CongestCtrl    = TCP_CONGEST_CTRL_NEWRENO;
+  }
+
   Tcb->KeepAliveIdle    = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod  = TCP_KEEPALIVE_PERIOD;
   Tcb->MaxKeepAlive     = TCP_MAX_KEEPALIVE;
@@ -708,6 +714,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
@@ -360,6 +360,24 @@ TcpRetransmit (
   IN TCP_SEQNO Seq
   );
 
+/**
+  Retransmit the first hole in the SACK scoreboard that is not yet
+  retransmitted in this fast recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack     The acknowledge sequence number of the received
+                           segment. The holes start from it.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole is left to retransmit, or an error occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Ack
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -499,6 +517,87 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Update the SACK scoreboard as specified in RFC2018. The blocks
+  acknowledged by Ack are dropped, and the valid blocks reported
+  in Option are merged in.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+  @param[in]       Option   Pointer to the options of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack,
+  IN     TCP_OPTION *Option
+  );
+
+/**
+  Collect the SACK blocks to report from the out-of-order segments
+  on the reassemble queue, as specified in RFC2018.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the blocks.
+  @param[in]   MaxCount  The number of entries in Block, at least 1.
+
+  @return      The number of blocks stored in Block.
+
+**/
+UINT8
+TcpGetRcvSackBlocks (
+  IN     TCP_CB         *Tcb,
+     OUT TCP_SACK_BLOCK *Block,
+  IN     UINT8          MaxCount
+  );
+
+//
+// Functions in TcpCubic.c
+//
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value  The value to compute the cube root of.
+
+  @return The largest integer whose cube is not above Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64 Value
+  );
+
+/**
+  Record a congestion event and compute the new slow start threshold.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCubicOnLoss (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Grow the congestion window on an ACK of new data in congestion
+  avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicCongestionAvoid (
+  IN OUT TCP_CB *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
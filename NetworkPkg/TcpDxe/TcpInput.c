@@ -55,7 +55,12 @@ TcpFastRecover (
     //
     FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
 
-    Tcb->Ssthresh     = MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+    if (Tcb->CongestCtrl == TCP_CONGEST_CTRL_CUBIC) {
+      Tcb->Ssthresh   = TcpCubicOnLoss (Tcb);
+    } else {
+      Tcb->Ssthresh   = MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+    }
+
     Tcb->Recover      = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -65,7 +70,8 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd       = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackRxtNxt = Tcb->SndUna + Tcb->SndMss;
 
     DEBUG (
       (EFI_D_NET,
@@ -81,6 +87,22 @@ TcpFastRecover (
   //
   if (Seg->Ack == Tcb->SndUna) {
 
+    //
+    // With SACK, a duplicated ACK lets the next hole reported
+    // by the peer be retransmitted in place of new data, so
+    // several segments lost in one window are repaired within
+    // one round trip.
+    //
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) && (TcpSackRetransmit (Tcb, Seg->Ack) == 1)) {
+      DEBUG (
+        (EFI_D_NET,
+        "TcpFastRecover: retransmitted a hole reported by SACK for TCB %p\n",
+        Tcb)
+        );
+
+      return;
+    }
+
     //
     // Step 3: Fast Recovery,
     // If this is a duplicated ACK, increse Cwnd by SMSS.
@@ -126,9 +148,15 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, retransmit
+      // the first hole not yet retransmitted instead.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) && (Tcb->SackCount != 0)) {
+        TcpSackRetransmit (Tcb, Seg->Ack);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -1262,6 +1290,13 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard before the acks are counted.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1289,6 +1324,9 @@ TcpInput (
       if (Tcb->CWnd < Tcb->Ssthresh) {
 
         Tcb->CWnd += Tcb->SndMss;
+      } else if (Tcb->CongestCtrl == TCP_CONGEST_CTRL_CUBIC) {
+
+        TcpCubicCongestionAvoid (Tcb);
       } else {
 
         Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
@@ -1559,6 +1597,14 @@ StepSix:
       goto DISCARD;
     }
 
+    //
+    // Remember the latest out-of-order segment, its block
+    // is reported first in the SACK option.
+    //
+    if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      Tcb->RcvSackSeq = Seg->Seq;
+    }
+
     if (TcpDeliverData (Tcb) == -1) {
       goto RESET_THEN_DROP;
     }
@@ -83,6 +83,14 @@ TcpInitTcbLocal (
   Tcb->RetxmitSeqMax = 0;
 
   Tcb->ProbeTimerOn = FALSE;
+
+  //
+  // Start the connection without loss, SACK and CUBIC history.
+  //
+  Tcb->LossTimes   = 0;
+  Tcb->SackCount   = 0;
+  Tcb->CubicWMax   = 0;
+  Tcb->CubicEpoch  = 0;
 }
 
 /**
@@ -130,8 +138,6 @@ TcpInitTcbPeer (
     Tcb->RcvMss = 536;
   }
 
-  Tcb->CWnd   = Tcb->SndMss;
-
   Tcb->Irs    = Seg->Seq;
   Tcb->RcvNxt = Tcb->Irs + 1;
 
@@ -165,6 +171,21 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
+  //
+  // Use the initial window of RFC6928, or one segment
+  // if our SYN had to be retransmitted.
+  //
+  if (Tcb->LossTimes == 0) {
+    Tcb->CWnd = TCP_INIT_CWND (Tcb->SndMss);
+  } else {
+    Tcb->CWnd = Tcb->SndMss;
+  }
 }
 
 /**
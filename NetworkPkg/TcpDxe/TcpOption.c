@@ -159,6 +159,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option, only when not disabled
+  // by the application, and either we are doing active open
+  // or the peer has permitted SACK.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      ) {
+
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -186,8 +208,11 @@ TcpBuildOption (
   IN NET_BUF *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCKS];
+  UINT8           Count;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -213,6 +238,47 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if out-of-order data is queued. Only
+  // segments without data carry it, so that a full sized segment
+  // never exceeds the MSS.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (Nbuf->TotalSize == 0) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      ) {
+
+    Count = TcpGetRcvSackBlocks (
+              Tcb,
+              Block,
+              (UINT8) MIN (
+                        TCP_OPTION_MAX_SACK_BLOCKS,
+                        (TCP_OPTION_MAX_LEN - TCP_OPTION_SACK_ALIGNED_HEAD_LEN - Len) / TCP_OPTION_SACK_BLOCK_LEN
+                        )
+              );
+  } else {
+    Count = 0;
+  }
+
+  if (Count != 0) {
+    Data = NetbufAllocSpace (
+            Nbuf,
+            TCP_OPTION_SACK_ALIGNED_HEAD_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN,
+            NET_BUF_HEAD
+            );
+
+    ASSERT (Data != NULL);
+    Len = (UINT16) (Len + TCP_OPTION_SACK_ALIGNED_HEAD_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN);
+
+    TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Count * TCP_OPTION_SACK_BLOCK_LEN));
+
+    for (Index = 0; Index < Count; Index++) {
+      TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+      TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+    }
+  }
+
   return Len;
 }
 
@@ -238,10 +304,12 @@ TcpParseOption (
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag  = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen      = (UINT8) ((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -313,6 +381,41 @@ TcpParseOption (
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+          (TotalLen - Cur < Len)) {
+
+        return -1;
+      }
+
+      Option->SackCount = (UINT8) MIN ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN, TCP_OPTION_MAX_SACK_BLOCKS);
+
+      for (Index = 0; Index < Option->SackCount; Index++) {
+        Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
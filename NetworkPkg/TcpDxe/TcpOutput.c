@@ -735,6 +735,61 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the first hole in the SACK scoreboard that is not yet
+  retransmitted in this fast recovery. A hole is the sequence space
+  below the highest SACKed block which the peer hasn't received.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack     The acknowledge sequence number of the received
+                           segment. The holes start from it.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole is left to retransmit, or an error occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Ack
+  )
+{
+  TCP_SEQNO Seq;
+  UINT32    Len;
+  UINT8     Index;
+
+  Seq = Tcb->SackRxtNxt;
+  if (TCP_SEQ_LT (Seq, Ack)) {
+    Seq = Ack;
+  }
+
+  //
+  // Skip the SACKed data, the blocks are sorted by sequence.
+  //
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Right)) {
+      Seq = Tcb->SackBlock[Index].Right;
+    }
+  }
+
+  if (Index == Tcb->SackCount) {
+    return 0;
+  }
+
+  Len = MIN (TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Seq), Tcb->SndMss);
+
+  if (TcpRetransmit (Tcb, Seq) != 0) {
+    return 0;
+  }
+
+  Tcb->SackRxtNxt = Seq + Len;
+  return 1;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
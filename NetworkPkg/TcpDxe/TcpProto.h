@@ -54,6 +54,12 @@
 #define TCP_CONGEST_LOSS         2  ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN         3  ///< TCP is opening its congestion window.
 
+//
+// Congestion control algorithm used in congestion avoidance.
+//
+#define TCP_CONGEST_CTRL_NEWRENO 0  ///< RFC5681 and RFC6582 NewReno.
+#define TCP_CONGEST_CTRL_CUBIC   1  ///< RFC8312 CUBIC.
+
 //
 // TCP control flags
 //
@@ -72,6 +78,8 @@
 #define TCP_CTRL_TIMER_ON        0x1000 ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON          0x2000 ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW         0x4000 ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK         0x8000 ///< Disable selective acknowledgement.
+#define TCP_CTRL_RCVD_SACK       0x10000 ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -108,6 +116,28 @@
 //
 #define TCP_MAX_HEAD             192
 
+//
+// Initial congestion window as suggested by RFC6928:
+// min (10 * MSS, max (2 * MSS, 14600))
+//
+#define TCP_INIT_CWND(Mss)       MIN (10 * (UINT32) (Mss), MAX (2 * (UINT32) (Mss), 14600))
+
+//
+// Number of SACKed blocks the sender keeps in its scoreboard.
+//
+#define TCP_SACK_SCOREBOARD_SIZE 8
+
+//
+// CUBIC constants, RFC8312. BETA is scaled by 10, the window is
+// reduced to 7/10 of its size on a loss. C is 0.4, kept as a
+// fraction. The distance in time to the plateau of the cubic
+// function is capped so it can be computed with 64 bit integers.
+//
+#define TCP_CUBIC_BETA           7
+#define TCP_CUBIC_C_NUM          2
+#define TCP_CUBIC_C_DEN          5
+#define TCP_CUBIC_MAX_TIME       (TCP_TICK_HZ * 60 * 10)
+
 //
 // Value ranges for some control option
 //
@@ -227,6 +257,14 @@ typedef struct _TCP_PEER {
   TCP_PORTNO      Port;   ///< Port number, in network byte order.
 } TCP_PEER;
 
+///
+/// A block of contiguous sequence space, as carried in the SACK option.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO Left;   ///< The first sequence number of the block.
+  TCP_SEQNO Right;  ///< The sequence number following the last byte of the block.
+} TCP_SACK_BLOCK;
+
 typedef struct _TCP_CONTROL_BLOCK  TCP_CB;
 
 ///
@@ -309,6 +347,24 @@ struct _TCP_CONTROL_BLOCK {
   UINT8             LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO         LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 selective acknowledgement.
+  //
+  TCP_SACK_BLOCK    SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Data SACKed by the peer, sorted by sequence.
+  UINT8             SackCount;    ///< Number of blocks in SackBlock.
+  TCP_SEQNO         SackRxtNxt;   ///< Next hole sequence to retransmit in fast recovery.
+  TCP_SEQNO         RcvSackSeq;   ///< Seq of the latest out-of-order segment received.
+
+  //
+  // RFC8312 CUBIC congestion control.
+  //
+  UINT8             CongestCtrl;  ///< TCP_CONGEST_CTRL_NEWRENO or TCP_CONGEST_CTRL_CUBIC.
+  UINT32            CubicWMax;    ///< Congestion window before the last reduction.
+  UINT32            CubicOrigin;  ///< Window the cubic function plateaus at.
+  UINT32            CubicK;       ///< Ticks for the window to grow to CubicOrigin.
+  UINT32            CubicEpoch;   ///< Tick the congestion avoidance epoch started, 0 if not started.
+  UINT32            CubicWEst;    ///< Estimated NewReno window, for the TCP friendly region.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -0,0 +1,218 @@
+/** @file
+  Selective acknowledgement defined in RFC2018.
+
+  As sender, the blocks SACKed by the peer are kept in a scoreboard sorted
+  by sequence number. As receiver, the out-of-order data on the reassemble
+  queue is reported in SACK blocks.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Update the SACK scoreboard as specified in RFC2018. The blocks
+  acknowledged by Ack are dropped, and the valid blocks reported
+  in Option are merged in.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+  @param[in]       Option   Pointer to the options of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack,
+  IN     TCP_OPTION *Option
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEQNO       MaxSndNxt;
+  TCP_SEQNO       Left;
+  TCP_SEQNO       Right;
+  UINT8           Index;
+  UINT8           Next;
+  UINT8           Sack;
+
+  Block = Tcb->SackBlock;
+
+  //
+  // Drop the blocks which are cumulatively acknowledged now.
+  //
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_GT (Block[Index].Right, Ack)) {
+      break;
+    }
+  }
+
+  Tcb->SackCount = (UINT8) (Tcb->SackCount - Index);
+  CopyMem (&Block[0], &Block[Index], Tcb->SackCount * sizeof (TCP_SACK_BLOCK));
+
+  if ((Tcb->SackCount != 0) && TCP_SEQ_LT (Block[0].Left, Ack)) {
+    Block[0].Left = Ack;
+  }
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  MaxSndNxt = TcpGetMaxSndNxt (Tcb);
+
+  for (Sack = 0; Sack < Option->SackCount; Sack++) {
+    Left  = Option->Sack[Sack].Left;
+    Right = Option->Sack[Sack].Right;
+
+    //
+    // Ignore the blocks out of the sequence space in flight,
+    // including the D-SACK blocks below Ack.
+    //
+    if (!TCP_SEQ_LT (Left, Right) || TCP_SEQ_LT (Left, Ack) || TCP_SEQ_GT (Right, MaxSndNxt)) {
+      continue;
+    }
+
+    //
+    // Find the first block which ends at or after Left.
+    //
+    for (Index = 0; Index < Tcb->SackCount; Index++) {
+      if (TCP_SEQ_GEQ (Block[Index].Right, Left)) {
+        break;
+      }
+    }
+
+    if ((Index < Tcb->SackCount) && TCP_SEQ_LEQ (Block[Index].Left, Right)) {
+      //
+      // Merge into Block[Index], then absorb the following
+      // blocks the merged block reaches.
+      //
+      if (TCP_SEQ_LT (Left, Block[Index].Left)) {
+        Block[Index].Left = Left;
+      }
+
+      if (TCP_SEQ_GT (Right, Block[Index].Right)) {
+        Block[Index].Right = Right;
+      }
+
+      for (Next = (UINT8) (Index + 1); Next < Tcb->SackCount; Next++) {
+        if (TCP_SEQ_GT (Block[Next].Left, Block[Index].Right)) {
+          break;
+        }
+
+        if (TCP_SEQ_GT (Block[Next].Right, Block[Index].Right)) {
+          Block[Index].Right = Block[Next].Right;
+        }
+      }
+
+      CopyMem (
+        &Block[Index + 1],
+        &Block[Next],
+        (Tcb->SackCount - Next) * sizeof (TCP_SACK_BLOCK)
+        );
+      Tcb->SackCount = (UINT8) (Tcb->SackCount - (Next - Index - 1));
+      continue;
+    }
+
+    //
+    // Insert a new block. When the scoreboard is full, the
+    // highest block is given up, the lower holes are the
+    // ones to retransmit first.
+    //
+    if (Tcb->SackCount == TCP_SACK_SCOREBOARD_SIZE) {
+      if (Index == Tcb->SackCount) {
+        continue;
+      }
+
+      Tcb->SackCount--;
+    }
+
+    CopyMem (
+      &Block[Index + 1],
+      &Block[Index],
+      (Tcb->SackCount - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+    Block[Index].Left  = Left;
+    Block[Index].Right = Right;
+    Tcb->SackCount++;
+  }
+}
+
+/**
+  Collect the SACK blocks to report from the out-of-order segments
+  on the reassemble queue, as specified in RFC2018. The block holding
+  the latest out-of-order segment received is reported first, the
+  others follow in sequence order.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the blocks.
+  @param[in]   MaxCount  The number of entries in Block, at least 1.
+
+  @return      The number of blocks stored in Block.
+
+**/
+UINT8
+TcpGetRcvSackBlocks (
+  IN     TCP_CB         *Tcb,
+     OUT TCP_SACK_BLOCK *Block,
+  IN     UINT8          MaxCount
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Range;
+  BOOLEAN         Recent;
+  UINT8           Count;
+
+  ASSERT (MaxCount > 0);
+
+  Recent = FALSE;
+  Count  = 0;
+  Entry  = Tcb->RcvQue.ForwardLink;
+
+  while (Entry != &Tcb->RcvQue) {
+    Seg         = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    Range.Left  = Seg->Seq;
+    Range.Right = Seg->End;
+
+    //
+    // Merge the contiguous segments that follow into the block.
+    //
+    for (Entry = Entry->ForwardLink; Entry != &Tcb->RcvQue; Entry = Entry->ForwardLink) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      if (TCP_SEQ_GT (Seg->Seq, Range.Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_GT (Seg->End, Range.Right)) {
+        Range.Right = Seg->End;
+      }
+    }
+
+    if (!Recent &&
+        TCP_SEQ_LEQ (Range.Left, Tcb->RcvSackSeq) &&
+        TCP_SEQ_LT (Tcb->RcvSackSeq, Range.Right)
+        ) {
+      //
+      // Move the block holding the latest segment to the front,
+      // giving up the highest block collected if Block is full.
+      //
+      if (Count == MaxCount) {
+        Count--;
+      }
+
+      CopyMem (&Block[1], &Block[0], Count * sizeof (TCP_SACK_BLOCK));
+      CopyMem (&Block[0], &Range, sizeof (TCP_SACK_BLOCK));
+      Count++;
+      Recent = TRUE;
+    } else if (Count < MaxCount) {
+
+      CopyMem (&Block[Count], &Range, sizeof (TCP_SACK_BLOCK));
+      Count++;
+    }
+  }
+
+  return Count;
+}
@@ -195,14 +195,26 @@ TcpRexmitTimeout (
   //
   // Set the congestion window. FlightSize is the
   // amount of data that has been sent but not
-  // yet ACKed.
+  // yet ACKed. CUBIC reduces the window once per
+  // loss, not again for each timeout in a row.
   //
   FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh     = MAX ((UINT32) (2 * Tcb->SndMss), FlightSize / 2);
+
+  if (Tcb->CongestCtrl != TCP_CONGEST_CTRL_CUBIC) {
+    Tcb->Ssthresh   = MAX ((UINT32) (2 * Tcb->SndMss), FlightSize / 2);
+  } else if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    Tcb->Ssthresh   = TcpCubicOnLoss (Tcb);
+  }
 
   Tcb->CWnd         = Tcb->SndMss;
   Tcb->LossRecover  = Tcb->SndNxt;
 
+  //
+  // The peer may discard the data it has SACKed, RFC2018
+  // requires to turn off the SACKed bits after a timeout.
+  //
+  Tcb->SackCount    = 0;
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
 
@@ -0,0 +1,879 @@
+/** @file
+  Unit tests of the TCP SACK scoreboard, CUBIC congestion avoidance and
+  RFC6928 initial window.
+
+  TcpSack.c, TcpCubic.c and TcpMisc.c are built into this application
+  unchanged. The functions they call from the rest of TcpDxe, NetLib and
+  DevicePathLib are replaced by the minimal versions below; the tests only
+  reach TcpGetMaxSndNxt () and the IP4 GetModeData () behind
+  TcpGetRcvMss ().
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../TcpMain.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME        "TcpDxe Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+#define TEST_MSS                  1460
+
+//
+// The maximum segment sizes of the test peers, and the IP4 MTU of the
+// local end.
+//
+typedef struct {
+  UINT16   PeerMss;
+  UINT32   MaxPacketSize;
+  UINT8    LossTimes;
+  UINT32   CWnd;
+} INIT_CWND_CONTEXT;
+
+STATIC INIT_CWND_CONTEXT  mEthernetCwnd = { 1460, 1480, 0, 10 * 1460 };
+STATIC INIT_CWND_CONTEXT  mSmallMssCwnd = { 536,  1480, 0, 10 * 536  };
+STATIC INIT_CWND_CONTEXT  mJumboCwnd    = { 8960, 8980, 0, 2 * 8960  };
+STATIC INIT_CWND_CONTEXT  mSynLostCwnd  = { 1460, 1480, 1, 1460      };
+
+UINT32                    mTcpTick = 1000;
+EFI_BOOT_SERVICES         *gBS     = NULL;
+STATIC UINT32             mIp4MaxPacketSize;
+
+//
+// The TcpDxe, NetLib and DevicePathLib functions used by TcpMisc.c and
+// TcpSack.c.
+//
+TCP_SEQNO
+TcpGetMaxSndNxt (
+  IN TCP_CB *Tcb
+  )
+{
+  //
+  // The send queue of the test TCBs is empty.
+  //
+  return Tcb->SndNxt;
+}
+
+UINT8
+TcpComputeScale (
+  IN TCP_CB *Tcb
+  )
+{
+  return 0;
+}
+
+VOID
+TcpClose (
+  IN OUT TCP_CB *Tcb
+  )
+{
+}
+
+UINT32
+TcpRcvWinNow (
+  IN TCP_CB *Tcb
+  )
+{
+  return 0;
+}
+
+UINT32
+TcpRcvWinOld (
+  IN TCP_CB *Tcb
+  )
+{
+  return 0;
+}
+
+VOID
+TcpSendAck (
+  IN OUT TCP_CB *Tcb
+  )
+{
+}
+
+INTN
+TcpSendIpPacket (
+  IN TCP_CB          *Tcb,
+  IN NET_BUF         *Nbuf,
+  IN EFI_IP_ADDRESS  *Src,
+  IN EFI_IP_ADDRESS  *Dest,
+  IN UINT8           Version
+  )
+{
+  return -1;
+}
+
+VOID
+TcpSetTimer (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT16 Timer,
+  IN     UINT32 TimeOut
+  )
+{
+}
+
+INTN
+TcpToSendData (
+  IN OUT TCP_CB *Tcb,
+  IN     INTN   Force
+  )
+{
+  return 0;
+}
+
+SOCKET *
+SockClone (
+  IN SOCKET *Sock
+  )
+{
+  return NULL;
+}
+
+VOID
+SockConnClosed (
+  IN OUT SOCKET *Sock
+  )
+{
+}
+
+VOID
+SockConnEstablished (
+  IN OUT SOCKET *Sock
+  )
+{
+}
+
+UINT16
+EFIAPI
+NetAddChecksum (
+  IN UINT16                 Checksum1,
+  IN UINT16                 Checksum2
+  )
+{
+  return 0;
+}
+
+UINT16
+EFIAPI
+NetIp6PseudoHeadChecksum (
+  IN EFI_IPv6_ADDRESS       *Src,
+  IN EFI_IPv6_ADDRESS       *Dst,
+  IN UINT8                  NextHeader,
+  IN UINT32                 Len
+  )
+{
+  return 0;
+}
+
+UINT16
+EFIAPI
+NetPseudoHeadChecksum (
+  IN IP4_ADDR               Src,
+  IN IP4_ADDR               Dst,
+  IN UINT8                  Proto,
+  IN UINT16                 Len
+  )
+{
+  return 0;
+}
+
+VOID
+EFIAPI
+NetLibCreateIPv4DPathNode (
+  IN OUT IPv4_DEVICE_PATH  *Node,
+  IN EFI_HANDLE            Controller,
+  IN IP4_ADDR              LocalIp,
+  IN UINT16                LocalPort,
+  IN IP4_ADDR              RemoteIp,
+  IN UINT16                RemotePort,
+  IN UINT16                Protocol,
+  IN BOOLEAN               UseDefaultAddress
+  )
+{
+}
+
+VOID
+EFIAPI
+NetLibCreateIPv6DPathNode (
+  IN OUT IPv6_DEVICE_PATH  *Node,
+  IN EFI_HANDLE            Controller,
+  IN EFI_IPv6_ADDRESS      *LocalIp,
+  IN UINT16                LocalPort,
+  IN EFI_IPv6_ADDRESS      *RemoteIp,
+  IN UINT16                RemotePort,
+  IN UINT16                Protocol
+  )
+{
+}
+
+NET_BUF  *
+EFIAPI
+NetbufAlloc (
+  IN UINT32                 Len
+  )
+{
+  return NULL;
+}
+
+UINT8*
+EFIAPI
+NetbufAllocSpace (
+  IN OUT NET_BUF            *Nbuf,
+  IN UINT32                 Len,
+  IN BOOLEAN                FromHead
+  )
+{
+  return NULL;
+}
+
+UINT16
+EFIAPI
+NetbufChecksum (
+  IN NET_BUF                *Nbuf
+  )
+{
+  return 0;
+}
+
+VOID
+EFIAPI
+NetbufFree (
+  IN NET_BUF                *Nbuf
+  )
+{
+}
+
+UINT8  *
+EFIAPI
+NetbufGetByte (
+  IN  NET_BUF               *Nbuf,
+  IN  UINT32                Offset,
+  OUT UINT32                *Index  OPTIONAL
+  )
+{
+  return NULL;
+}
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePathNode (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,     OPTIONAL
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePathNode  OPTIONAL
+  )
+{
+  return NULL;
+}
+
+/**
+  Returns the mode data of the IP4 instance under the test socket, whose
+  MaxPacketSize is mIp4MaxPacketSize.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestIp4GetModeData (
+  IN  CONST EFI_IP4_PROTOCOL                *This,
+  OUT       EFI_IP4_MODE_DATA               *Ip4ModeData     OPTIONAL,
+  OUT       EFI_MANAGED_NETWORK_CONFIG_DATA *MnpConfigData   OPTIONAL,
+  OUT       EFI_SIMPLE_NETWORK_MODE         *SnpModeData     OPTIONAL
+  )
+{
+  if (Ip4ModeData != NULL) {
+    Ip4ModeData->MaxPacketSize = mIp4MaxPacketSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Passes SACK blocks to TcpSackUpdate () as if they arrived in a segment.
+
+  @param[in, out]  Tcb    The TCB whose scoreboard is updated.
+  @param[in]       Ack    The acknowledge sequence number of the segment.
+  @param[in]       Count  The number of blocks.
+  @param[in]       ...    The left and right edge of each block, as UINT32.
+**/
+STATIC
+VOID
+EFIAPI
+ReceiveSack (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack,
+  IN     UINT8      Count,
+  ...
+  )
+{
+  TCP_OPTION  Option;
+  VA_LIST     Args;
+  UINT8       Index;
+
+  ZeroMem (&Option, sizeof (Option));
+  if (Count != 0) {
+    Option.Flag = TCP_OPTION_RCVD_SACK;
+  }
+
+  Option.SackCount = Count;
+
+  VA_START (Args, Count);
+  for (Index = 0; Index < Count; Index++) {
+    Option.Sack[Index].Left  = VA_ARG (Args, UINT32);
+    Option.Sack[Index].Right = VA_ARG (Args, UINT32);
+  }
+
+  VA_END (Args);
+
+  TcpSackUpdate (Tcb, Ack, &Option);
+}
+
+/**
+  Checks a block of the SACK scoreboard or of the blocks to report.
+**/
+#define CHECK_BLOCK(Block, L, R)              \
+  do {                                        \
+    UT_ASSERT_EQUAL ((Block).Left, (L));      \
+    UT_ASSERT_EQUAL ((Block).Right, (R));     \
+  } while (FALSE)
+
+/**
+  Reported blocks should be merged into the scoreboard, which stays sorted
+  by sequence number.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SackUpdateShouldMergeBlocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndNxt = 10000;
+
+  ReceiveSack (&Tcb, 1000, 1, 3000, 4000);
+  ReceiveSack (&Tcb, 1000, 1, 5000, 6000);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 2);
+  CHECK_BLOCK (Tcb.SackBlock[0], 3000, 4000);
+  CHECK_BLOCK (Tcb.SackBlock[1], 5000, 6000);
+
+  //
+  // A block adjacent to another one extends it.
+  //
+  ReceiveSack (&Tcb, 1000, 1, 2000, 3000);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 2);
+  CHECK_BLOCK (Tcb.SackBlock[0], 2000, 4000);
+
+  //
+  // A block bridging two others merges them.
+  //
+  ReceiveSack (&Tcb, 1000, 1, 3500, 5500);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 1);
+  CHECK_BLOCK (Tcb.SackBlock[0], 2000, 6000);
+
+  //
+  // Blocks reported out of order in one option are sorted.
+  //
+  ReceiveSack (&Tcb, 1000, 2, 8000, 9000, 7000, 7500);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 3);
+  CHECK_BLOCK (Tcb.SackBlock[0], 2000, 6000);
+  CHECK_BLOCK (Tcb.SackBlock[1], 7000, 7500);
+  CHECK_BLOCK (Tcb.SackBlock[2], 8000, 9000);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Blocks cumulatively acknowledged should leave the scoreboard, and a block
+  the acknowledgement reaches into should be trimmed.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SackUpdateShouldDropAckedBlocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndNxt = 10000;
+
+  ReceiveSack (&Tcb, 1000, 3, 2000, 3000, 4000, 5000, 6000, 7000);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 3);
+
+  ReceiveSack (&Tcb, 5000, 0);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 1);
+  CHECK_BLOCK (Tcb.SackBlock[0], 6000, 7000);
+
+  ReceiveSack (&Tcb, 6500, 0);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 1);
+  CHECK_BLOCK (Tcb.SackBlock[0], 6500, 7000);
+
+  ReceiveSack (&Tcb, 7000, 0);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Empty blocks, D-SACK blocks below the acknowledgement and blocks beyond
+  the data sent should be ignored.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SackUpdateShouldIgnoreInvalidBlocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndNxt = 10000;
+
+  ReceiveSack (&Tcb, 5000, 4, 6000, 6000, 7000, 6000, 4000, 4500, 9000, 10500);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 0);
+
+  //
+  // The sequence space may wrap around.
+  //
+  Tcb.SndNxt = 0x1000;
+  ReceiveSack (&Tcb, 0xFFFFF000, 1, 0xFFFFFF00, 0x100);
+  UT_ASSERT_EQUAL (Tcb.SackCount, 1);
+  CHECK_BLOCK (Tcb.SackBlock[0], 0xFFFFFF00, 0x100);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A full scoreboard should keep the lowest blocks, which cover the holes to
+  retransmit first.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SackUpdateShouldKeepLowestBlocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+  UINT32  Index;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndNxt = 20000;
+
+  for (Index = 0; Index < TCP_SACK_SCOREBOARD_SIZE; Index++) {
+    ReceiveSack (&Tcb, 1000, 1, 2000 + Index * 1000, 2500 + Index * 1000);
+  }
+
+  UT_ASSERT_EQUAL (Tcb.SackCount, TCP_SACK_SCOREBOARD_SIZE);
+
+  ReceiveSack (&Tcb, 1000, 1, 15000, 15500);
+  UT_ASSERT_EQUAL (Tcb.SackCount, TCP_SACK_SCOREBOARD_SIZE);
+  CHECK_BLOCK (Tcb.SackBlock[TCP_SACK_SCOREBOARD_SIZE - 1], 1000 + TCP_SACK_SCOREBOARD_SIZE * 1000, 1500 + TCP_SACK_SCOREBOARD_SIZE * 1000);
+
+  ReceiveSack (&Tcb, 1000, 1, 1200, 1300);
+  UT_ASSERT_EQUAL (Tcb.SackCount, TCP_SACK_SCOREBOARD_SIZE);
+  CHECK_BLOCK (Tcb.SackBlock[0], 1200, 1300);
+  CHECK_BLOCK (Tcb.SackBlock[1], 2000, 2500);
+  CHECK_BLOCK (Tcb.SackBlock[TCP_SACK_SCOREBOARD_SIZE - 1], TCP_SACK_SCOREBOARD_SIZE * 1000, 500 + TCP_SACK_SCOREBOARD_SIZE * 1000);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The out-of-order data on the reassemble queue should be reported with the
+  block holding the latest segment first and the others in sequence order.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RcvSackBlocksShouldReportLatestFirst (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  //
+  // Segments on the reassemble queue. The first two are contiguous.
+  //
+  STATIC CONST TCP_SACK_BLOCK  Segments[] = {
+    { 100, 200 }, { 200, 300 }, { 400, 500 }, { 600, 700 }, { 800, 900 }
+  };
+  TCP_CB          Tcb;
+  NET_BUF         Nbuf[ARRAY_SIZE (Segments)];
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCKS];
+  UINTN           Index;
+  UINT8           Count;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  ZeroMem (Nbuf, sizeof (Nbuf));
+  InitializeListHead (&Tcb.RcvQue);
+  for (Index = 0; Index < ARRAY_SIZE (Segments); Index++) {
+    TCPSEG_NETBUF (&Nbuf[Index])->Seq = Segments[Index].Left;
+    TCPSEG_NETBUF (&Nbuf[Index])->End = Segments[Index].Right;
+    InsertTailList (&Tcb.RcvQue, &Nbuf[Index].List);
+  }
+
+  Tcb.RcvSackSeq = 600;
+  Count          = TcpGetRcvSackBlocks (&Tcb, Block, 4);
+  UT_ASSERT_EQUAL (Count, 4);
+  CHECK_BLOCK (Block[0], 600, 700);
+  CHECK_BLOCK (Block[1], 100, 300);
+  CHECK_BLOCK (Block[2], 400, 500);
+  CHECK_BLOCK (Block[3], 800, 900);
+
+  //
+  // With less room, the latest block is still reported first.
+  //
+  Tcb.RcvSackSeq = 800;
+  Count          = TcpGetRcvSackBlocks (&Tcb, Block, 3);
+  UT_ASSERT_EQUAL (Count, 3);
+  CHECK_BLOCK (Block[0], 800, 900);
+  CHECK_BLOCK (Block[1], 100, 300);
+  CHECK_BLOCK (Block[2], 400, 500);
+
+  Tcb.RcvSackSeq = 250;
+  Count          = TcpGetRcvSackBlocks (&Tcb, Block, 1);
+  UT_ASSERT_EQUAL (Count, 1);
+  CHECK_BLOCK (Block[0], 100, 300);
+
+  //
+  // If no block holds the latest segment, all the room is used.
+  //
+  Tcb.RcvSackSeq = 350;
+  Count          = TcpGetRcvSackBlocks (&Tcb, Block, 4);
+  UT_ASSERT_EQUAL (Count, 4);
+  CHECK_BLOCK (Block[0], 100, 300);
+  CHECK_BLOCK (Block[3], 800, 900);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  TcpCubicRoot () should return the largest integer whose cube is not above
+  its argument.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CubicRootShouldBeExact (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Root;
+
+  UT_ASSERT_EQUAL (TcpCubicRoot (0), 0);
+  UT_ASSERT_EQUAL (TcpCubicRoot (1), 1);
+  UT_ASSERT_EQUAL (TcpCubicRoot (7), 1);
+  UT_ASSERT_EQUAL (TcpCubicRoot (8), 2);
+  UT_ASSERT_EQUAL (TcpCubicRoot (26), 2);
+  UT_ASSERT_EQUAL (TcpCubicRoot (27), 3);
+  UT_ASSERT_EQUAL (TcpCubicRoot (999999), 99);
+  UT_ASSERT_EQUAL (TcpCubicRoot (1000000), 100);
+  UT_ASSERT_EQUAL (TcpCubicRoot (0x7FFFFFFFFFFFFFFFULL), 0x1FFFFF);
+
+  for (Root = 1; Root < 5000; Root += 7) {
+    UT_ASSERT_EQUAL (TcpCubicRoot (MultU64x32 (MultU64x32 (Root, Root), Root)), Root);
+    UT_ASSERT_EQUAL (TcpCubicRoot (MultU64x32 (MultU64x32 (Root, Root), Root) - 1), Root - 1);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  After a loss at W_max, K should be the time in TCP ticks the cubic
+  function takes to grow back to W_max, and the window should reach W_max
+  K ticks after the epoch started.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CubicShouldReachWMaxAfterK (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+  UINT32  Epoch;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndMss = TEST_MSS;
+  Tcb.CWnd   = 100 * TEST_MSS;
+
+  //
+  // The window is reduced to BETA = 0.7 of W_max.
+  //
+  Tcb.Ssthresh = TcpCubicOnLoss (&Tcb);
+  UT_ASSERT_EQUAL (Tcb.CubicWMax, 100 * TEST_MSS);
+  UT_ASSERT_EQUAL (Tcb.Ssthresh, 70 * TEST_MSS);
+
+  //
+  // K = cbrt (W_max * (1 - BETA) / C) = cbrt (30 / 0.4) = 4.22 seconds,
+  // 21 ticks at 5 ticks a second.
+  //
+  Epoch    = mTcpTick;
+  Tcb.CWnd = Tcb.Ssthresh;
+  TcpCubicCongestionAvoid (&Tcb);
+  UT_ASSERT_EQUAL (Tcb.CubicEpoch, Epoch);
+  UT_ASSERT_EQUAL (Tcb.CubicOrigin, 100 * TEST_MSS);
+  UT_ASSERT_EQUAL (Tcb.CubicK, 21);
+
+  //
+  // At K the target is W_max, so the window grows by (W_max - cwnd) / cwnd
+  // segments on this ACK.
+  //
+  mTcpTick      = Epoch + Tcb.CubicK;
+  Tcb.CWnd      = 70 * TEST_MSS;
+  Tcb.CubicWEst = 70 * TEST_MSS;
+  TcpCubicCongestionAvoid (&Tcb);
+  UT_ASSERT_EQUAL (Tcb.CWnd, 70 * TEST_MSS + 30 * TEST_MSS / 70);
+
+  //
+  // Past K the window grows beyond W_max, but not over 1.5 times the
+  // window in one round trip.
+  //
+  mTcpTick      = Epoch + 4 * Tcb.CubicK;
+  Tcb.CWnd      = 100 * TEST_MSS;
+  Tcb.CubicWEst = 100 * TEST_MSS;
+  TcpCubicCongestionAvoid (&Tcb);
+  UT_ASSERT_EQUAL (Tcb.CWnd, 100 * TEST_MSS + TEST_MSS / 2);
+
+  mTcpTick = Epoch;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  In the TCP friendly region, W_est should grow 3 * (1 - BETA) / (1 + BETA)
+  = 0.53 segments per round trip, and the window should follow it.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CubicShouldFollowWEst (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TCP_CB  Tcb;
+  UINT32  Start;
+  UINT32  Ack;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndMss = TEST_MSS;
+  Tcb.CWnd   = 100 * TEST_MSS;
+
+  Tcb.CWnd = TcpCubicOnLoss (&Tcb);
+  Start    = Tcb.CWnd;
+
+  //
+  // A window of ACKs at the start of the epoch, where the cubic function
+  // is flat.
+  //
+  for (Ack = 0; Ack < Start / TEST_MSS; Ack++) {
+    TcpCubicCongestionAvoid (&Tcb);
+  }
+
+  UT_ASSERT_EQUAL (Tcb.CWnd, Tcb.CubicWEst);
+  UT_ASSERT_TRUE (Tcb.CubicWEst - Start >= TEST_MSS / 2);
+  UT_ASSERT_TRUE (Tcb.CubicWEst - Start <= TEST_MSS * 55 / 100);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  TcpInitTcbPeer () should start with the RFC6928 initial window, or with
+  one segment if the SYN was retransmitted.
+
+  @param[in]  Context  The INIT_CWND_CONTEXT of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InitTcbPeerShouldUseInitialWindow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  INIT_CWND_CONTEXT  *Test;
+  SOCKET             Sock;
+  TCP_PROTO_DATA     *TcpProto;
+  TCP_SERVICE_DATA   TcpService;
+  IP_IO              IpIo;
+  EFI_IP4_PROTOCOL   Ip4;
+  TCP_CB             Tcb;
+  TCP_SEG            Seg;
+  TCP_OPTION         Option;
+
+  Test              = (INIT_CWND_CONTEXT *)Context;
+  mIp4MaxPacketSize = Test->MaxPacketSize;
+
+  ZeroMem (&Ip4, sizeof (Ip4));
+  ZeroMem (&IpIo, sizeof (IpIo));
+  ZeroMem (&TcpService, sizeof (TcpService));
+  ZeroMem (&Sock, sizeof (Sock));
+  Ip4.GetModeData      = TestIp4GetModeData;
+  IpIo.Ip.Ip4          = &Ip4;
+  TcpService.IpIo      = &IpIo;
+  Sock.IpVersion       = IP_VERSION_4;
+  TcpProto             = (TCP_PROTO_DATA *)Sock.ProtoReserved;
+  TcpProto->TcpService = &TcpService;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.Sk        = &Sock;
+  Tcb.SndMss    = 536;
+  Tcb.LossTimes = Test->LossTimes;
+
+  ZeroMem (&Seg, sizeof (Seg));
+  Seg.Seq  = 5000;
+  Seg.Ack  = 1;
+  Seg.Flag = TCP_FLG_SYN | TCP_FLG_ACK;
+
+  ZeroMem (&Option, sizeof (Option));
+  Option.Flag = TCP_OPTION_RCVD_MSS;
+  Option.Mss  = Test->PeerMss;
+
+  TcpInitTcbPeer (&Tcb, &Seg, &Option);
+  UT_ASSERT_EQUAL (Tcb.SndMss, Test->PeerMss);
+  UT_ASSERT_EQUAL (Tcb.CWnd, Test->CWnd);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  TcpDxe SACK, CUBIC and initial window code and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SackTests;
+  UNIT_TEST_SUITE_HANDLE      CongestionTests;
+
+  Framework = NULL;
+
+  DEBUG(( DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION ));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+      goto EXIT;
+  }
+
+  //
+  // Populate the SACK Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&SackTests, Framework, "TcpDxe SACK Tests", "TcpDxe.Sack", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SackTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (SackTests, "Reported blocks should be merged into the scoreboard", "Merge", SackUpdateShouldMergeBlocks, NULL, NULL, NULL);
+  AddTestCase (SackTests, "Acknowledged blocks should leave the scoreboard", "Ack", SackUpdateShouldDropAckedBlocks, NULL, NULL, NULL);
+  AddTestCase (SackTests, "Invalid blocks should be ignored", "Invalid", SackUpdateShouldIgnoreInvalidBlocks, NULL, NULL, NULL);
+  AddTestCase (SackTests, "A full scoreboard should keep the lowest blocks", "Full", SackUpdateShouldKeepLowestBlocks, NULL, NULL, NULL);
+  AddTestCase (SackTests, "The block of the latest segment should be reported first", "RcvBlocks", RcvSackBlocksShouldReportLatestFirst, NULL, NULL, NULL);
+
+  //
+  // Populate the congestion control Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&CongestionTests, Framework, "TcpDxe Congestion Control Tests", "TcpDxe.Congestion", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CongestionTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (CongestionTests, "The integer cube root should be exact", "CubicRoot", CubicRootShouldBeExact, NULL, NULL, NULL);
+  AddTestCase (CongestionTests, "CUBIC should reach W_max after K ticks", "CubicK", CubicShouldReachWMaxAfterK, NULL, NULL, NULL);
+  AddTestCase (CongestionTests, "CUBIC should follow W_est in the TCP friendly region", "CubicWEst", CubicShouldFollowWEst, NULL, NULL, NULL);
+  AddTestCase (CongestionTests, "The initial window should be 10 segments", "InitCwnd", InitTcbPeerShouldUseInitialWindow, NULL, NULL, &mEthernetCwnd);
+  AddTestCase (CongestionTests, "The initial window should be 10 small segments", "InitCwndSmallMss", InitTcbPeerShouldUseInitialWindow, NULL, NULL, &mSmallMssCwnd);
+  AddTestCase (CongestionTests, "The initial window should be 2 jumbo segments", "InitCwndJumbo", InitTcbPeerShouldUseInitialWindow, NULL, NULL, &mJumboCwnd);
+  AddTestCase (CongestionTests, "The initial window should be 1 segment if the SYN was lost", "InitCwndSynLost", InitTcbPeerShouldUseInitialWindow, NULL, NULL, &mSynLostCwnd);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -6,9 +6,11 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - The non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL keep multiple
+    requests in flight on the single virtio-blk requestq, each owning three
+    consecutive descriptors; their tokens are signaled from a timer that polls
+    the used ring. Synchronous requests share the same ring and are polled
+    for by the caller.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -28,6 +30,11 @@
 
 #include "VirtioBlk.h"
 
+//
+// Period of the timer completing asynchronous requests.
+//
+#define VBLK_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
 /**
 
   Convenience macros to read and write region 0 IO space elements of the
@@ -178,93 +185,220 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
+  Complete the requests that the host has processed since the last call.
 
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
-  - VerifyReadWriteRequest() (for read/write only).
+  For every used element of the ring, the data buffer of the request is
+  unmapped and the result is derived from the host status. Asynchronous
+  requests have their token signaled and their slot released; synchronous
+  requests are only marked done, their slot is released by the waiter.
 
-  Parameters handled commonly:
+  The caller is responsible for raising the TPL to TPL_NOTIFY.
 
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
+  @param[in out] Dev  The virtio-blk device whose requests are reaped.
 
-  Flush request:
+**/
 
-    @param[in] Lba             Must be zero.
+STATIC
+VOID
+VirtioBlkReapRequests (
+  IN OUT VBLK_DEV *Dev
+  )
+{
+  volatile CONST VRING_USED_ELEM *UsedElem;
+  VBLK_REQ_SLOT                  *Slot;
+  UINT16                         SlotIndex;
+  EFI_STATUS                     Status;
+  EFI_STATUS                     UnmapStatus;
+
+  MemoryFence ();
+  while (Dev->LastUsedIdx != *Dev->Ring.Used.Idx) {
+    MemoryFence ();
+    UsedElem  = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx % Dev->Ring.QueueSize];
+    SlotIndex = (UINT16) (UsedElem->Id / VBLK_DESC_PER_REQUEST);
+    Dev->LastUsedIdx++;
+
+    ASSERT (SlotIndex < Dev->SlotCount);
+    Slot = &Dev->Slots[SlotIndex];
+    ASSERT (Slot->InUse);
+
+    if (Slot->Abandoned) {
+      //
+      // The submitter already gave up on the request and stopped counting it
+      // as in flight; only the slot remains to be released.
+      //
+      Slot->InUse = FALSE;
+      continue;
+    }
 
-    @param[in] BufferSize      Must be zero.
+    if (Dev->SharedReqs[SlotIndex].HostStatus == VIRTIO_BLK_S_OK) {
+      Status = EFI_SUCCESS;
+    } else {
+      Status = EFI_DEVICE_ERROR;
+    }
 
-    @param[in out] Buffer      Ignored by the function.
+    if (Slot->BufferSize > 0) {
+      UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (
+                                   Dev->VirtIo,
+                                   Slot->BufferMapping
+                                   );
+      if (EFI_ERROR (UnmapStatus) && !Slot->RequestIsWrite) {
+        //
+        // Data from the bus master may not reach the caller; fail the request.
+        //
+        Status = EFI_DEVICE_ERROR;
+      }
+    }
 
-    @param[in] RequestIsWrite  Must be TRUE.
+    Dev->InFlight--;
+    if (Slot->Token != NULL) {
+      Dev->AsyncInFlight--;
+      Slot->Token->TransactionStatus = Status;
+      gBS->SignalEvent (Slot->Token->Event);
+      Slot->InUse = FALSE;
+    } else {
+      Slot->Status = Status;
+      Slot->Done   = TRUE;
+    }
+  }
 
-  Read/Write request:
+  if (Dev->AsyncInFlight == 0) {
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+  }
+}
 
-    @param[in] Lba             Logical Block Address: number of logical blocks
-                               to skip from the beginning of the device.
 
-    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
-                               is responsible to ensure this parameter is
-                               positive.
+/**
 
-    @param[in out] Buffer      The guest side area to read data from the device
-                               into, or write data to the device from.
+  Timer notification function that completes asynchronous requests.
 
-    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
-                               device.
+  @param[in] Event    Event whose notification function is being invoked.
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
+  @param[in] Context  Pointer to the VBLK_DEV structure.
 
+**/
 
-  @retval EFI_SUCCESS          Transfer complete.
+STATIC
+VOID
+EFIAPI
+VirtioBlkPollRequests (
+  IN  EFI_EVENT Event,
+  IN  VOID      *Context
+  )
+{
+  VirtioBlkReapRequests (Context);
+}
 
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+
+/**
+
+  Wait until every in-flight request of the device has been completed by the
+  host.
+
+  The TPL is raised to TPL_NOTIFY only while requests are completed; the
+  function waits at the caller's TPL.
+
+  @param[in out] Dev  The virtio-blk device to drain.
+
+**/
+
+STATIC
+VOID
+VirtioBlkDrainRequests (
+  IN OUT VBLK_DEV *Dev
+  )
+{
+  EFI_TPL OldTpl;
+  UINTN   PollPeriodUsecs;
+  UINTN   InFlight;
+
+  PollPeriodUsecs = 1;
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkReapRequests (Dev);
+    InFlight = Dev->InFlight;
+    gBS->RestoreTPL (OldTpl);
+
+    if (InFlight == 0) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+}
+
+
+/**
+
+  Format a read / write / flush request as three consecutive virtio
+  descriptors owned by a free request slot, and push them to the host
+  without waiting for the response.
+
+  If every request slot is in flight, the function completes the requests
+  the host has processed, and fails if that releases no slot.
+
+  The function may only be called after the request parameters have been
+  verified by
+  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks() and their
+    Block I/O 2 counterparts, and
+  - VerifyReadWriteRequest() (for read/write only).
+
+  The caller is responsible for raising the TPL to TPL_NOTIFY.
+
+  @param[in] Dev             The virtio-blk device the request is targeted at.
+
+  @param[in] Lba             Logical Block Address; zero for flush.
+
+  @param[in] BufferSize      Size of buffer to transfer, in bytes; zero for
+                             flush.
+
+  @param[in out] Buffer      The guest side area to read data from the device
+                             into, or write data to the device from.
+
+  @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to device,
+                             or for flush.
+
+  @param[in] Token           The token to signal on completion, or NULL for a
+                             synchronous request.
+
+  @param[out] SlotIndex      The request slot used by the request.
+
+
+  @retval EFI_SUCCESS       The request is in flight.
+
+  @retval EFI_NOT_READY     Every request slot is in flight.
+
+  @retval EFI_DEVICE_ERROR  Failed to map Buffer for a bus master operation, or
+                            failed to notify host side via VirtIo write.
 
 **/
 
 STATIC
 EFI_STATUS
-EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV *Dev,
-  IN              EFI_LBA  Lba,
-  IN              UINTN    BufferSize,
-  IN OUT volatile VOID     *Buffer,
-  IN              BOOLEAN  RequestIsWrite
+VirtioBlkSubmitRequest (
+  IN              VBLK_DEV            *Dev,
+  IN              EFI_LBA             Lba,
+  IN              UINTN               BufferSize,
+  IN OUT volatile VOID                *Buffer,
+  IN              BOOLEAN             RequestIsWrite,
+  IN              EFI_BLOCK_IO2_TOKEN *Token,         OPTIONAL
+  OUT             UINT16              *SlotIndex
   )
 {
   UINT32                  BlockSize;
-  volatile VIRTIO_BLK_REQ Request;
-  volatile UINT8          *HostStatus;
-  VOID                    *HostStatusBuffer;
-  DESC_INDICES            Indices;
-  VOID                    *RequestMapping;
-  VOID                    *StatusMapping;
-  VOID                    *BufferMapping;
+  VBLK_REQ_SLOT           *Slot;
+  volatile VBLK_SHARED_REQ *SharedReq;
+  EFI_PHYSICAL_ADDRESS    SharedReqAddress;
   EFI_PHYSICAL_ADDRESS    BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS    HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS    RequestDeviceAddress;
+  DESC_INDICES            Indices;
+  UINT16                  Index;
+  UINT16                  NextAvailIdx;
   EFI_STATUS              Status;
-  EFI_STATUS              UnmapStatus;
 
   BlockSize = Dev->BlockIoMedia.BlockSize;
 
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
-
   //
   // ensured by VirtioBlkInit()
   //
@@ -277,51 +411,51 @@ SynchronousRequest (
   ASSERT (BufferSize % BlockSize == 0);
 
   //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request.Type   = RequestIsWrite ?
-                   (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                   VIRTIO_BLK_T_IN;
-  Request.IoPrio = 0;
-  Request.Sector = MultU64x32(Lba, BlockSize / 512);
-
+  // Find a free request slot, completing the processed requests if there is
+  // none.
   //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
+  for (Index = 0; Index < Dev->SlotCount; Index++) {
+    *SlotIndex = (UINT16) ((Dev->NextSlot + Index) % Dev->SlotCount);
+    if (!Dev->Slots[*SlotIndex].InUse) {
+      break;
+    }
   }
+  if (Index == Dev->SlotCount) {
+    VirtioBlkReapRequests (Dev);
+    for (Index = 0; Index < Dev->SlotCount; Index++) {
+      *SlotIndex = (UINT16) ((Dev->NextSlot + Index) % Dev->SlotCount);
+      if (!Dev->Slots[*SlotIndex].InUse) {
+        break;
+      }
+    }
+    if (Index == Dev->SlotCount) {
+      return EFI_NOT_READY;
+    }
+  }
+  Dev->NextSlot = (UINT16) ((*SlotIndex + 1) % Dev->SlotCount);
 
-  HostStatus = HostStatusBuffer;
+  Slot             = &Dev->Slots[*SlotIndex];
+  SharedReq        = &Dev->SharedReqs[*SlotIndex];
+  SharedReqAddress = Dev->SharedReqsAddress +
+                     *SlotIndex * sizeof (VBLK_SHARED_REQ);
 
   //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
+  // Prepare virtio-blk request header, setting zero size for flush.
+  // IO Priority is homogeneously 0. Preset a host status for ourselves that
+  // we do not accept as success.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *) &Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
-  }
+  SharedReq->Request.Type   = RequestIsWrite ?
+                              (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
+                              VIRTIO_BLK_T_IN;
+  SharedReq->Request.IoPrio = 0;
+  SharedReq->Request.Sector = MultU64x32(Lba, BlockSize / 512);
+  SharedReq->HostStatus     = VIRTIO_BLK_S_IOERR;
 
   //
   // Map data buffer
   //
+  BufferDeviceAddress = 0;
+  Slot->BufferMapping = NULL;
   if (BufferSize > 0) {
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
@@ -331,51 +465,30 @@ SynchronousRequest (
                (VOID *) Buffer,
                BufferSize,
                &BufferDeviceAddress,
-               &BufferMapping
+               &Slot->BufferMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
+      return EFI_DEVICE_ERROR;
     }
   }
 
-  //
-  // preset a host status for ourselves that we do not accept as success
-  //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
+  Slot->InUse          = TRUE;
+  Slot->Done           = FALSE;
+  Slot->Abandoned      = FALSE;
+  Slot->RequestIsWrite = RequestIsWrite;
+  Slot->Token          = Token;
+  Slot->BufferSize     = BufferSize;
 
-  //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
-  }
-
-  VirtioPrepare (&Dev->Ring, &Indices);
-
-  //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
-  //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  Indices.HeadDescIdx = (UINT16) (*SlotIndex * VBLK_DESC_PER_REQUEST);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
 
   //
   // virtio-blk header in first desc
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
+    SharedReqAddress + OFFSET_OF (VBLK_SHARED_REQ, Request),
+    sizeof (VIRTIO_BLK_REQ),
     VRING_DESC_F_NEXT,
     &Indices
     );
@@ -411,47 +524,246 @@ SynchronousRequest (
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
+    SharedReqAddress + OFFSET_OF (VBLK_SHARED_REQ, HostStatus),
+    sizeof (UINT8),
     VRING_DESC_F_WRITE,
     &Indices
     );
 
+  Dev->InFlight++;
+  if (Token != NULL) {
+    Dev->AsyncInFlight++;
+    if (Dev->AsyncInFlight == 1) {
+      gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD);
+    }
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field. The number of request slots is below the queue size, so
+  // the available ring can never overflow.
+  //
+  NextAvailIdx = *Dev->Ring.Avail.Idx;
+  Dev->Ring.Avail.Ring[NextAvailIdx++ % Dev->Ring.QueueSize] =
+    Indices.HeadDescIdx;
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = NextAvailIdx;
+
   //
-  // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device -- gratuitous notifications are
+  // OK. virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
   //
-  if (VirtioFlush (Dev->VirtIo, 0, &Dev->Ring, &Indices,
-        NULL) == EFI_SUCCESS &&
-      *HostStatus == VIRTIO_BLK_S_OK) {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+  if (EFI_ERROR (Status)) {
+    //
+    // The request is no longer counted as in flight, so draining the device
+    // does not wait for it. Its descriptors are already visible to the host,
+    // so the slot is only released by the reaper, should the host ever
+    // complete the request.
+    //
+    if (BufferSize > 0) {
+      Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Slot->BufferMapping);
+      Slot->BufferSize = 0;
+    }
+    Slot->Abandoned = TRUE;
+    Slot->Token     = NULL;
+    Dev->InFlight--;
+    if (Token != NULL) {
+      Dev->AsyncInFlight--;
+    }
+    return EFI_DEVICE_ERROR;
   }
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+  return EFI_SUCCESS;
+}
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
+
+/**
+
+  Submit a request with VirtioBlkSubmitRequest(), waiting for a request slot
+  to become free if every slot is in flight.
+
+  The TPL is raised to TPL_NOTIFY only while the request is submitted; the
+  function waits for a free slot at the caller's TPL.
+
+  @param[in] Dev             The virtio-blk device the request is targeted at.
+
+  @param[in] Lba             Logical Block Address; zero for flush.
+
+  @param[in] BufferSize      Size of buffer to transfer, in bytes; zero for
+                             flush.
+
+  @param[in out] Buffer      The guest side area to read data from the device
+                             into, or write data to the device from.
+
+  @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to device,
+                             or for flush.
+
+  @param[in] Token           The token to signal on completion, or NULL for a
+                             synchronous request.
+
+  @param[out] SlotIndex      The request slot used by the request.
+
+
+  @retval EFI_SUCCESS       The request is in flight.
+
+  @return                   Error codes from VirtioBlkSubmitRequest(), other
+                            than EFI_NOT_READY.
+
+**/
+
+STATIC
+EFI_STATUS
+VirtioBlkQueueRequest (
+  IN              VBLK_DEV            *Dev,
+  IN              EFI_LBA             Lba,
+  IN              UINTN               BufferSize,
+  IN OUT volatile VOID                *Buffer,
+  IN              BOOLEAN             RequestIsWrite,
+  IN              EFI_BLOCK_IO2_TOKEN *Token,         OPTIONAL
+  OUT             UINT16              *SlotIndex
+  )
+{
+  EFI_TPL    OldTpl;
+  EFI_STATUS Status;
+  UINTN      PollPeriodUsecs;
+
+  PollPeriodUsecs = 1;
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Status = VirtioBlkSubmitRequest (
+               Dev,
+               Lba,
+               BufferSize,
+               Buffer,
+               RequestIsWrite,
+               Token,
+               SlotIndex
+               );
+    gBS->RestoreTPL (OldTpl);
+
+    if (Status != EFI_NOT_READY) {
+      return Status;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
     }
   }
+}
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+/**
 
-  return Status;
+  Submit a read / write / flush request and poll for the response.
+
+  The function may only be called after the request parameters have been
+  verified by
+  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
+  - VerifyReadWriteRequest() (for read/write only).
+
+  Parameters handled commonly:
+
+    @param[in] Dev             The virtio-blk device the request is targeted
+                               at.
+
+  Flush request:
+
+    @param[in] Lba             Must be zero.
+
+    @param[in] BufferSize      Must be zero.
+
+    @param[in out] Buffer      Ignored by the function.
+
+    @param[in] RequestIsWrite  Must be TRUE.
+
+  Read/Write request:
+
+    @param[in] Lba             Logical Block Address: number of logical blocks
+                               to skip from the beginning of the device.
+
+    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
+                               is responsible to ensure this parameter is
+                               positive.
+
+    @param[in out] Buffer      The guest side area to read data from the device
+                               into, or write data to the device from.
+
+    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
+                               device.
+
+  Return values are common to both use cases, and are appropriate to be
+  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
+  WriteBlocks(), FlushBlocks()).
+
+
+  @retval EFI_SUCCESS          Transfer complete.
+
+  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
+                               unable to parse host response, or host response
+                               is not VIRTIO_BLK_S_OK or failed to map Buffer
+                               for a bus master operation.
+
+**/
+
+STATIC
+EFI_STATUS
+EFIAPI
+SynchronousRequest (
+  IN              VBLK_DEV *Dev,
+  IN              EFI_LBA  Lba,
+  IN              UINTN    BufferSize,
+  IN OUT volatile VOID     *Buffer,
+  IN              BOOLEAN  RequestIsWrite
+  )
+{
+  EFI_TPL    OldTpl;
+  EFI_STATUS Status;
+  UINT16     SlotIndex;
+  UINTN      PollPeriodUsecs;
+  BOOLEAN    Done;
+
+  Status = VirtioBlkQueueRequest (
+             Dev,
+             Lba,
+             BufferSize,
+             Buffer,
+             RequestIsWrite,
+             NULL,
+             &SlotIndex
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  // Requests queued by ReadBlocksEx() / WriteBlocksEx() are completed on
+  // the way. The TPL is only raised while the ring is checked.
+  //
+  PollPeriodUsecs = 1;
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkReapRequests (Dev);
+    Done = Dev->Slots[SlotIndex].Done;
+    if (Done) {
+      Status = Dev->Slots[SlotIndex].Status;
+      Dev->Slots[SlotIndex].InUse = FALSE;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    if (Done) {
+      return Status;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
 }
 
 
@@ -604,6 +916,242 @@ VirtioBlkFlushBlocks (
 }
 
 
+/**
+
+  Complete an EFI_BLOCK_IO2_TOKEN without queuing a request.
+
+  @param[in out] Token  The token to complete successfully.
+
+**/
+
+STATIC
+VOID
+VirtioBlkCompleteToken (
+  IN OUT EFI_BLOCK_IO2_TOKEN *Token
+  )
+{
+  Token->TransactionStatus = EFI_SUCCESS;
+  gBS->SignalEvent (Token->Event);
+}
+
+
+/**
+
+  Queue a read / write / flush request with a token.
+
+  @retval EFI_SUCCESS       The request is in flight.
+
+  @return                   Error codes from VirtioBlkQueueRequest().
+
+**/
+
+STATIC
+EFI_STATUS
+AsynchronousRequest (
+  IN              VBLK_DEV            *Dev,
+  IN              EFI_LBA             Lba,
+  IN              UINTN               BufferSize,
+  IN OUT volatile VOID                *Buffer,
+  IN              BOOLEAN             RequestIsWrite,
+  IN              EFI_BLOCK_IO2_TOKEN *Token
+  )
+{
+  UINT16     SlotIndex;
+
+  return VirtioBlkQueueRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           RequestIsWrite,
+           Token,
+           &SlotIndex
+           );
+}
+
+
+//
+// UEFI Spec 2.8, 13.10 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL *This,
+  IN BOOLEAN                ExtendedVerification
+  )
+{
+  VBLK_DEV *Dev;
+
+  //
+  // The host does not support aborting requests; let the in-flight ones
+  // complete.
+  //
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  VirtioBlkDrainRequests (Dev);
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  The request is queued on the virtio ring next to any other in-flight
+  request, and Token->Event is signaled once the host has completed it. If
+  Token is NULL or Token->Event is NULL, the request is performed
+  synchronously, as with ReadBlocks().
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  OUT    VOID                   *Buffer
+  )
+{
+  VBLK_DEV   *Dev;
+  EFI_STATUS Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkReadBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize,
+             Buffer);
+  }
+
+  if (BufferSize == 0) {
+    VirtioBlkCompleteToken (Token);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             FALSE               // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return AsynchronousRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           FALSE,      // RequestIsWrite
+           Token
+           );
+}
+
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  The request is queued on the virtio ring next to any other in-flight
+  request, and Token->Event is signaled once the host has completed it. If
+  Token is NULL or Token->Event is NULL, the request is performed
+  synchronously, as with WriteBlocks().
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  IN     VOID                   *Buffer
+  )
+{
+  VBLK_DEV   *Dev;
+  EFI_STATUS Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkWriteBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize,
+             Buffer);
+  }
+
+  if (BufferSize == 0) {
+    VirtioBlkCompleteToken (Token);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             TRUE                // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return AsynchronousRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           TRUE,       // RequestIsWrite
+           Token
+           );
+}
+
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  Waits for the in-flight requests to complete, then queues a flush request
+  if the device supports write caching.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token
+  )
+{
+  VBLK_DEV   *Dev;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+
+  //
+  // The flush must cover the writes that are still in flight.
+  //
+  VirtioBlkDrainRequests (Dev);
+
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkFlushBlocks (&Dev->BlockIo);
+  }
+
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    VirtioBlkCompleteToken (Token);
+    return EFI_SUCCESS;
+  }
+
+  return AsynchronousRequest (
+           Dev,
+           0,          // Lba
+           0,          // BufferSize
+           NULL,       // Buffer
+           TRUE,       // RequestIsWrite
+           Token
+           );
+}
+
+
 /**
 
   Device probe function for this driver.
@@ -841,7 +1389,8 @@ VirtioBlkInit (
   if (EFI_ERROR (Status)) {
     goto Failed;
   }
-  if (QueueSize < 3) { // SynchronousRequest() uses at most three descriptors
+  if (QueueSize < VBLK_DESC_PER_REQUEST) { // every request uses at most three
+                                           // descriptors
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -864,18 +1413,64 @@ VirtioBlkInit (
     goto ReleaseQueue;
   }
 
+  //
+  // Allocate the request slots. The device side of every slot (request
+  // header and host status) lives in a single common buffer.
+  //
+  Dev->SlotCount = (UINT16) MIN (QueueSize / VBLK_DESC_PER_REQUEST,
+                                 VBLK_MAX_REQUESTS);
+  Dev->Slots = AllocateZeroPool (Dev->SlotCount * sizeof (VBLK_REQ_SLOT));
+  if (Dev->Slots == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto UnmapQueue;
+  }
+
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          EFI_SIZE_TO_PAGES (Dev->SlotCount *
+                                             sizeof (VBLK_SHARED_REQ)),
+                          (VOID **) &Dev->SharedReqs
+                          );
+  if (EFI_ERROR (Status)) {
+    goto FreeSlots;
+  }
+  ZeroMem (Dev->SharedReqs, Dev->SlotCount * sizeof (VBLK_SHARED_REQ));
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Dev->SharedReqs,
+             Dev->SlotCount * sizeof (VBLK_SHARED_REQ),
+             &Dev->SharedReqsAddress,
+             &Dev->SharedReqsMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeSharedReqs;
+  }
+
+  Dev->NextSlot      = 0;
+  Dev->LastUsedIdx   = 0;
+  Dev->InFlight      = 0;
+  Dev->AsyncInFlight = 0;
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device. We're going to
+  // poll the answers, the host should not send interrupts.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
+
   //
   // Additional steps for MMIO: align the queue appropriately, and set the
   // size. If anything fails from here on, we must unmap the ring resources.
   //
   Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapSharedReqs;
   }
 
   Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapSharedReqs;
   }
 
   //
@@ -887,7 +1482,7 @@ VirtioBlkInit (
                           RingBaseShift
                           );
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapSharedReqs;
   }
 
 
@@ -898,7 +1493,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto UnmapSharedReqs;
     }
   }
 
@@ -908,7 +1503,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapSharedReqs;
   }
 
   //
@@ -932,9 +1527,17 @@ VirtioBlkInit (
   Dev->BlockIoMedia.LastBlock        = DivU64x32 (NumSectors,
                                          BlockSize / 512) - 1;
 
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
+
   DEBUG ((DEBUG_INFO, "%a: LbaSize=0x%x[B] NumBlocks=0x%Lx[Lba]\n",
     __FUNCTION__, Dev->BlockIoMedia.BlockSize,
     Dev->BlockIoMedia.LastBlock + 1));
+  DEBUG ((DEBUG_INFO, "%a: QueueSize=%d MaxInFlight=%d\n", __FUNCTION__,
+    QueueSize, Dev->SlotCount));
 
   if (Features & VIRTIO_BLK_F_TOPOLOGY) {
     Dev->BlockIo.Revision = EFI_BLOCK_IO_PROTOCOL_REVISION3;
@@ -951,6 +1554,19 @@ VirtioBlkInit (
   }
   return EFI_SUCCESS;
 
+UnmapSharedReqs:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedReqsMap);
+
+FreeSharedReqs:
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Dev->SlotCount * sizeof (VBLK_SHARED_REQ)),
+                 Dev->SharedReqs
+                 );
+
+FreeSlots:
+  FreePool (Dev->Slots);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -992,10 +1608,19 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedReqsMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Dev->SlotCount * sizeof (VBLK_SHARED_REQ)),
+                 Dev->SharedReqs
+                 );
+  FreePool (Dev->Slots);
+
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
   SetMem (&Dev->BlockIo,      sizeof Dev->BlockIo,      0x00);
+  SetMem (&Dev->BlockIo2,     sizeof Dev->BlockIo2,     0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1084,12 +1709,18 @@ VirtioBlkDriverBindingStart (
     goto FreeVirtioBlk;
   }
 
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_NOTIFY,
+                  &VirtioBlkPollRequests, Dev, &Dev->PollTimer);
+  if (EFI_ERROR (Status)) {
+    goto CloseVirtIo;
+  }
+
   //
   // VirtIo access granted, configure virtio-blk device.
   //
   Status = VirtioBlkInit (Dev);
   if (EFI_ERROR (Status)) {
-    goto CloseVirtIo;
+    goto ClosePollTimer;
   }
 
   Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
@@ -1099,12 +1730,14 @@ VirtioBlkDriverBindingStart (
   }
 
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status = gBS->InstallProtocolInterface (&DeviceHandle,
-                  &gEfiBlockIoProtocolGuid, EFI_NATIVE_INTERFACE,
-                  &Dev->BlockIo);
+  Status = gBS->InstallMultipleProtocolInterfaces (&DeviceHandle,
+                  &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                  NULL);
   if (EFI_ERROR (Status)) {
     goto CloseExitBoot;
   }
@@ -1117,6 +1750,9 @@ CloseExitBoot:
 UninitDev:
   VirtioBlkUninit (Dev);
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseVirtIo:
   gBS->CloseProtocol (DeviceHandle, &gVirtioDeviceProtocolGuid,
          This->DriverBindingHandle, DeviceHandle);
@@ -1181,13 +1817,21 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (DeviceHandle,
-                  &gEfiBlockIoProtocolGuid, &Dev->BlockIo);
+  Status = gBS->UninstallMultipleProtocolInterfaces (DeviceHandle,
+                  &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                  NULL);
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Let the requests still in flight complete before resetting the device.
+  //
+  VirtioBlkDrainRequests (Dev);
+
   gBS->CloseEvent (Dev->ExitBoot);
+  gBS->CloseEvent (Dev->PollTimer);
 
   VirtioBlkUninit (Dev);
 
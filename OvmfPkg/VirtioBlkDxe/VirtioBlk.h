@@ -1,7 +1,7 @@
 /** @file
 
   Internal definitions for the virtio-blk driver, which produces Block I/O
-  Protocol instances for virtio-blk devices.
+  and Block I/O 2 Protocol instances for virtio-blk devices.
 
   Copyright (C) 2012, Red Hat, Inc.
 
@@ -13,14 +13,53 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 
 #define VBLK_SIG SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Every in-flight request owns three consecutive descriptors of the ring:
+// request header, data buffer (unused for flush) and host status.
+//
+#define VBLK_DESC_PER_REQUEST 3
+
+//
+// Upper limit on the number of requests kept in flight on the requestq.
+//
+#define VBLK_MAX_REQUESTS     256
+
+//
+// The part of an in-flight request that the device accesses, allocated from
+// a single common buffer for all request slots.
+//
+#pragma pack(1)
+typedef struct {
+  VIRTIO_BLK_REQ Request;
+  UINT8          HostStatus;
+  UINT8          Reserved[7];
+} VBLK_SHARED_REQ;
+#pragma pack()
+
+//
+// Driver side bookkeeping of a request slot.
+//
+typedef struct {
+  BOOLEAN             InUse;
+  BOOLEAN             Done;           // completed, synchronous requests only
+  BOOLEAN             Abandoned;      // nobody waits for the completion
+  BOOLEAN             RequestIsWrite;
+  EFI_BLOCK_IO2_TOKEN *Token;         // NULL for synchronous requests
+  UINTN               BufferSize;
+  VOID                *BufferMapping;
+  EFI_STATUS          Status;         // result, synchronous requests only
+} VBLK_REQ_SLOT;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -32,15 +71,29 @@ typedef struct {
   UINT32                 Signature;            // DriverBindingStart  0
   VIRTIO_DEVICE_PROTOCOL *VirtIo;              // DriverBindingStart  0
   EFI_EVENT              ExitBoot;             // DriverBindingStart  0
+  EFI_EVENT              PollTimer;            // DriverBindingStart  0
   VRING                  Ring;                 // VirtioRingInit      2
   EFI_BLOCK_IO_PROTOCOL  BlockIo;              // VirtioBlkInit       1
+  EFI_BLOCK_IO2_PROTOCOL BlockIo2;             // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA     BlockIoMedia;         // VirtioBlkInit       1
   VOID                   *RingMap;             // VirtioRingMap       2
+  UINT16                 SlotCount;            // VirtioBlkInit       1
+  VBLK_REQ_SLOT          *Slots;               // VirtioBlkInit       1
+  VBLK_SHARED_REQ        *SharedReqs;          // VirtioBlkInit       1
+  EFI_PHYSICAL_ADDRESS   SharedReqsAddress;    // VirtioBlkInit       1
+  VOID                   *SharedReqsMap;       // VirtioBlkInit       1
+  UINT16                 NextSlot;             // VirtioBlkInit       1
+  UINT16                 LastUsedIdx;          // VirtioBlkInit       1
+  UINTN                  InFlight;             // VirtioBlkInit       1
+  UINTN                  AsyncInFlight;        // VirtioBlkInit       1
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 
 /**
 
@@ -253,6 +306,80 @@ VirtioBlkFlushBlocks (
   );
 
 
+//
+// UEFI Spec 2.8, 13.10 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL *This,
+  IN BOOLEAN                ExtendedVerification
+  );
+
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  The request is queued on the virtio ring next to any other in-flight
+  request, and Token->Event is signaled once the host has completed it. If
+  Token is NULL or Token->Event is NULL, the request is performed
+  synchronously, as with ReadBlocks().
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  OUT    VOID                   *Buffer
+  );
+
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  The request is queued on the virtio ring next to any other in-flight
+  request, and Token->Event is signaled once the host has completed it. If
+  Token is NULL or Token->Event is NULL, the request is performed
+  synchronously, as with WriteBlocks().
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  IN     VOID                   *Buffer
+  );
+
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  Waits for the in-flight requests to complete, then queues a flush request
+  if the device supports write caching.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token
+  );
+
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
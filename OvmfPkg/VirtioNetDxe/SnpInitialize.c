@@ -344,6 +344,7 @@ VirtioNetInitRx (
   // by two is due to the above "two descriptors per packet" trait.
   //
   RxAlwaysPending = (UINT16) MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  Dev->RxMaxPending = RxAlwaysPending;
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -388,7 +389,9 @@ VirtioNetInitRx (
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device:
   // the host should not send interrupts, we'll poll in VirtioNetReceive()
-  // and VirtioNetIsPacketAvailable().
+  // and VirtioNetIsPacketAvailable(). With VIRTIO_F_RING_EVENT_IDX the flag is
+  // ignored, but the UsedEvent field stays zero, which asks for an interrupt
+  // only when the Used Index wraps around.
   //
   *Dev->RxRing.Avail.Flags = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
 
@@ -425,6 +428,7 @@ VirtioNetInitRx (
   //
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = RxAlwaysPending;
+  Dev->RxLastNotified    = RxAlwaysPending;
 
   //
   // At this point reception may already be running. In order to make it sure,
@@ -557,7 +561,8 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS));
 
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_F_RING_EVENT_IDX;
+  Dev->EventIdx = (BOOLEAN) ((Features & VIRTIO_F_RING_EVENT_IDX) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -103,7 +103,19 @@ VirtioNetReceive (
   MemoryFence ();
 
   if (Dev->RxLastUsed == RxCurUsed) {
-    Status = EFI_NOT_READY;
+    //
+    // The burst is over; hand the recycled descriptors to the device.
+    //
+    Status = VirtioNetNotifyQueue (
+               Dev,
+               VIRTIO_NET_Q_RX,
+               &Dev->RxRing,
+               Dev->RxLastNotified
+               );
+    Dev->RxLastNotified = *Dev->RxRing.Avail.Idx;
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_NOT_READY;
+    }
     goto Exit;
   }
 
@@ -173,10 +185,23 @@ RecycleDesc:
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = AvailIdx;
 
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) { // earlier error takes precedence
-    Status = NotifyStatus;
+  //
+  // The device takes recycled descriptors off the Available Ring without
+  // being notified, as long as it has not run out of them. Notify it only
+  // once half of the descriptors have been recycled, or when the Used Ring
+  // runs empty above.
+  //
+  if ((UINT16) (AvailIdx - Dev->RxLastNotified) >= Dev->RxMaxPending / 2) {
+    NotifyStatus = VirtioNetNotifyQueue (
+                     Dev,
+                     VIRTIO_NET_Q_RX,
+                     &Dev->RxRing,
+                     Dev->RxLastNotified
+                     );
+    Dev->RxLastNotified = AvailIdx;
+    if (!EFI_ERROR (Status)) { // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
@@ -8,7 +8,9 @@
 
 **/
 
+#include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
 
 #include "VirtioNet.h"
 
@@ -104,6 +106,73 @@ VirtioNetUninitRing (
 }
 
 
+/**
+  Notify the device of the descriptor chains placed on the Available Ring
+  since the last notification, unless the device asked not to be notified.
+
+  With VIRTIO_F_RING_EVENT_IDX, the device publishes the Available Index at
+  which it wants to be notified in the AvailEvent field of the Used Ring.
+  Otherwise it sets VRING_USED_F_NO_NOTIFY while it is processing the ring
+  anyway.
+
+  @param[in] Dev           The VNET_DEV driver instance.
+  @param[in] Selector      Identifies the virtio queue of Ring.
+  @param[in] Ring          The virtio ring inside the VNET_DEV structure.
+  @param[in] LastNotified  The Available Index at the time of the last
+                           notification.
+
+  @return                  Status codes from
+                           VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+  @retval EFI_SUCCESS      The device has been notified, or it needs no
+                           notification.
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetNotifyQueue (
+  IN VNET_DEV *Dev,
+  IN UINT16   Selector,
+  IN VRING    *Ring,
+  IN UINT16   LastNotified
+  )
+{
+  UINT16          AvailIdx;
+  UINT16          AvailEvent;
+  volatile UINT32 Fence;
+
+  AvailIdx = *Ring->Avail.Idx;
+  if (AvailIdx == LastNotified) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The update of the Available Index must be visible to the device before
+  // we read the suppression fields; otherwise we could miss the device
+  // re-enabling notifications. MemoryFence() only constrains the compiler
+  // on IA32 and X64, while a locked instruction also orders the store with
+  // the following loads.
+  //
+  Fence = 0;
+  InterlockedCompareExchange32 ((UINT32 *) &Fence, 0, 0);
+  MemoryFence ();
+
+  if (Dev->EventIdx) {
+    //
+    // virtio-1.0, 2.4.7.2 Notification Suppression: notify if AvailEvent
+    // lies in [LastNotified, AvailIdx).
+    //
+    AvailEvent = *Ring->Used.AvailEvent;
+    if ((UINT16) (AvailIdx - AvailEvent - 1) >=
+        (UINT16) (AvailIdx - LastNotified)) {
+      return EFI_SUCCESS;
+    }
+  } else if ((*Ring->Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, Selector);
+}
+
+
 /**
   Map Caller-supplied TxBuf buffer to the device-mapped address
 
@@ -164,13 +164,19 @@ VirtioNetTransmit (
   // without a barrier
   //
   AvailIdx = *Dev->TxRing.Avail.Idx;
-  Dev->TxRing.Avail.Ring[AvailIdx++ % Dev->TxRing.QueueSize] = DescIdx;
+  Dev->TxRing.Avail.Ring[AvailIdx % Dev->TxRing.QueueSize] = DescIdx;
 
   MemoryFence ();
-  *Dev->TxRing.Avail.Idx = AvailIdx;
+  *Dev->TxRing.Avail.Idx = (UINT16) (AvailIdx + 1);
 
-  MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  //
+  // The packet is not held back to batch it with later ones: SNP has no call
+  // that would flush such a batch, so a lone packet could wait for the next
+  // poll. The notification is only skipped if the device suppressed it,
+  // which it does while it is still transmitting earlier packets; it then
+  // picks this one up as well.
+  //
+  Status = VirtioNetNotifyQueue (Dev, VIRTIO_NET_Q_TX, &Dev->TxRing, AvailIdx);
 
 Exit:
   gBS->RestoreTPL (OldTpl);
@@ -25,9 +25,11 @@
 #define VNET_SIG SIGNATURE_32 ('V', 'N', 'E', 'T')
 
 //
-// maximum number of pending packets, separately for each direction
+// maximum number of pending packets, separately for each direction; this
+// fills the 256 entry queues that QEMU creates by default, at two descriptors
+// per packet
 //
-#define VNET_MAX_PENDING 64
+#define VNET_MAX_PENDING 128
 
 //
 // State diagram:
@@ -76,12 +78,15 @@ typedef struct {
   EFI_EVENT                   ExitBoot;          // VirtioNetSnpPopulate
   EFI_DEVICE_PATH_PROTOCOL    *MacDevicePath;    // VirtioNetDriverBindingStart
   EFI_HANDLE                  MacHandle;         // VirtioNetDriverBindingStart
+  BOOLEAN                     EventIdx;          // VirtioNetInitialize
 
   VRING                       RxRing;            // VirtioNetInitRing
   VOID                        *RxRingMap;        // VirtioRingMap and
                                                  // VirtioNetInitRing
   UINT8                       *RxBuf;            // VirtioNetInitRx
   UINT16                      RxLastUsed;        // VirtioNetInitRx
+  UINT16                      RxMaxPending;      // VirtioNetInitRx
+  UINT16                      RxLastNotified;    // VirtioNetInitRx
   UINTN                       RxBufNrPages;      // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS        RxBufDeviceBase;   // VirtioNetInitRx
   VOID                        *RxBufMap;         // VirtioNetInitRx
@@ -276,6 +281,15 @@ VirtioNetUninitRing (
   IN     VOID     *RingMap
   );
 
+EFI_STATUS
+EFIAPI
+VirtioNetNotifyQueue (
+  IN VNET_DEV *Dev,
+  IN UINT16   Selector,
+  IN VRING    *Ring,
+  IN UINT16   LastNotified
+  );
+
 //
 // utility functions to map caller-supplied Tx buffer system physical address
 // to a device address and vice versa
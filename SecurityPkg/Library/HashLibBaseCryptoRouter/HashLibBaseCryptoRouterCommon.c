@@ -12,9 +12,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/Tpm2CommandLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID  Guid;
   UINT32    Mask;
@@ -70,3 +73,63 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count ++;
 }
+
+/**
+  Update the hash sequence of every hash engine allowed by PcdTpm2HashMask
+  with the same data.
+
+  The data is fed to the hash engines in HASH_UPDATE_CHUNK_SIZE pieces. Each
+  piece is read from memory once by the first hash engine and is then still
+  in the processor cache for the others, instead of the whole buffer being
+  read from memory once per PCR bank.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateAllBanks (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  UINTN   ActiveIndex[HASH_COUNT];
+  UINTN   ActiveCount;
+  UINTN   Index;
+  UINT32  HashMask;
+  UINT8   *Data;
+  UINTN   ChunkSize;
+
+  ActiveCount = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    HashMask = Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid);
+    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
+      ActiveIndex[ActiveCount] = Index;
+      ActiveCount++;
+    }
+  }
+
+  //
+  // With a single hash engine there is nothing to share the cache with.
+  //
+  if (ActiveCount == 1) {
+    HashInterface[ActiveIndex[0]].HashUpdate (HashCtx[ActiveIndex[0]], DataToHash, DataToHashLen);
+    return;
+  }
+
+  Data = (UINT8 *)DataToHash;
+  do {
+    ChunkSize = MIN (DataToHashLen, HASH_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < ActiveCount; Index++) {
+      HashInterface[ActiveIndex[Index]].HashUpdate (HashCtx[ActiveIndex[Index]], Data, ChunkSize);
+    }
+    Data          += ChunkSize;
+    DataToHashLen -= ChunkSize;
+  } while (DataToHashLen != 0);
+}
@@ -9,6 +9,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Amount of data given to each hash engine in turn by Tpm2HashUpdateAllBanks().
+// It is small enough to stay in the L1 data cache of current processors, and
+// a multiple of the block size of every supported hash algorithm.
+//
+#define HASH_UPDATE_CHUNK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +42,29 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES     *Digest
   );
 
+/**
+  Update the hash sequence of every hash engine allowed by PcdTpm2HashMask
+  with the same data.
+
+  The data is fed to the hash engines in HASH_UPDATE_CHUNK_SIZE pieces. Each
+  piece is read from memory once by the first hash engine and is then still
+  in the processor cache for the others, instead of the whole buffer being
+  read from memory once per PCR bank.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateAllBanks (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif